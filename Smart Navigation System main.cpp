@@ -9,33 +9,93 @@
 #include <algorithm>
 #include <cmath>
 #include <tuple> // Required for std::tuple
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <chrono>
+#include <sstream>
+#include <unordered_map>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <cstring>
+#include <map>
+#include <set>
+#include <deque>
+
+#include "navigation_api.h"
 
 using namespace std;
 
-// Color codes using ANSI escape sequences (basic and standard)
-#define RESET   "\033[0m"       // Reset to default color
-#define RED     "\033[31m"      // Red for errors
-#define GREEN   "\033[32m"      // Green for success messages
-
-
-#define YELLOW  "\033[33m"      // Yellow for warnings and important data
-#define BLUE    "\033[34m"      // Blue for information
-#define CYAN    "\033[36m"      // Cyan for headings and titles
-#define WHITE   "\033[37m"      // White for regular text
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <io.h>
+#define isatty _isatty
+#define fileno _fileno
+#include <fcntl.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <cerrno>
+#endif
+
+// Everything except the API in navigation_api.h and main() lives in this
+// namespace, so a program that embeds the engine sees only the nav* calls.
+namespace nav_engine {
+
+// Color codes using ANSI escape sequences (basic and standard).
+// They expand to "" when colour is switched off (e.g. output piped to a file).
+#define RESET   (colorEnabled ? "\033[0m" : "")       // Reset to default color
+#define RED     (colorEnabled ? "\033[31m" : "")      // Red for errors
+#define GREEN   (colorEnabled ? "\033[32m" : "")      // Green for success messages
+
+
+#define YELLOW  (colorEnabled ? "\033[33m" : "")      // Yellow for warnings and important data
+#define BLUE    (colorEnabled ? "\033[34m" : "")      // Blue for information
+#define CYAN    (colorEnabled ? "\033[36m" : "")      // Cyan for headings and titles
+#define WHITE   (colorEnabled ? "\033[37m" : "")      // White for regular text
 
 // ============================================
 // CONSTANTS
 // ============================================
-const int MAX_LOCATIONS = 50;
-const int MAX_ROADS = 100;
+const int MAX_LOCATIONS = 20000;
+const int MAX_ROADS = 100000;
+const int INF_DISTANCE = INT_MAX;
+const size_t OUTPUT_FLUSH_BYTES = 64 * 1024;   // listings are written in chunks of this size
+
+// Alternative route quality limits (fractions of the optimal weighted distance)
+const int MAX_ALTERNATIVE_ROUTES = 2;
+const double ALT_MAX_STRETCH = 0.25;   // alternative may be at most 25% longer
+const double ALT_MAX_SHARING = 0.60;   // may share at most 60% with better routes
+const double ALT_MIN_PLATEAU = 0.20;   // locally optimal for at least 20% of the route
+
+// Multi-criteria routing
+const int DEFAULT_SPEED_LIMIT = 40;       // km/h, matches the single-criterion time estimate
+const int MAX_PARETO_LABELS = 8;          // labels kept per location (bounds the search)
 
 // ============================================
 // STRUCTURES
 // ============================================
 
+struct NameRef {
+    unsigned int offset;    // into nameArena
+    unsigned int length;
+};
+
 struct Location {
     int id;
-    string name;
+    NameRef name;
+    double latitude;
+    double longitude;
 };
 
 struct Road {
@@ -45,16 +105,26 @@ struct Road {
     string status;
     bool isOneWay;      // true if road is one-way, false if bidirectional
     bool isAvailable;   // false if road is under construction or unavailable
+    int speedLimit;     // free-flow speed in km/h
+    double toll;        // toll charged for using the road ($)
 };
 
 struct Node {
-    string path;
+    vector<NameRef> hops;   // location names along the route
+    string note;            // shown after the route, e.g. " (Distance: 12 km)"
     Node* next;
 };
 
 struct GraphNode {
     int destination;
     int distance;
+    int roadIndex;      // road in roads[] this edge was built from
+};
+
+struct AlternativeRoute {
+    vector<int> path;       // location indices from start to end
+    int distance;
+    int sharedDistance;     // weighted km shared with the shortest route
 };
 
 // ============================================
@@ -69,6 +139,171 @@ int roadCount = 0;
 
 Node* routeHistoryHead = nullptr;
 
+// Location names are stored once in an append-only arena and referred to by
+// (offset, length), which stays valid as the arena grows. Names are never
+// released, so history entries still render after a location is deleted.
+string nameArena;
+unordered_map<size_t, vector<NameRef>> internedNames;     // by hash of the name
+
+// Display settings
+bool colorEnabled = true;
+int listingPageSize = 0;        // rows per page in listings, 0 = stream everything
+string renderBuffer;            // reused output buffer for large listings
+
+// Hash indexes for O(1) lookups by location ID and by (from, to) road. They
+// are rebuilt lazily, so any code that adds, removes or reorders locations
+// or roads must call markTopologyChanged() (or, for a single append at the
+// end of the table, markLocationAppended() / markRoadAppended()). Not safe
+// to rebuild from worker threads: build graphs on the main thread before
+// fanning out.
+int topologyVersion = 1;
+int weightVersion = 1;          // bumped when road distance, status or availability changes
+int locationIndexVersion = 0;
+int roadIndexVersion = 0;
+unordered_map<int, int> locationIndexByID;
+unordered_map<long long, int> roadIndexByKey;
+unordered_map<int, vector<int>> roadSlotsByOrigin;          // road slots by fromID, ascending
+unordered_map<int, vector<int>> roadSlotsByDestination;     // road slots by toID, ascending
+
+// ============================================
+// TRACING (CHROME TRACE EVENTS)
+// ============================================
+
+// Scoped spans for profiling, written as Chrome trace-event JSON that
+// chrome://tracing, Perfetto or speedscope can open. Each thread records
+// into its own buffer, so spans from parallelFor workers never contend.
+// A buffer is released when its thread exits and the next new thread
+// reuses it, so the registry grows with peak concurrency, not with the
+// number of threads ever started. When tracing is off a span
+// costs one relaxed atomic load. Counters attach to the span as its args.
+// Span and counter names must be string literals.
+
+struct TraceEvent {
+    const char* name;
+    const char* category;
+    long long startMicros;
+    long long durationMicros;
+    vector<pair<const char*, long long>> counters;
+};
+
+struct TraceThreadBuffer {
+    int threadId;
+    bool inUse;                 // guarded by traceRegistryLock
+    vector<TraceEvent> events;
+};
+
+atomic<bool> tracingEnabled(false);
+chrono::steady_clock::time_point traceEpoch = chrono::steady_clock::now();
+mutex traceRegistryLock;
+vector<shared_ptr<TraceThreadBuffer>> traceRegistry;
+
+// Holds a thread's buffer and hands it back when the thread exits
+struct TraceBufferLease {
+    shared_ptr<TraceThreadBuffer> buffer;
+
+    ~TraceBufferLease() {
+        if (!buffer) return;
+        lock_guard<mutex> guard(traceRegistryLock);
+        buffer->inUse = false;
+    }
+};
+
+TraceThreadBuffer& currentTraceBuffer() {
+    thread_local TraceBufferLease lease;
+    if (!lease.buffer) {
+        lock_guard<mutex> guard(traceRegistryLock);
+        for (size_t t = 0; t < traceRegistry.size() && !lease.buffer; t++) {
+            if (!traceRegistry[t]->inUse) lease.buffer = traceRegistry[t];
+        }
+        if (!lease.buffer) {
+            lease.buffer = make_shared<TraceThreadBuffer>();
+            lease.buffer->threadId = (int)traceRegistry.size();
+            traceRegistry.push_back(lease.buffer);
+        }
+        lease.buffer->inUse = true;
+    }
+    return *lease.buffer;
+}
+
+long long traceNowMicros() {
+    return chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - traceEpoch).count();
+}
+
+class TraceSpan {
+public:
+    TraceSpan(const char* name, const char* category = "routing") : active(tracingEnabled.load(memory_order_relaxed)) {
+        if (!active) return;
+        event.name = name;
+        event.category = category;
+        event.startMicros = traceNowMicros();
+    }
+
+    void counter(const char* name, long long value) {
+        if (active) event.counters.push_back(make_pair(name, value));
+    }
+
+    ~TraceSpan() {
+        if (!active) return;
+        event.durationMicros = traceNowMicros() - event.startMicros;
+        currentTraceBuffer().events.push_back(event);
+    }
+
+private:
+    bool active;
+    TraceEvent event;
+};
+
+void startTracing() {
+    currentTraceBuffer();       // the first thread to trace becomes thread 0
+    tracingEnabled = true;
+}
+
+void stopTracing() {
+    tracingEnabled = false;
+}
+
+// Drops recorded events. Only call while no traced work is running.
+void clearTrace() {
+    lock_guard<mutex> guard(traceRegistryLock);
+    for (size_t t = 0; t < traceRegistry.size(); t++) traceRegistry[t]->events.clear();
+}
+
+size_t traceEventCount() {
+    lock_guard<mutex> guard(traceRegistryLock);
+    size_t count = 0;
+    for (size_t t = 0; t < traceRegistry.size(); t++) count += traceRegistry[t]->events.size();
+    return count;
+}
+
+// Writes every recorded span as a complete ("X") event plus a name for each
+// thread. Only call while no traced work is running.
+bool writeChromeTrace(const string& path) {
+    ofstream out(path.c_str());
+    if (!out) return false;
+
+    lock_guard<mutex> guard(traceRegistryLock);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    for (size_t t = 0; t < traceRegistry.size(); t++) {
+        const TraceThreadBuffer& buffer = *traceRegistry[t];
+        out << (first ? "" : ",\n") << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << buffer.threadId
+            << ",\"args\":{\"name\":\"" << (buffer.threadId == 0 ? "main" : "worker " + to_string(buffer.threadId)) << "\"}}";
+        first = false;
+        for (size_t e = 0; e < buffer.events.size(); e++) {
+            const TraceEvent& event = buffer.events[e];
+            out << ",\n{\"ph\":\"X\",\"name\":\"" << event.name << "\",\"cat\":\"" << event.category
+                << "\",\"pid\":1,\"tid\":" << buffer.threadId << ",\"ts\":" << event.startMicros
+                << ",\"dur\":" << event.durationMicros << ",\"args\":{";
+            for (size_t c = 0; c < event.counters.size(); c++) {
+                out << (c > 0 ? "," : "") << "\"" << event.counters[c].first << "\":" << event.counters[c].second;
+            }
+            out << "}}";
+        }
+    }
+    out << "\n]}\n";
+    return (bool)out;
+}
+
 // ============================================
 // UTILITY FUNCTIONS
 // ============================================
@@ -91,576 +326,6589 @@ void closeSectionBorder() {
     cout << BLUE << "+--------------------------------------------------+" << RESET << "\n";
 }
 
-void clearBuffer() {
-    cin.clear();
-    cin.ignore(numeric_limits<streamsize>::max(), '\n');
-}
+// ============================================
+// BUFFERED RENDERING
+// ============================================
 
-int findLocationIndexByID(int id) {
-    for (int i = 0; i < locationCount; i++) {
-        if (locations[i].id == id) {
-            return i;
-        }
-    }
-    return -1;
+// Large listings are built in renderBuffer and written to cout in big
+// chunks instead of thousands of small formatted writes.
+
+void renderText(const string& text) {
+    renderBuffer += text;
 }
 
-bool locationExists(int id) {
-    return findLocationIndexByID(id) != -1;
+void renderText(const char* text) {
+    renderBuffer += text;
 }
 
-string findLocationNameByID(int id) {
-    for (int i = 0; i < locationCount; i++) {
-        if (locations[i].id == id) {
-            return locations[i].name;
-        }
+// Left-aligned cell padded to width (like left << setw(width))
+void renderCell(const string& text, int width) {
+    renderBuffer += text;
+    if ((int)text.size() < width) {
+        renderBuffer.append(width - text.size(), ' ');
     }
-    return "Unknown Location";
+}
+
+void renderCell(int value, int width) {
+    renderCell(to_string(value), width);
 }
 
 // ============================================
-// LOCATION MANAGEMENT
+// NAME ARENA
 // ============================================
 
-void addLocation() {
-    if (locationCount >= MAX_LOCATIONS) {
-        cout << RED << "\n[ERROR] Maximum location limit reached!\n" << RESET;
-        return;
+inline const char* nameData(NameRef name) {
+    return nameArena.data() + name.offset;
+}
+
+// Returns the arena entry equal to name, appending it if it is new
+NameRef internName(const string& name) {
+    vector<NameRef>& bucket = internedNames[hash<string>()(name)];
+    for (size_t i = 0; i < bucket.size(); i++) {
+        if (bucket[i].length == name.size() && memcmp(nameData(bucket[i]), name.data(), name.size()) == 0) {
+            return bucket[i];
+        }
     }
+    NameRef interned = {(unsigned int)nameArena.size(), (unsigned int)name.size()};
+    nameArena += name;
+    bucket.push_back(interned);
+    return interned;
+}
 
-    int id;
-    string name;
+string nameString(NameRef name) {
+    return string(nameData(name), name.length);
+}
 
-    cout << "\nEnter Location ID: ";
-    if (!(cin >> id)) {
-        clearBuffer();
-        cout << RED << "[ERROR] Invalid ID input!\n" << RESET;
-        return;
-    }
+bool nameLess(NameRef a, NameRef b) {
+    int order = memcmp(nameData(a), nameData(b), min(a.length, b.length));
+    return order < 0 || (order == 0 && a.length < b.length);
+}
 
-    // Check if ID already exists
-    for (int i = 0; i < locationCount; i++) {
-        if (locations[i].id == id) {
-            cout << RED << "[ERROR] Location ID already exists!\n" << RESET;
-            return;
-        }
-    }
+// Honours setw() and left/right like a string would
+ostream& operator<<(ostream& out, const NameRef& name) {
+    streamsize padding = max((streamsize)0, out.width() - (streamsize)name.length);
+    bool leftAligned = (out.flags() & ios::adjustfield) == ios::left;
+    out.width(0);
+    if (!leftAligned) for (streamsize i = 0; i < padding; i++) out.put(out.fill());
+    out.write(nameData(name), name.length);
+    if (leftAligned) for (streamsize i = 0; i < padding; i++) out.put(out.fill());
+    return out;
+}
 
-    clearBuffer();
-    cout << "Enter Location Name: ";
-    getline(cin, name);
+void renderText(NameRef name) {
+    renderBuffer.append(nameData(name), name.length);
+}
 
-    if (name.empty()) {
-        cout << RED << "[ERROR] Location name cannot be empty!\n" << RESET;
-        return;
+void renderCell(NameRef name, int width) {
+    renderText(name);
+    if ((int)name.length < width) {
+        renderBuffer.append(width - name.length, ' ');
     }
+}
 
-    locations[locationCount].id = id;
-    locations[locationCount].name = name;
-    locationCount++;
-
-    cout << GREEN << "[SUCCESS] Location added successfully!\n" << RESET;
+// Appends "A -> B -> C" for a path of location indices, names highlighted
+void renderLocationPath(const vector<int>& path) {
+    for (size_t i = 0; i < path.size(); i++) {
+        if (i > 0) renderText(" -> ");
+        renderText(YELLOW);
+        renderText(locations[path[i]].name);
+        renderText(RESET);
+    }
 }
 
-void viewLocations() {
-    if (locationCount == 0) {
-        cout << YELLOW << "\n[INFO] No locations added yet.\n" << RESET;
-        return;
+void renderRouteHops(const vector<NameRef>& hops) {
+    for (size_t i = 0; i < hops.size(); i++) {
+        if (i > 0) renderText(" -> ");
+        renderText(hops[i]);
     }
+}
 
-    displaySection("ALL LOCATIONS");
+void saveRouteToHistory(const vector<NameRef>& hops, const string& note) {
+    Node* newNode = new Node();
+    newNode->hops = hops;
+    newNode->note = note;
+    newNode->next = routeHistoryHead;
+    routeHistoryHead = newNode;
+}
+
+vector<NameRef> locationPathNames(const vector<int>& path) {
+    vector<NameRef> hops(path.size());
+    for (size_t i = 0; i < path.size(); i++) hops[i] = locations[path[i]].name;
+    return hops;
+}
 
-    cout << "| " << left << setw(6) << "ID" << "| " << left << setw(35) << "Location Name" << "|\n";
-    cout << "+-------+---------------------------------------+\n";
+string formatFixed(double value, int precision) {
+    char text[32];
+    snprintf(text, sizeof(text), "%.*f", precision, value);
+    return text;
+}
 
-    for (int i = 0; i < locationCount; i++) {
-        cout << "| " << YELLOW << left << setw(6) << locations[i].id << RESET
-             << "| " << left << setw(35) << locations[i].name << "|\n";
+void flushRender() {
+    if (!renderBuffer.empty()) {
+        cout.write(renderBuffer.data(), renderBuffer.size());
+        renderBuffer.clear();   // keeps its capacity for the next listing
     }
-    closeSectionBorder();
 }
 
-void deleteLocation() {
-    if (locationCount == 0) {
-        cout << YELLOW << "\n[INFO] No locations available to delete.\n" << RESET;
-        return;
+// Call after each listing row. Flushes full chunks and, when paging is on,
+// pauses after every page. Returns false if the user stopped the listing.
+bool endRenderRow(int& rowsShown) {
+    rowsShown++;
+    if (listingPageSize > 0 && rowsShown % listingPageSize == 0) {
+        flushRender();
+        cout << CYAN << "-- " << rowsShown << " rows shown. Enter n for next page, q to stop: " << RESET;
+        string answer;
+        if (!(cin >> answer) || answer == "q" || answer == "Q") {
+            return false;
+        }
+    } else if (renderBuffer.size() >= OUTPUT_FLUSH_BYTES) {
+        flushRender();
     }
+    return true;
+}
 
-    viewLocations();
+const char* roadStatusColor(const string& status) {
+    if (status == "Normal") return GREEN;
+    if (status == "Heavy Traffic") return YELLOW;
+    if (status == "Blocked") return RED;
+    return RESET;
+}
 
-    int id;
-    cout << "\nEnter Location ID to delete: ";
-    if (!(cin >> id)) {
-        clearBuffer();
-        cout << RED << "[ERROR] Invalid ID input!\n" << RESET;
-        return;
-    }
+// Colour is switched off when stdout is not a terminal or NO_COLOR is set
+void detectColorSupport() {
+    colorEnabled = isatty(fileno(stdout)) && getenv("NO_COLOR") == nullptr;
+}
 
-    int foundIndex = -1;
-    for (int i = 0; i < locationCount; i++) {
-        if (locations[i].id == id) {
-            foundIndex = i;
-            break;
+void clearBuffer() {
+    cin.clear();
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+}
+
+void publishGraphSnapshot(const vector<int>& changedLocations, bool appended = false);
+void noteReachabilityWeightChange(const vector<int>& changedLocations);
+int snapshotPauseDepth = 0;         // bulk loads publish one snapshot when they finish
+
+void markTopologyChanged() {
+    topologyVersion++;
+    publishGraphSnapshot(vector<int>());
+}
+
+// Anything derived from road weights (cached graphs, indexes over usable
+// roads) compares its stored version with weightVersion to know it is stale.
+// changedLocations lists the origins of the edited roads; empty means any.
+void markWeightsChanged(const vector<int>& changedLocations = vector<int>()) {
+    weightVersion++;
+    noteReachabilityWeightChange(changedLocations);
+    publishGraphSnapshot(changedLocations);
+}
+
+int findLocationIndexByID(int id) {
+    if (locationIndexVersion != topologyVersion) {
+        locationIndexByID.clear();
+        for (int i = 0; i < locationCount; i++) {
+            locationIndexByID.insert(make_pair(locations[i].id, i));
         }
+        locationIndexVersion = topologyVersion;
     }
 
-    if (foundIndex == -1) {
-        cout << RED << "[ERROR] Location not found!\n" << RESET;
-        return;
-    }
+    unordered_map<int, int>::const_iterator it = locationIndexByID.find(id);
+    return it == locationIndexByID.end() ? -1 : it->second;
+}
 
-    // Shift elements left to delete
-    for (int i = foundIndex; i < locationCount - 1; i++) {
-        locations[i] = locations[i + 1];
-    }
-    locationCount--;
+bool locationExists(int id) {
+    return findLocationIndexByID(id) != -1;
+}
 
-    cout << GREEN << "[SUCCESS] Location deleted successfully!\n" << RESET;
+// Number of worker threads parallelFor() will use for the given job count
+int parallelWorkerCount(int jobCount) {
+    int hardwareThreads = (int)thread::hardware_concurrency();
+    if (hardwareThreads < 1) hardwareThreads = 1;
+    return max(1, min(jobCount, hardwareThreads));
 }
 
-void sortLocationsByName() {
-    if (locationCount == 0) {
-        cout << YELLOW << "\n[INFO] No locations to sort.\n" << RESET;
+// Runs job(jobIndex, workerIndex) for every job across worker threads. The
+// worker index lets callers keep per-thread scratch space without locking.
+void parallelFor(int jobCount, const function<void(int, int)>& job) {
+    int workers = parallelWorkerCount(jobCount);
+    if (workers == 1) {
+        for (int i = 0; i < jobCount; i++) job(i, 0);
         return;
     }
 
-    for (int i = 0; i < locationCount - 1; i++) {
-        int minIndex = i;
-        for (int j = i + 1; j < locationCount; j++) {
-            if (locations[j].name < locations[minIndex].name) {
-                minIndex = j;
+    atomic<int> nextJob(0);
+    vector<thread> pool;
+    for (int w = 0; w < workers; w++) {
+        pool.push_back(thread([&nextJob, &job, jobCount, w]() {
+            TraceSpan span("parallel worker", "parallel");
+            int i, done = 0;
+            while ((i = nextJob++) < jobCount) {
+                job(i, w);
+                done++;
             }
-        }
-        if (minIndex != i) {
-            Location temp = locations[i];
-            locations[i] = locations[minIndex];
-            locations[minIndex] = temp;
-        }
+            span.counter("jobs", done);
+        }));
     }
+    for (size_t w = 0; w < pool.size(); w++) {
+        pool[w].join();
+    }
+}
 
-    cout << GREEN << "\n[SUCCESS] Locations sorted alphabetically!\n" << RESET;
-    viewLocations();
+NameRef findLocationNameByID(int id) {
+    int index = findLocationIndexByID(id);
+    if (index != -1) {
+        return locations[index].name;
+    }
+    return internName("Unknown Location");
 }
 
 // ============================================
-// ROAD MANAGEMENT
+// SPATIAL INDEX (UNIFORM GRID)
 // ============================================
 
-bool roadExists(int fromID, int toID) {
-    for (int i = 0; i < roadCount; i++) {
-        if (roads[i].fromID == fromID && roads[i].toID == toID) {
-            return true;
-        }
-    }
-    return false;
-}
+// Locations are bucketed into square lat/long grid cells keyed in a hash
+// map. Insert and remove are O(1) and keep the index in step with
+// addLocation()/deleteLocation(); k-nearest queries search rings of cells
+// outward from the query point, and range queries visit only the cells
+// overlapping the box. The cell size is re-chosen when cells get crowded.
 
-void addRoad() {
-    if (roadCount >= MAX_ROADS) {
-        cout << RED << "\n[ERROR] Maximum road limit reached!\n" << RESET;
-        return;
-    }
+const double KM_PER_DEGREE_LAT = 110.574;
+const double KM_PER_DEGREE_LON = 111.320;      // at the equator, scaled by cos(latitude)
+const int SPATIAL_TARGET_PER_CELL = 4;
+const int SPATIAL_MAX_PER_CELL = 32;           // average occupancy that triggers a rebuild
 
-    if (locationCount < 2) {
-        cout << YELLOW << "\n[INFO] Add at least 2 locations before adding roads.\n" << RESET;
-        return;
-    }
+struct SpatialEntry {
+    int id;
+    double latitude;
+    double longitude;
+};
 
-    int fromID, toID, distance;
-    string status;
-    bool isOneWay;
-    bool isAvailable;
+struct SpatialGrid {
+    double cellDegrees;
+    int pointCount;
+    int minCellX, maxCellX, minCellY, maxCellY;   // bounds of occupied cells
+    int builtPointCount;                            // points at the last rebuild
+    unordered_map<long long, vector<SpatialEntry>> cells;
+    map<int, int> occupiedInColumn, occupiedInRow;  // occupied cells per cell x / y, for the bounds
+};
 
-    viewLocations();
+SpatialGrid spatialIndex = {0.01, 0, 0, -1, 0, -1, 0, unordered_map<long long, vector<SpatialEntry>>(),
+                            map<int, int>(), map<int, int>()};
 
-    cout << "\nEnter From Location ID: ";
-    if (!(cin >> fromID)) {
-        clearBuffer();
-        cout << RED << "[ERROR] Invalid input!\n" << RESET;
-        return;
-    }
+int spatialCellCoordinate(double degrees) {
+    return (int)floor(degrees / spatialIndex.cellDegrees);
+}
 
-    cout << "Enter To Location ID: ";
-    if (!(cin >> toID)) {
-        clearBuffer();
-        cout << RED << "[ERROR] Invalid input!\n" << RESET;
-        return;
-    }
+long long spatialCellKey(int cellX, int cellY) {
+    return ((long long)cellX << 32) | (unsigned int)cellY;
+}
 
-    if (fromID == toID) {
-        cout << RED << "[ERROR] Cannot create a road from a location to itself!\n" << RESET;
-        return;
-    }
+// Approximate ground distance in km (equirectangular projection)
+double groundDistanceKm(double lat1, double lon1, double lat2, double lon2) {
+    const double PI = 3.14159265358979323846;
+    double dy = (lat2 - lat1) * KM_PER_DEGREE_LAT;
+    double dx = (lon2 - lon1) * KM_PER_DEGREE_LON * cos((lat1 + lat2) * 0.5 * PI / 180.0);
+    return sqrt(dx * dx + dy * dy);
+}
 
-    if (!locationExists(fromID) || !locationExists(toID)) {
-        cout << RED << "[ERROR] One or both locations do not exist!\n" << RESET;
+// Occupied-cell bounds from the per-column and per-row counts, so they
+// shrink again when the outermost cells empty
+void updateSpatialBounds() {
+    if (spatialIndex.cells.empty()) {
+        spatialIndex.minCellX = spatialIndex.minCellY = 0;
+        spatialIndex.maxCellX = spatialIndex.maxCellY = -1;
         return;
     }
+    spatialIndex.minCellX = spatialIndex.occupiedInColumn.begin()->first;
+    spatialIndex.maxCellX = spatialIndex.occupiedInColumn.rbegin()->first;
+    spatialIndex.minCellY = spatialIndex.occupiedInRow.begin()->first;
+    spatialIndex.maxCellY = spatialIndex.occupiedInRow.rbegin()->first;
+}
 
-    if (roadExists(fromID, toID)) {
-        cout << RED << "[ERROR] Road from " << fromID << " to " << toID << " already exists!\n" << RESET;
-        return;
+void spatialInsertEntry(const SpatialEntry& entry) {
+    int cellX = spatialCellCoordinate(entry.longitude);
+    int cellY = spatialCellCoordinate(entry.latitude);
+    vector<SpatialEntry>& cell = spatialIndex.cells[spatialCellKey(cellX, cellY)];
+    if (cell.empty()) {
+        spatialIndex.occupiedInColumn[cellX]++;
+        spatialIndex.occupiedInRow[cellY]++;
+        updateSpatialBounds();
     }
+    cell.push_back(entry);
+    spatialIndex.pointCount++;
+}
 
-    cout << "Enter Distance (km): ";
-    if (!(cin >> distance) || distance <= 0) {
-        clearBuffer();
-        cout << RED << "[ERROR] Invalid distance!\n" << RESET;
-        return;
+// Rebuilds the grid from locations[] with a cell size that puts about
+// SPATIAL_TARGET_PER_CELL locations in each cell of their bounding box
+void rebuildSpatialIndex() {
+    double minLat = 0, maxLat = 0, minLon = 0, maxLon = 0;
+    for (int i = 0; i < locationCount; i++) {
+        if (i == 0 || locations[i].latitude < minLat) minLat = locations[i].latitude;
+        if (i == 0 || locations[i].latitude > maxLat) maxLat = locations[i].latitude;
+        if (i == 0 || locations[i].longitude < minLon) minLon = locations[i].longitude;
+        if (i == 0 || locations[i].longitude > maxLon) maxLon = locations[i].longitude;
     }
+    double area = max(maxLat - minLat, 1e-4) * max(maxLon - minLon, 1e-4);
+    double cellsWanted = max(1.0, (double)locationCount / SPATIAL_TARGET_PER_CELL);
+    spatialIndex.cellDegrees = max(1e-5, sqrt(area / cellsWanted));
+
+    spatialIndex.cells.clear();
+    spatialIndex.occupiedInColumn.clear();
+    spatialIndex.occupiedInRow.clear();
+    spatialIndex.pointCount = 0;
+    updateSpatialBounds();
+    for (int i = 0; i < locationCount; i++) {
+        SpatialEntry entry = {locations[i].id, locations[i].latitude, locations[i].longitude};
+        spatialInsertEntry(entry);
+    }
+    spatialIndex.builtPointCount = spatialIndex.pointCount;
+}
 
-    clearBuffer();
-    cout << "Enter Road Status (Normal/Heavy Traffic/Blocked): ";
-    getline(cin, status);
-
-    if (status != "Normal" && status != "Heavy Traffic" && status != "Blocked") {
-        cout << RED << "[ERROR] Invalid status! Use 'Normal', 'Heavy Traffic', or 'Blocked'.\n" << RESET;
-        return;
+// Rebuilds only once the point count has doubled since the last rebuild:
+// with clustered locations (a city far from the rest) no cell size brings
+// the average down, and rebuilding on every insert would be quadratic
+void spatialInsert(const Location& location) {
+    SpatialEntry entry = {location.id, location.latitude, location.longitude};
+    spatialInsertEntry(entry);
+    if (spatialIndex.pointCount > (int)spatialIndex.cells.size() * SPATIAL_MAX_PER_CELL &&
+        spatialIndex.pointCount >= 2 * spatialIndex.builtPointCount) {
+        rebuildSpatialIndex();
+    }
+}
+
+void spatialRemove(const Location& location) {
+    int cellX = spatialCellCoordinate(location.longitude);
+    int cellY = spatialCellCoordinate(location.latitude);
+    unordered_map<long long, vector<SpatialEntry>>::iterator cell = spatialIndex.cells.find(spatialCellKey(cellX, cellY));
+    if (cell == spatialIndex.cells.end()) return;
+
+    vector<SpatialEntry>& entries = cell->second;
+    for (size_t k = 0; k < entries.size(); k++) {
+        if (entries[k].id == location.id) {
+            entries[k] = entries.back();
+            entries.pop_back();
+            spatialIndex.pointCount--;
+            break;
+        }
+    }
+    if (entries.empty()) {
+        spatialIndex.cells.erase(cell);
+        if (--spatialIndex.occupiedInColumn[cellX] == 0) spatialIndex.occupiedInColumn.erase(cellX);
+        if (--spatialIndex.occupiedInRow[cellY] == 0) spatialIndex.occupiedInRow.erase(cellY);
+        updateSpatialBounds();
+    }
+}
+
+// The k locations closest to a point, nearest first, as (km, location ID).
+// Rings start at the first one touching the occupied cells, and only the
+// part of each ring's border inside the occupied bounds is looked up, so a
+// query far from every location costs no more than one next to them.
+vector<pair<double, int>> spatialNearest(double latitude, double longitude, int k) {
+    vector<pair<double, int>> best;    // max-heap on distance, at most k entries
+    if (spatialIndex.pointCount == 0 || k <= 0) return best;
+
+    int centerX = spatialCellCoordinate(longitude);
+    int centerY = spatialCellCoordinate(latitude);
+    int minX = spatialIndex.minCellX, maxX = spatialIndex.maxCellX;
+    int minY = spatialIndex.minCellY, maxY = spatialIndex.maxCellY;
+    // Distances scale longitude at the mean latitude of the two points, so
+    // the cell width bound uses the most poleward latitude either can have
+    const double PI = 3.14159265358979323846;
+    double poleward = max(fabs(latitude), max(fabs(minY * spatialIndex.cellDegrees), fabs((maxY + 1) * spatialIndex.cellDegrees)));
+    double cellKm = spatialIndex.cellDegrees * min(KM_PER_DEGREE_LAT, KM_PER_DEGREE_LON * cos(min(poleward, 90.0) * PI / 180.0));
+    int firstRing = max(max(max(minX - centerX, centerX - maxX), max(minY - centerY, centerY - maxY)), 0);
+    int maxRing = max(max(abs(centerX - minX), abs(centerX - maxX)), max(abs(centerY - minY), abs(centerY - maxY)));
+
+    auto visitCell = [&](int x, int y) {
+        unordered_map<long long, vector<SpatialEntry>>::const_iterator cell = spatialIndex.cells.find(spatialCellKey(x, y));
+        if (cell == spatialIndex.cells.end()) return;
+
+        for (size_t e = 0; e < cell->second.size(); e++) {
+            const SpatialEntry& entry = cell->second[e];
+            double d = groundDistanceKm(latitude, longitude, entry.latitude, entry.longitude);
+            if ((int)best.size() < k) {
+                best.push_back(make_pair(d, entry.id));
+                push_heap(best.begin(), best.end());
+            } else if (d < best.front().first) {
+                pop_heap(best.begin(), best.end());
+                best.back() = make_pair(d, entry.id);
+                push_heap(best.begin(), best.end());
+            }
+        }
+    };
+
+    for (int ring = firstRing; ring <= maxRing; ring++) {
+        // Anything in ring r or beyond is at least (r - 1) cells away
+        if ((int)best.size() == k && best.front().first <= (ring - 1) * cellKm) break;
+
+        // Top and bottom rows, then the left and right columns between them
+        int fromX = max(centerX - ring, minX), toX = min(centerX + ring, maxX);
+        for (int side = 0; side < 2; side++) {
+            int y = side == 0 ? centerY - ring : centerY + ring;
+            if (y < minY || y > maxY || (side == 1 && ring == 0)) continue;
+            for (int x = fromX; x <= toX; x++) visitCell(x, y);
+        }
+        int fromY = max(centerY - ring + 1, minY), toY = min(centerY + ring - 1, maxY);
+        for (int side = 0; side < 2 && ring > 0; side++) {
+            int x = side == 0 ? centerX - ring : centerX + ring;
+            if (x < minX || x > maxX) continue;
+            for (int y = fromY; y <= toY; y++) visitCell(x, y);
+        }
+    }
+
+    sort_heap(best.begin(), best.end());
+    return best;
+}
+
+// IDs of all locations inside a latitude/longitude box
+vector<int> spatialRange(double minLatitude, double minLongitude, double maxLatitude, double maxLongitude) {
+    vector<int> found;
+    int fromX = max(spatialCellCoordinate(minLongitude), spatialIndex.minCellX);
+    int toX = min(spatialCellCoordinate(maxLongitude), spatialIndex.maxCellX);
+    int fromY = max(spatialCellCoordinate(minLatitude), spatialIndex.minCellY);
+    int toY = min(spatialCellCoordinate(maxLatitude), spatialIndex.maxCellY);
+
+    // A huge box is cheaper to answer by walking the occupied cells
+    bool walkAllCells = fromX <= toX && fromY <= toY &&
+                        (double)(toX - fromX + 1) * (toY - fromY + 1) > (double)spatialIndex.cells.size();
+
+    if (walkAllCells) {
+        for (unordered_map<long long, vector<SpatialEntry>>::const_iterator cell = spatialIndex.cells.begin();
+             cell != spatialIndex.cells.end(); ++cell) {
+            for (size_t e = 0; e < cell->second.size(); e++) {
+                const SpatialEntry& entry = cell->second[e];
+                if (entry.latitude >= minLatitude && entry.latitude <= maxLatitude &&
+                    entry.longitude >= minLongitude && entry.longitude <= maxLongitude) {
+                    found.push_back(entry.id);
+                }
+            }
+        }
+        return found;
+    }
+
+    for (int x = fromX; x <= toX; x++) {
+        for (int y = fromY; y <= toY; y++) {
+            unordered_map<long long, vector<SpatialEntry>>::const_iterator cell = spatialIndex.cells.find(spatialCellKey(x, y));
+            if (cell == spatialIndex.cells.end()) continue;
+
+            for (size_t e = 0; e < cell->second.size(); e++) {
+                const SpatialEntry& entry = cell->second[e];
+                if (entry.latitude >= minLatitude && entry.latitude <= maxLatitude &&
+                    entry.longitude >= minLongitude && entry.longitude <= maxLongitude) {
+                    found.push_back(entry.id);
+                }
+            }
+        }
+    }
+    return found;
+}
+
+bool readCoordinates(double& latitude, double& longitude) {
+    cout << "Enter Latitude: ";
+    if (!(cin >> latitude) || latitude < -90 || latitude > 90) {
+        clearBuffer();
+        cout << RED << "[ERROR] Latitude must be between -90 and 90!\n" << RESET;
+        return false;
+    }
+    cout << "Enter Longitude: ";
+    if (!(cin >> longitude) || longitude < -180 || longitude > 180) {
+        clearBuffer();
+        cout << RED << "[ERROR] Longitude must be between -180 and 180!\n" << RESET;
+        return false;
+    }
+    return true;
+}
+
+void findNearestLocations() {
+    if (locationCount == 0) {
+        cout << YELLOW << "\n[INFO] No locations added yet.\n" << RESET;
+        return;
+    }
+
+    cout << "\nGPS point to snap:\n";
+    double latitude, longitude;
+    if (!readCoordinates(latitude, longitude)) return;
+
+    cout << "How many nearest locations? ";
+    int k;
+    if (!(cin >> k) || k <= 0) {
+        clearBuffer();
+        cout << RED << "[ERROR] Invalid number!\n" << RESET;
+        return;
+    }
+
+    vector<pair<double, int>> nearest = spatialNearest(latitude, longitude, k);
+
+    displaySection("NEAREST LOCATIONS");
+    for (size_t i = 0; i < nearest.size(); i++) {
+        cout << (i + 1) << ". " << YELLOW << "[" << nearest[i].second << "] " << RESET
+             << findLocationNameByID(nearest[i].second) << " - " << GREEN
+             << fixed << setprecision(2) << nearest[i].first << " km" << RESET << "\n";
+    }
+    closeSectionBorder();
+}
+
+void listLocationsInViewport() {
+    if (locationCount == 0) {
+        cout << YELLOW << "\n[INFO] No locations added yet.\n" << RESET;
+        return;
+    }
+
+    cout << "\nSouth-west corner:\n";
+    double minLatitude, minLongitude;
+    if (!readCoordinates(minLatitude, minLongitude)) return;
+    cout << "North-east corner:\n";
+    double maxLatitude, maxLongitude;
+    if (!readCoordinates(maxLatitude, maxLongitude)) return;
+
+    vector<int> found = spatialRange(minLatitude, minLongitude, maxLatitude, maxLongitude);
+    sort(found.begin(), found.end());
+
+    displaySection("LOCATIONS IN VIEWPORT");
+    for (size_t i = 0; i < found.size(); i++) {
+        cout << YELLOW << "[" << found[i] << "] " << RESET << findLocationNameByID(found[i]) << "\n";
+    }
+    if (found.empty()) {
+        cout << YELLOW << "[INFO] No locations in this area.\n" << RESET;
+    }
+    closeSectionBorder();
+}
+
+// ============================================
+// WRITE-AHEAD JOURNAL (PERSISTENCE)
+// ============================================
+
+// Every location and road edit is appended to a binary journal as the
+// physical change it made (one record per road touched). Records are
+// buffered and made durable together by journalCommit(), one fsync per
+// group: an interactive edit commits on its own, a traffic-feed batch
+// commits all of its updates at once. When the journal grows past
+// JOURNAL_CHECKPOINT_BYTES the whole state is written to a checkpoint and
+// the journal restarts, so recovery loads the checkpoint and replays only
+// the journal tail.
+//
+// Journal file:    "NAVJ" u32 format, u64 checkpoint sequence, then records
+// Record:          u32 payload length, u8 type, payload, u32 checksum
+// Checkpoint file: "NAVC" u32 format, u64 sequence, state, u32 checksum
+//
+// A journal whose sequence is older than the checkpoint's predates it (the
+// process stopped between writing the checkpoint and resetting the journal)
+// and is replaced. A torn or corrupt record ends replay and is cut off.
+
+const char* const JOURNAL_FILE = "navigation.journal";
+const char* const CHECKPOINT_FILE = "navigation.checkpoint";
+const unsigned int JOURNAL_FORMAT = 1;
+const size_t JOURNAL_HEADER_BYTES = 16;
+const long long JOURNAL_CHECKPOINT_BYTES = 256 * 1024;
+const size_t JOURNAL_MAX_RECORD_BYTES = 1 << 20;    // the location order record holds every ID
+
+enum JournalRecordType {
+    JOURNAL_ADD_LOCATION = 1,       // id, name, latitude, longitude
+    JOURNAL_DELETE_LOCATION,        // id
+    JOURNAL_ORDER_LOCATIONS,        // count, ids in their new order
+    JOURNAL_ADD_ROAD,               // every Road field
+    JOURNAL_DELETE_ROAD,            // from, to
+    JOURNAL_ROAD_DISTANCE,          // from, to, distance
+    JOURNAL_ROAD_STATE              // from, to, status, available
+};
+
+struct JournalWriter {
+    FILE* file;
+    string pending;                 // encoded records not yet written
+    int pendingRecords;
+    long long fileBytes;
+    long long recordsSinceCheckpoint;
+    long long commits;
+    long long committedRecords;
+};
+
+struct JournalRecoveryReport {
+    bool checkpointLoaded;
+    int recordsReplayed;
+    int recordsSkipped;         // intact records that no longer apply (e.g. a full table)
+    bool tailTruncated;
+    bool journalKept;           // journal does not extend the loaded state; left untouched
+    double milliseconds;
+};
+
+JournalWriter journal = {nullptr, "", 0, 0, 0, 0, 0};
+JournalRecoveryReport lastRecovery = {false, 0, 0, false, false, 0.0};
+unsigned long long checkpointSequence = 0;
+bool journalWritable = false;       // set by recovery; nothing is written to disk before it
+int journalPauseDepth = 0;          // simulations pause journaling and log their net result instead
+
+unsigned int journalChecksum(const char* data, size_t length) {
+    unsigned int hash = 2166136261u;      // FNV-1a
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (unsigned char)data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+void putUint32(string& out, unsigned int value) {
+    for (int b = 0; b < 4; b++) out.push_back((char)((value >> (8 * b)) & 0xFF));
+}
+
+void putUint64(string& out, unsigned long long value) {
+    for (int b = 0; b < 8; b++) out.push_back((char)((value >> (8 * b)) & 0xFF));
+}
+
+void putDouble(string& out, double value) {
+    unsigned long long bits;
+    memcpy(&bits, &value, sizeof(bits));
+    putUint64(out, bits);
+}
+
+void putText(string& out, const string& text) {
+    putUint32(out, (unsigned int)text.size());
+    out += text;
+}
+
+// Bounds-checked reader over an encoded buffer; ok turns false on overrun
+struct JournalCursor {
+    const string* data;
+    size_t position;
+    bool ok;
+};
+
+unsigned long long takeBytes(JournalCursor& cursor, int count) {
+    if (!cursor.ok || cursor.position + count > cursor.data->size()) {
+        cursor.ok = false;
+        return 0;
+    }
+    unsigned long long value = 0;
+    for (int b = 0; b < count; b++) {
+        value |= (unsigned long long)(unsigned char)(*cursor.data)[cursor.position + b] << (8 * b);
+    }
+    cursor.position += count;
+    return value;
+}
+
+int takeInt(JournalCursor& cursor) {
+    return (int)(unsigned int)takeBytes(cursor, 4);
+}
+
+double takeDouble(JournalCursor& cursor) {
+    unsigned long long bits = takeBytes(cursor, 8);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+string takeText(JournalCursor& cursor) {
+    size_t length = (size_t)takeBytes(cursor, 4);
+    if (!cursor.ok || cursor.position + length > cursor.data->size()) {
+        cursor.ok = false;
+        return "";
+    }
+    string text = cursor.data->substr(cursor.position, length);
+    cursor.position += length;
+    return text;
+}
+
+void putRoad(string& out, const Road& road) {
+    putUint32(out, road.fromID);
+    putUint32(out, road.toID);
+    putUint32(out, road.distance);
+    putText(out, road.status);
+    out.push_back(road.isOneWay ? 1 : 0);
+    out.push_back(road.isAvailable ? 1 : 0);
+    putUint32(out, road.speedLimit);
+    putDouble(out, road.toll);
+}
+
+Road takeRoad(JournalCursor& cursor) {
+    Road road;
+    road.fromID = takeInt(cursor);
+    road.toID = takeInt(cursor);
+    road.distance = takeInt(cursor);
+    road.status = takeText(cursor);
+    road.isOneWay = takeBytes(cursor, 1) != 0;
+    road.isAvailable = takeBytes(cursor, 1) != 0;
+    road.speedLimit = takeInt(cursor);
+    road.toll = takeDouble(cursor);
+    return road;
+}
+
+// Flushes the C stream and forces the data to stable storage
+bool syncFile(FILE* file) {
+    if (fflush(file) != 0) return false;
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+// Cuts the file back to its first `bytes` bytes and leaves it positioned at the end
+bool truncateFile(FILE* file, long long bytes) {
+    if (fflush(file) != 0) return false;
+#ifdef _WIN32
+    bool cut = _chsize_s(_fileno(file), bytes) == 0;
+#else
+    bool cut = ftruncate(fileno(file), (off_t)bytes) == 0;
+#endif
+    return cut && syncFile(file) && fseek(file, 0, SEEK_END) == 0;
+}
+
+// Replaces `to` with `from` in one step: a crash leaves either the old file
+// or the new one, never neither
+bool replaceFile(const char* from, const char* to) {
+#ifdef _WIN32
+    return MoveFileExA(from, to, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return rename(from, to) == 0;
+#endif
+}
+
+// Makes renames in the working directory durable (MOVEFILE_WRITE_THROUGH
+// already does this on Windows)
+bool syncWorkingDirectory() {
+#ifdef _WIN32
+    return true;
+#else
+    int directory = open(".", O_RDONLY);
+    if (directory == -1) return false;
+    bool synced = fsync(directory) == 0;
+    close(directory);
+    return synced;
+#endif
+}
+
+FILE* createJournalFile(const char* path, unsigned long long sequence) {
+    FILE* file = fopen(path, "wb");
+    if (file == nullptr) return nullptr;
+    string header = "NAVJ";
+    putUint32(header, JOURNAL_FORMAT);
+    putUint64(header, sequence);
+    bool written = fwrite(header.data(), 1, header.size(), file) == header.size();
+    if (!syncFile(file) || !written) {
+        fclose(file);
+        return nullptr;
+    }
+    return file;
+}
+
+void journalAppendRecord(JournalWriter& writer, int type, const string& payload) {
+    string body(1, (char)type);
+    body += payload;
+    putUint32(writer.pending, (unsigned int)payload.size());
+    writer.pending += body;
+    putUint32(writer.pending, journalChecksum(body.data(), body.size()));
+    writer.pendingRecords++;
+}
+
+// Writes every pending record with a single fsync
+bool journalFlushGroup(JournalWriter& writer) {
+    if (writer.pending.empty()) return true;
+    TraceSpan span("journal group commit", "journal");
+    span.counter("records", writer.pendingRecords);
+    span.counter("bytes", (long long)writer.pending.size());
+    if (writer.file == nullptr) {
+        writer.pending.clear();
+        writer.pendingRecords = 0;
+        return false;
+    }
+    bool written = fwrite(writer.pending.data(), 1, writer.pending.size(), writer.file) == writer.pending.size();
+    written = syncFile(writer.file) && written;
+    if (written) {
+        writer.fileBytes += writer.pending.size();
+        writer.recordsSinceCheckpoint += writer.pendingRecords;
+        writer.committedRecords += writer.pendingRecords;
+        writer.commits++;
+    } else if (!truncateFile(writer.file, writer.fileBytes)) {
+        // A partial group cannot be cut off, so later records would sit
+        // behind garbage that recovery stops at: stop journaling instead
+        fclose(writer.file);
+        writer.file = nullptr;
+    }
+    writer.pending.clear();
+    writer.pendingRecords = 0;
+    return written;
+}
+
+// Records are buffered even while the journal is closed, so that the next
+// commit reports the edit as unsaved instead of dropping it silently
+void journalAppend(int type, const string& payload) {
+    if (journalPauseDepth > 0) return;
+    journalAppendRecord(journal, type, payload);
+}
+
+void journalLocationAdded(const Location& location) {
+    string payload;
+    putUint32(payload, location.id);
+    putText(payload, nameString(location.name));
+    putDouble(payload, location.latitude);
+    putDouble(payload, location.longitude);
+    journalAppend(JOURNAL_ADD_LOCATION, payload);
+}
+
+void journalLocationDeleted(int id) {
+    string payload;
+    putUint32(payload, id);
+    journalAppend(JOURNAL_DELETE_LOCATION, payload);
+}
+
+void journalLocationOrder() {
+    string payload;
+    putUint32(payload, locationCount);
+    for (int i = 0; i < locationCount; i++) putUint32(payload, locations[i].id);
+    journalAppend(JOURNAL_ORDER_LOCATIONS, payload);
+}
+
+void journalRoadAdded(const Road& road) {
+    string payload;
+    putRoad(payload, road);
+    journalAppend(JOURNAL_ADD_ROAD, payload);
+}
+
+void journalRoadDeleted(int fromID, int toID) {
+    string payload;
+    putUint32(payload, fromID);
+    putUint32(payload, toID);
+    journalAppend(JOURNAL_DELETE_ROAD, payload);
+}
+
+void journalRoadDistance(const Road& road) {
+    string payload;
+    putUint32(payload, road.fromID);
+    putUint32(payload, road.toID);
+    putUint32(payload, road.distance);
+    journalAppend(JOURNAL_ROAD_DISTANCE, payload);
+}
+
+void journalRoadState(const Road& road) {
+    string payload;
+    putUint32(payload, road.fromID);
+    putUint32(payload, road.toID);
+    putText(payload, road.status);
+    payload.push_back(road.isAvailable ? 1 : 0);
+    journalAppend(JOURNAL_ROAD_STATE, payload);
+}
+
+string encodeCheckpointState() {
+    string body;
+    putUint32(body, locationCount);
+    for (int i = 0; i < locationCount; i++) {
+        putUint32(body, locations[i].id);
+        putText(body, nameString(locations[i].name));
+        putDouble(body, locations[i].latitude);
+        putDouble(body, locations[i].longitude);
+    }
+    putUint32(body, roadCount);
+    for (int i = 0; i < roadCount; i++) putRoad(body, roads[i]);
+    return body;
+}
+
+// Writes the full state to a new checkpoint (temp file + atomic rename over
+// the old one), then starts an empty journal that extends it
+bool writeCheckpoint() {
+    TraceSpan span("checkpoint", "journal");
+    if (!journalWritable) return false;
+    journalFlushGroup(journal);
+
+    string contents = "NAVC";
+    putUint32(contents, JOURNAL_FORMAT);
+    putUint64(contents, checkpointSequence + 1);
+    string body = encodeCheckpointState();
+    contents += body;
+    putUint32(contents, journalChecksum(body.data(), body.size()));
+
+    string tempPath = string(CHECKPOINT_FILE) + ".tmp";
+    FILE* file = fopen(tempPath.c_str(), "wb");
+    if (file == nullptr) return false;
+    bool written = fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+    written = syncFile(file) && written;
+    fclose(file);
+    if (!written || !replaceFile(tempPath.c_str(), CHECKPOINT_FILE)) {
+        remove(tempPath.c_str());
+        return false;
+    }
+    // The new checkpoint is in place, so the old journal is stale from here on
+    bool synced = syncWorkingDirectory();
+    checkpointSequence++;
+
+    if (journal.file != nullptr) fclose(journal.file);
+    journal.file = createJournalFile(JOURNAL_FILE, checkpointSequence);
+    journal.fileBytes = JOURNAL_HEADER_BYTES;
+    journal.recordsSinceCheckpoint = 0;
+    return synced && journal.file != nullptr;
+}
+
+// Makes the records of the current edit durable; call before reporting
+// success and report failure when it returns false. Checkpoints once the
+// journal tail has grown large enough, or when the journal write failed
+// (the checkpoint then holds the edit instead).
+bool journalCommit() {
+    bool durable = journalFlushGroup(journal);
+    if (!durable || (journal.file != nullptr && journal.fileBytes >= JOURNAL_CHECKPOINT_BYTES)) {
+        durable = writeCheckpoint() || durable;
+    }
+    return durable;
+}
+
+void printJournalError() {
+    cout << RED << "[ERROR] The change was applied but could not be saved to " << JOURNAL_FILE << "!\n" << RESET;
+}
+
+long long roadKey(int fromID, int toID);
+
+// Replay state: table slots by location ID and by road key, built once
+// before the first record. Deletes only mark their slot; the tables are
+// compacted in one pass at the end (or before a record that needs the
+// final order), so a journal of deletes replays in O(records + table)
+// rather than shifting the tables once per record.
+struct JournalReplay {
+    unordered_map<int, int> locationSlotByID;
+    unordered_map<long long, int> roadSlotByKey;
+    vector<char> locationDeleted;       // by slot
+    vector<char> roadDeleted;
+    int deletedLocations;
+    int deletedRoads;
+};
+
+void indexJournalReplay(JournalReplay& replay) {
+    replay.locationSlotByID.clear();
+    replay.roadSlotByKey.clear();
+    for (int i = 0; i < locationCount; i++) replay.locationSlotByID.insert(make_pair(locations[i].id, i));
+    for (int i = 0; i < roadCount; i++) replay.roadSlotByKey.insert(make_pair(roadKey(roads[i].fromID, roads[i].toID), i));
+    replay.locationDeleted.assign(MAX_LOCATIONS, 0);
+    replay.roadDeleted.assign(MAX_ROADS, 0);
+    replay.deletedLocations = replay.deletedRoads = 0;
+}
+
+// Drops the deleted slots, keeping the order of the rest
+void compactJournalReplay(JournalReplay& replay) {
+    if (replay.deletedLocations == 0 && replay.deletedRoads == 0) return;
+    int kept = 0;
+    for (int i = 0; i < locationCount; i++) {
+        if (!replay.locationDeleted[i]) locations[kept++] = locations[i];
+    }
+    locationCount = kept;
+    kept = 0;
+    for (int i = 0; i < roadCount; i++) {
+        if (!replay.roadDeleted[i]) roads[kept++] = roads[i];
+    }
+    roadCount = kept;
+    indexJournalReplay(replay);
+}
+
+int replayRoadSlot(const JournalReplay& replay, int fromID, int toID) {
+    unordered_map<long long, int>::const_iterator slot = replay.roadSlotByKey.find(roadKey(fromID, toID));
+    return slot == replay.roadSlotByKey.end() ? -1 : slot->second;
+}
+
+// Re-applies one record to the arrays. Derived indexes are refreshed once
+// replay ends; lookups here go through the replay state.
+bool replayJournalRecord(JournalReplay& replay, int type, const string& payload) {
+    JournalCursor cursor = {&payload, 0, true};
+    if (type == JOURNAL_ADD_LOCATION) {
+        Location location;
+        location.id = takeInt(cursor);
+        location.name = internName(takeText(cursor));
+        location.latitude = takeDouble(cursor);
+        location.longitude = takeDouble(cursor);
+        if (locationCount >= MAX_LOCATIONS) compactJournalReplay(replay);
+        if (!cursor.ok || locationCount >= MAX_LOCATIONS) return false;
+        replay.locationSlotByID.insert(make_pair(location.id, locationCount));
+        locations[locationCount++] = location;
+    } else if (type == JOURNAL_DELETE_LOCATION) {
+        unordered_map<int, int>::iterator slot = replay.locationSlotByID.find(takeInt(cursor));
+        if (cursor.ok && slot != replay.locationSlotByID.end()) {
+            replay.locationDeleted[slot->second] = 1;
+            replay.deletedLocations++;
+            replay.locationSlotByID.erase(slot);
+        }
+    } else if (type == JOURNAL_ORDER_LOCATIONS) {
+        compactJournalReplay(replay);
+        int count = takeInt(cursor);
+        if (!cursor.ok || count != locationCount) return false;
+        vector<Location> ordered;
+        for (int i = 0; i < count; i++) {
+            unordered_map<int, int>::const_iterator slot = replay.locationSlotByID.find(takeInt(cursor));
+            if (slot != replay.locationSlotByID.end()) ordered.push_back(locations[slot->second]);
+        }
+        if (!cursor.ok || (int)ordered.size() != locationCount) return false;
+        for (int i = 0; i < locationCount; i++) locations[i] = ordered[i];
+        indexJournalReplay(replay);
+    } else if (type == JOURNAL_ADD_ROAD) {
+        Road road = takeRoad(cursor);
+        if (roadCount >= MAX_ROADS) compactJournalReplay(replay);
+        if (!cursor.ok || roadCount >= MAX_ROADS) return false;
+        replay.roadSlotByKey.insert(make_pair(roadKey(road.fromID, road.toID), roadCount));
+        roads[roadCount++] = road;
+    } else if (type == JOURNAL_DELETE_ROAD) {
+        int fromID = takeInt(cursor), toID = takeInt(cursor);
+        int slot = replayRoadSlot(replay, fromID, toID);
+        if (cursor.ok && slot != -1) {
+            replay.roadDeleted[slot] = 1;
+            replay.deletedRoads++;
+            replay.roadSlotByKey.erase(roadKey(fromID, toID));
+        }
+    } else if (type == JOURNAL_ROAD_DISTANCE) {
+        int fromID = takeInt(cursor), toID = takeInt(cursor), distance = takeInt(cursor);
+        int slot = replayRoadSlot(replay, fromID, toID);
+        if (cursor.ok && slot != -1) roads[slot].distance = distance;
+    } else if (type == JOURNAL_ROAD_STATE) {
+        int fromID = takeInt(cursor), toID = takeInt(cursor);
+        string status = takeText(cursor);
+        bool available = takeBytes(cursor, 1) != 0;
+        int slot = replayRoadSlot(replay, fromID, toID);
+        if (cursor.ok && slot != -1) {
+            roads[slot].status = status;
+            roads[slot].isAvailable = available;
+        }
+    } else {
+        return false;
+    }
+    return cursor.ok;
+}
+
+bool readWholeFile(const char* path, string& contents) {
+    ifstream in(path, ios::binary);
+    if (!in) return false;
+    contents.assign((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    return true;
+}
+
+bool loadCheckpoint() {
+    string contents;
+    if (!readWholeFile(CHECKPOINT_FILE, contents) || contents.size() < 20 || contents.compare(0, 4, "NAVC") != 0) {
+        return false;
+    }
+    string body = contents.substr(16, contents.size() - 20);
+    JournalCursor trailer = {&contents, contents.size() - 4, true};
+    if (journalChecksum(body.data(), body.size()) != (unsigned int)takeBytes(trailer, 4)) return false;
+
+    JournalCursor header = {&contents, 4, true};
+    if (takeBytes(header, 4) != JOURNAL_FORMAT) return false;
+    unsigned long long sequence = takeBytes(header, 8);
+
+    JournalCursor cursor = {&body, 0, true};
+    int count = takeInt(cursor);
+    if (!cursor.ok || count < 0 || count > MAX_LOCATIONS) return false;
+    vector<Location> loadedLocations(count);
+    for (int i = 0; i < count; i++) {
+        loadedLocations[i].id = takeInt(cursor);
+        loadedLocations[i].name = internName(takeText(cursor));
+        loadedLocations[i].latitude = takeDouble(cursor);
+        loadedLocations[i].longitude = takeDouble(cursor);
+    }
+    int loadedRoadCount = takeInt(cursor);
+    if (!cursor.ok || loadedRoadCount < 0 || loadedRoadCount > MAX_ROADS) return false;
+    vector<Road> loadedRoads(loadedRoadCount);
+    for (int i = 0; i < loadedRoadCount; i++) loadedRoads[i] = takeRoad(cursor);
+    if (!cursor.ok) return false;
+
+    for (int i = 0; i < count; i++) locations[i] = loadedLocations[i];
+    locationCount = count;
+    for (int i = 0; i < loadedRoadCount; i++) roads[i] = loadedRoads[i];
+    roadCount = loadedRoadCount;
+    checkpointSequence = sequence;
+    return true;
+}
+
+// Startup: load the latest checkpoint (the preloaded data stands in when
+// there is none), replay the journal tail, and reopen the journal for
+// appending. A torn or corrupt tail is truncated at the last intact record;
+// intact records that no longer apply are skipped. A journal that does not
+// extend the loaded state is never overwritten: saving stays off until it
+// is moved aside.
+void recoverFromJournal() {
+    TraceSpan span("journal recovery", "journal");
+    chrono::steady_clock::time_point started = chrono::steady_clock::now();
+    lastRecovery.checkpointLoaded = loadCheckpoint();
+
+    string contents;
+    size_t goodBytes = 0;
+    bool journalPresent = readWholeFile(JOURNAL_FILE, contents);
+    bool headerIntact = journalPresent && contents.size() >= JOURNAL_HEADER_BYTES && contents.compare(0, 4, "NAVJ") == 0;
+    unsigned long long journalSequence = 0;
+    if (headerIntact) {
+        JournalCursor header = {&contents, 4, true};
+        headerIntact = takeBytes(header, 4) == JOURNAL_FORMAT;
+        journalSequence = takeBytes(header, 8);
+    }
+    bool journalUsable = headerIntact && journalSequence == checkpointSequence;
+    // Safe to start afresh only when the old journal cannot hold a record
+    // the loaded state lacks
+    bool journalReplaceable = !journalPresent || contents.size() < JOURNAL_HEADER_BYTES ||
+                              (headerIntact && lastRecovery.checkpointLoaded && journalSequence < checkpointSequence);
+
+    if (journalUsable) {
+        JournalCursor cursor = {&contents, JOURNAL_HEADER_BYTES, true};
+        goodBytes = JOURNAL_HEADER_BYTES;
+        JournalReplay replay;
+        indexJournalReplay(replay);
+        while (cursor.position < contents.size()) {
+            size_t length = (size_t)takeBytes(cursor, 4);
+            if (!cursor.ok || length > JOURNAL_MAX_RECORD_BYTES || cursor.position + 1 + length + 4 > contents.size()) break;
+            string body = contents.substr(cursor.position, 1 + length);
+            cursor.position += 1 + length;
+            if ((unsigned int)takeBytes(cursor, 4) != journalChecksum(body.data(), body.size())) break;
+            if (replayJournalRecord(replay, (unsigned char)body[0], body.substr(1))) {
+                lastRecovery.recordsReplayed++;
+            } else {
+                lastRecovery.recordsSkipped++;
+            }
+            goodBytes = cursor.position;
+        }
+        compactJournalReplay(replay);
+        lastRecovery.tailTruncated = goodBytes < contents.size();
+
+        journal.file = fopen(JOURNAL_FILE, "r+b");
+        if (journal.file != nullptr && !truncateFile(journal.file, (long long)goodBytes)) {
+            fclose(journal.file);
+            journal.file = nullptr;
+        }
+        journal.fileBytes = goodBytes;
+        journal.recordsSinceCheckpoint = lastRecovery.recordsReplayed + lastRecovery.recordsSkipped;
+        journalWritable = true;
+    } else if (journalReplaceable) {
+        journal.file = createJournalFile(JOURNAL_FILE, checkpointSequence);
+        journal.fileBytes = JOURNAL_HEADER_BYTES;
+        journalWritable = true;
+    } else {
+        lastRecovery.journalKept = true;
+    }
+
+    markTopologyChanged();
+    rebuildSpatialIndex();
+    span.counter("records replayed", lastRecovery.recordsReplayed);
+    lastRecovery.milliseconds = chrono::duration<double, milli>(chrono::steady_clock::now() - started).count();
+}
+
+// Recovery itself stays silent for library callers; the console reports
+// a journal it could not open or had to leave alone
+void printRecoveryWarnings() {
+    if (lastRecovery.journalKept) {
+        cout << YELLOW << "[WARNING] " << JOURNAL_FILE << " does not match " << CHECKPOINT_FILE
+             << "; it was left untouched and edits will not be saved until it is moved aside.\n" << RESET;
+    } else if (journal.file == nullptr) {
+        cout << YELLOW << "[WARNING] Could not open " << JOURNAL_FILE << "; edits will not be saved.\n" << RESET;
+    }
+}
+
+// ============================================
+// LOCATION MANAGEMENT
+// ============================================
+
+void addLocation() {
+    if (locationCount >= MAX_LOCATIONS) {
+        cout << RED << "\n[ERROR] Maximum location limit reached!\n" << RESET;
+        return;
+    }
+
+    int id;
+    string name;
+
+    cout << "\nEnter Location ID: ";
+    if (!(cin >> id)) {
+        clearBuffer();
+        cout << RED << "[ERROR] Invalid ID input!\n" << RESET;
+        return;
+    }
+
+    // Check if ID already exists
+    for (int i = 0; i < locationCount; i++) {
+        if (locations[i].id == id) {
+            cout << RED << "[ERROR] Location ID already exists!\n" << RESET;
+            return;
+        }
+    }
+
+    clearBuffer();
+    cout << "Enter Location Name: ";
+    getline(cin, name);
+
+    if (name.empty()) {
+        cout << RED << "[ERROR] Location name cannot be empty!\n" << RESET;
+        return;
+    }
+
+    double latitude, longitude;
+    if (!readCoordinates(latitude, longitude)) {
+        return;
+    }
+
+    NavStatus status = navAddLocation(id, name.c_str(), latitude, longitude);
+    if (status == NAV_STORAGE_ERROR) {
+        printJournalError();
+        return;
+    }
+    if (status != NAV_OK) {
+        cout << RED << "[ERROR] Location could not be added!\n" << RESET;
+        return;
+    }
+
+    cout << GREEN << "[SUCCESS] Location added successfully!\n" << RESET;
+}
+
+void viewLocations() {
+    if (locationCount == 0) {
+        cout << YELLOW << "\n[INFO] No locations added yet.\n" << RESET;
+        return;
+    }
+
+    displaySection("ALL LOCATIONS");
+
+    renderText("| ");
+    renderCell("ID", 6);
+    renderText("| ");
+    renderCell("Location Name", 35);
+    renderText("| ");
+    renderCell("Latitude", 10);
+    renderText("| ");
+    renderCell("Longitude", 10);
+    renderText("|\n+-------+---------------------------------------+------------+------------+\n");
+
+    int rowsShown = 0;
+    for (int i = 0; i < locationCount; i++) {
+        renderText("| ");
+        renderText(YELLOW);
+        renderCell(locations[i].id, 6);
+        renderText(RESET);
+        renderText("| ");
+        renderCell(locations[i].name, 35);
+        renderText("| ");
+        renderCell(formatFixed(locations[i].latitude, 4), 10);
+        renderText("| ");
+        renderCell(formatFixed(locations[i].longitude, 4), 10);
+        renderText("|\n");
+        if (!endRenderRow(rowsShown)) break;
+    }
+    flushRender();
+    closeSectionBorder();
+}
+
+void deleteLocation() {
+    if (locationCount == 0) {
+        cout << YELLOW << "\n[INFO] No locations available to delete.\n" << RESET;
+        return;
+    }
+
+    viewLocations();
+
+    int id;
+    cout << "\nEnter Location ID to delete: ";
+    if (!(cin >> id)) {
+        clearBuffer();
+        cout << RED << "[ERROR] Invalid ID input!\n" << RESET;
+        return;
+    }
+
+    NavStatus status = navRemoveLocation(id);
+    if (status == NAV_STORAGE_ERROR) {
+        printJournalError();
+        return;
+    }
+    if (status != NAV_OK) {
+        cout << RED << "[ERROR] Location not found!\n" << RESET;
+        return;
+    }
+
+    cout << GREEN << "[SUCCESS] Location deleted successfully!\n" << RESET;
+}
+
+void sortLocationsByName() {
+    if (locationCount == 0) {
+        cout << YELLOW << "\n[INFO] No locations to sort.\n" << RESET;
+        return;
+    }
+
+    for (int i = 0; i < locationCount - 1; i++) {
+        int minIndex = i;
+        for (int j = i + 1; j < locationCount; j++) {
+            if (nameLess(locations[j].name, locations[minIndex].name)) {
+                minIndex = j;
+            }
+        }
+        if (minIndex != i) {
+            Location temp = locations[i];
+            locations[i] = locations[minIndex];
+            locations[minIndex] = temp;
+        }
+    }
+    markTopologyChanged();
+    journalLocationOrder();
+    if (!journalCommit()) {
+        printJournalError();
+        return;
+    }
+
+    cout << GREEN << "\n[SUCCESS] Locations sorted alphabetically!\n" << RESET;
+    viewLocations();
+}
+
+// ============================================
+// VEHICLE PROFILES (COST POLICIES)
+// ============================================
+
+// Each profile is a policy class of compile-time constants. The routing
+// kernels are templates over the policy, so the weight and cost formulas
+// are inlined into every instantiation; the active profile is chosen at
+// run time by one switch per graph build or estimate, never per road
+// relaxation. Changing the profile changes every road weight, so it goes
+// through markWeightsChanged() like any other weight edit.
+
+struct CarProfile {
+    static const char* name() { return "Car"; }
+    static double congestionFactor() { return 1.5; }   // Heavy Traffic weight multiplier
+    static double litresPerKm() { return 0.12; }
+    static double fuelPrice() { return 1.50; }          // $ per litre
+    static double tollFactor() { return 1.0; }
+    static int cruiseSpeed() { return 40; }             // km/h for whole-trip estimates
+    static int maxSpeed() { return 120; }               // caps road speed limits
+};
+
+struct MotorbikeProfile {
+    static const char* name() { return "Motorbike"; }
+    static double congestionFactor() { return 1.2; }    // filters through slow traffic
+    static double litresPerKm() { return 0.035; }
+    static double fuelPrice() { return 1.50; }
+    static double tollFactor() { return 0.5; }
+    static int cruiseSpeed() { return 45; }
+    static int maxSpeed() { return 100; }
+};
+
+struct TruckProfile {
+    static const char* name() { return "Truck"; }
+    static double congestionFactor() { return 1.8; }
+    static double litresPerKm() { return 0.30; }
+    static double fuelPrice() { return 1.60; }          // diesel
+    static double tollFactor() { return 2.5; }
+    static int cruiseSpeed() { return 30; }
+    static int maxSpeed() { return 70; }
+};
+
+struct BusProfile {
+    static const char* name() { return "Bus"; }
+    static double congestionFactor() { return 1.6; }
+    static double litresPerKm() { return 0.25; }
+    static double fuelPrice() { return 1.60; }
+    static double tollFactor() { return 2.0; }
+    static int cruiseSpeed() { return 30; }
+    static int maxSpeed() { return 80; }
+};
+
+enum VehicleProfileType {
+    VEHICLE_CAR, VEHICLE_MOTORBIKE, VEHICLE_TRUCK, VEHICLE_BUS,
+    VEHICLE_PROFILE_COUNT
+};
+
+int activeVehicleProfile = VEHICLE_CAR;
+
+struct TripEstimate {
+    double fuel;        // litres
+    double hours;
+    double fuelCost;    // $
+};
+
+// Weighted distance of a road for routing, or -1 if the road cannot be used
+template <class Profile>
+inline int profileTravelWeight(const Road& road) {
+    if (road.status == "Blocked" || !road.isAvailable) {
+        return -1;
+    }
+    double multiplier = (road.status == "Heavy Traffic") ? Profile::congestionFactor() : 1.0;
+    return (int)(road.distance * multiplier);
+}
+
+// Travel time in minutes at the road's speed limit (capped by the vehicle);
+// heavy traffic slows a road down by the same factor as its weight
+template <class Profile>
+inline double profileTravelMinutes(const Road& road) {
+    int weighted = profileTravelWeight<Profile>(road);
+    if (weighted < 0) {
+        return -1.0;
+    }
+    return weighted * 60.0 / min(road.speedLimit, Profile::maxSpeed());
+}
+
+// Fuel cost plus toll for one road; heavy traffic burns fuel as if the road
+// were longer
+template <class Profile>
+inline double profileRoadCost(const Road& road) {
+    int weighted = profileTravelWeight<Profile>(road);
+    if (weighted < 0) {
+        return -1.0;
+    }
+    return weighted * Profile::litresPerKm() * Profile::fuelPrice() + road.toll * Profile::tollFactor();
+}
+
+template <class Profile>
+TripEstimate profileTripEstimate(int weightedDistance) {
+    TripEstimate estimate;
+    estimate.fuel = weightedDistance * Profile::litresPerKm();
+    estimate.hours = (double)weightedDistance / Profile::cruiseSpeed();
+    estimate.fuelCost = estimate.fuel * Profile::fuelPrice();
+    return estimate;
+}
+
+const char* vehicleProfileName(int profile) {
+    switch (profile) {
+        case VEHICLE_MOTORBIKE: return MotorbikeProfile::name();
+        case VEHICLE_TRUCK: return TruckProfile::name();
+        case VEHICLE_BUS: return BusProfile::name();
+        default: return CarProfile::name();
+    }
+}
+
+double vehicleFuelPrice() {
+    switch (activeVehicleProfile) {
+        case VEHICLE_MOTORBIKE: return MotorbikeProfile::fuelPrice();
+        case VEHICLE_TRUCK: return TruckProfile::fuelPrice();
+        case VEHICLE_BUS: return BusProfile::fuelPrice();
+        default: return CarProfile::fuelPrice();
+    }
+}
+
+TripEstimate estimateTrip(int weightedDistance) {
+    switch (activeVehicleProfile) {
+        case VEHICLE_MOTORBIKE: return profileTripEstimate<MotorbikeProfile>(weightedDistance);
+        case VEHICLE_TRUCK: return profileTripEstimate<TruckProfile>(weightedDistance);
+        case VEHICLE_BUS: return profileTripEstimate<BusProfile>(weightedDistance);
+        default: return profileTripEstimate<CarProfile>(weightedDistance);
+    }
+}
+
+// Prints the cost estimate table for a route of the given weighted distance
+void printTripEstimateTable(int weightedDistance) {
+    TripEstimate estimate = estimateTrip(weightedDistance);
+    int hours = (int)estimate.hours;
+    int minutes = (int)((estimate.hours - hours) * 60);
+
+    cout << "+-------------------------------------------------+\n";
+    cout << "| " << left << setw(35) << "Detail" << "| " << right << setw(10) << "Value" << "|\n";
+    cout << "+-------------------------------------------------+\n";
+    cout << "| " << left << setw(35) << "Vehicle Profile"
+         << "| " << right << setw(10) << vehicleProfileName(activeVehicleProfile) << "|\n";
+    cout << "| " << left << setw(35) << "Total Distance (weighted)"
+         << "| " << YELLOW << right << setw(10) << (to_string(weightedDistance) + " km") << RESET << "|\n";
+    cout << "| " << left << setw(35) << "Fuel Required"
+         << "| " << GREEN << right << setw(10) << fixed << setprecision(2) << estimate.fuel << " L" << RESET << "|\n";
+    cout << "| " << left << setw(35) << "Estimated Time"
+         << "| " << CYAN << right << setw(10) << hours << "h " << minutes << "m" << RESET << "|\n";
+    cout << "| " << left << setw(35) << ("Fuel Cost ($" + formatFixed(vehicleFuelPrice(), 2) + "/L)")
+         << "| " << YELLOW << right << setw(10) << "$" << fixed << setprecision(2) << estimate.fuelCost << RESET << "|\n";
+    cout << "+-------------------------------------------------+\n";
+}
+
+void vehicleProfileMenu() {
+    displaySection("VEHICLE PROFILE");
+    for (int p = 0; p < VEHICLE_PROFILE_COUNT; p++) {
+        cout << (p + 1) << ". " << vehicleProfileName(p) << (p == activeVehicleProfile ? " (current)" : "") << "\n";
+    }
+    cout << "Enter choice: ";
+
+    int choice;
+    if (!(cin >> choice) || choice < 1 || choice > VEHICLE_PROFILE_COUNT) {
+        clearBuffer();
+        cout << RED << "[ERROR] Invalid choice!\n" << RESET;
+        return;
+    }
+    if (choice - 1 != activeVehicleProfile) {
+        activeVehicleProfile = choice - 1;
+        markWeightsChanged();
+    }
+    cout << GREEN << "[SUCCESS] Routing and cost estimates now use the "
+         << vehicleProfileName(activeVehicleProfile) << " profile!\n" << RESET;
+}
+
+// ============================================
+// ROAD MANAGEMENT
+// ============================================
+
+long long roadKey(int fromID, int toID) {
+    return ((long long)fromID << 32) | (unsigned int)toID;
+}
+
+void refreshRoadIndex() {
+    if (roadIndexVersion == topologyVersion) return;
+    roadIndexByKey.clear();
+    roadSlotsByOrigin.clear();
+    roadSlotsByDestination.clear();
+    for (int i = 0; i < roadCount; i++) {
+        roadIndexByKey.insert(make_pair(roadKey(roads[i].fromID, roads[i].toID), i));
+        roadSlotsByOrigin[roads[i].fromID].push_back(i);
+        roadSlotsByDestination[roads[i].toID].push_back(i);
+    }
+    roadIndexVersion = topologyVersion;
+}
+
+// Index of the road from fromID to toID in roads[], or -1 (O(1) via hash index)
+int findRoadIndex(int fromID, int toID) {
+    refreshRoadIndex();
+    unordered_map<long long, int>::const_iterator it = roadIndexByKey.find(roadKey(fromID, toID));
+    return it == roadIndexByKey.end() ? -1 : it->second;
+}
+
+bool roadExists(int fromID, int toID) {
+    return findRoadIndex(fromID, toID) != -1;
+}
+
+// Slots in roads[] of the roads leaving / entering a location ID
+const vector<int>& roadsFromLocation(int fromID) {
+    static const vector<int> none;
+    refreshRoadIndex();
+    unordered_map<int, vector<int>>::const_iterator it = roadSlotsByOrigin.find(fromID);
+    return it == roadSlotsByOrigin.end() ? none : it->second;
+}
+
+const vector<int>& roadsIntoLocation(int toID) {
+    static const vector<int> none;
+    refreshRoadIndex();
+    unordered_map<int, vector<int>>::const_iterator it = roadSlotsByDestination.find(toID);
+    return it == roadSlotsByDestination.end() ? none : it->second;
+}
+
+// An append moves no existing slot, so current ID indexes take the new entry
+// in place and the snapshot copies only the affected block, keeping single
+// edits cheap on large networks. Other caches still see a topology change.
+void markLocationAppended() {
+    int index = locationCount - 1;
+    bool locationIndexCurrent = locationIndexVersion == topologyVersion;
+    bool roadIndexCurrent = roadIndexVersion == topologyVersion;
+    topologyVersion++;
+    if (locationIndexCurrent) {
+        locationIndexByID.insert(make_pair(locations[index].id, index));
+        locationIndexVersion = topologyVersion;
+    }
+    if (roadIndexCurrent) roadIndexVersion = topologyVersion;
+
+    // Roads left over from a deleted location with this ID become usable again
+    vector<int> changed(1, index);
+    const vector<int>& incoming = roadsIntoLocation(locations[index].id);
+    for (size_t k = 0; k < incoming.size(); k++) changed.push_back(findLocationIndexByID(roads[incoming[k]].fromID));
+    publishGraphSnapshot(changed, true);
+}
+
+void markRoadAppended() {
+    int index = roadCount - 1;
+    bool locationIndexCurrent = locationIndexVersion == topologyVersion;
+    bool roadIndexCurrent = roadIndexVersion == topologyVersion;
+    topologyVersion++;
+    if (roadIndexCurrent) {
+        roadIndexByKey.insert(make_pair(roadKey(roads[index].fromID, roads[index].toID), index));
+        roadSlotsByOrigin[roads[index].fromID].push_back(index);
+        roadSlotsByDestination[roads[index].toID].push_back(index);
+        roadIndexVersion = topologyVersion;
+    }
+    if (locationIndexCurrent) locationIndexVersion = topologyVersion;
+    publishGraphSnapshot(vector<int>(1, findLocationIndexByID(roads[index].fromID)), true);
+}
+
+// Weighted distance, travel minutes and cost of a road for the active
+// vehicle profile (-1 if the road cannot be used). For one-off lookups;
+// graph builders instantiate the profile templates directly.
+int roadTravelWeight(const Road& road) {
+    switch (activeVehicleProfile) {
+        case VEHICLE_MOTORBIKE: return profileTravelWeight<MotorbikeProfile>(road);
+        case VEHICLE_TRUCK: return profileTravelWeight<TruckProfile>(road);
+        case VEHICLE_BUS: return profileTravelWeight<BusProfile>(road);
+        default: return profileTravelWeight<CarProfile>(road);
+    }
+}
+
+double roadTravelMinutes(const Road& road) {
+    switch (activeVehicleProfile) {
+        case VEHICLE_MOTORBIKE: return profileTravelMinutes<MotorbikeProfile>(road);
+        case VEHICLE_TRUCK: return profileTravelMinutes<TruckProfile>(road);
+        case VEHICLE_BUS: return profileTravelMinutes<BusProfile>(road);
+        default: return profileTravelMinutes<CarProfile>(road);
+    }
+}
+
+double roadTravelCost(const Road& road) {
+    switch (activeVehicleProfile) {
+        case VEHICLE_MOTORBIKE: return profileRoadCost<MotorbikeProfile>(road);
+        case VEHICLE_TRUCK: return profileRoadCost<TruckProfile>(road);
+        case VEHICLE_BUS: return profileRoadCost<BusProfile>(road);
+        default: return profileRoadCost<CarProfile>(road);
+    }
+}
+
+void addRoad() {
+    if (roadCount >= MAX_ROADS) {
+        cout << RED << "\n[ERROR] Maximum road limit reached!\n" << RESET;
+        return;
+    }
+
+    if (locationCount < 2) {
+        cout << YELLOW << "\n[INFO] Add at least 2 locations before adding roads.\n" << RESET;
+        return;
+    }
+
+    int fromID, toID, distance;
+    string status;
+    bool isOneWay;
+    bool isAvailable;
+
+    viewLocations();
+
+    cout << "\nEnter From Location ID: ";
+    if (!(cin >> fromID)) {
+        clearBuffer();
+        cout << RED << "[ERROR] Invalid input!\n" << RESET;
+        return;
+    }
+
+    cout << "Enter To Location ID: ";
+    if (!(cin >> toID)) {
+        clearBuffer();
+        cout << RED << "[ERROR] Invalid input!\n" << RESET;
+        return;
+    }
+
+    if (fromID == toID) {
+        cout << RED << "[ERROR] Cannot create a road from a location to itself!\n" << RESET;
+        return;
+    }
+
+    if (!locationExists(fromID) || !locationExists(toID)) {
+        cout << RED << "[ERROR] One or both locations do not exist!\n" << RESET;
+        return;
+    }
+
+    if (roadExists(fromID, toID)) {
+        cout << RED << "[ERROR] Road from " << fromID << " to " << toID << " already exists!\n" << RESET;
+        return;
+    }
+
+    cout << "Enter Distance (km): ";
+    if (!(cin >> distance) || distance <= 0) {
+        clearBuffer();
+        cout << RED << "[ERROR] Invalid distance!\n" << RESET;
+        return;
+    }
+
+    clearBuffer();
+    cout << "Enter Road Status (Normal/Heavy Traffic/Blocked): ";
+    getline(cin, status);
+
+    if (status != "Normal" && status != "Heavy Traffic" && status != "Blocked") {
+        cout << RED << "[ERROR] Invalid status! Use 'Normal', 'Heavy Traffic', or 'Blocked'.\n" << RESET;
+        return;
     }
 
     cout << "Is this a one-way road? (1 = Yes, 0 = No): ";
     int oneWayChoice;
     if (!(cin >> oneWayChoice) || (oneWayChoice != 0 && oneWayChoice != 1)) {
         clearBuffer();
-        cout << RED << "[ERROR] Invalid input! Using bidirectional (No) by default.\n" << RESET;
-        isOneWay = false;
+        cout << RED << "[ERROR] Invalid input! Using bidirectional (No) by default.\n" << RESET;
+        isOneWay = false;
+    } else {
+        isOneWay = (oneWayChoice == 1);
+    }
+
+    cout << "Is this road available (not under construction)? (1 = Yes, 0 = No): ";
+    int availableChoice;
+    if (!(cin >> availableChoice) || (availableChoice != 0 && availableChoice != 1)) {
+        clearBuffer();
+        cout << RED << "[ERROR] Invalid input! Using available (Yes) by default.\n" << RESET;
+        isAvailable = true;
+    } else {
+        isAvailable = (availableChoice == 1);
+    }
+
+    int speedLimit;
+    cout << "Enter Speed Limit (km/h): ";
+    if (!(cin >> speedLimit) || speedLimit <= 0) {
+        clearBuffer();
+        cout << RED << "[ERROR] Invalid input! Using " << DEFAULT_SPEED_LIMIT << " km/h by default.\n" << RESET;
+        speedLimit = DEFAULT_SPEED_LIMIT;
+    }
+
+    double toll;
+    cout << "Enter Toll ($, 0 if none): ";
+    if (!(cin >> toll) || toll < 0) {
+        clearBuffer();
+        cout << RED << "[ERROR] Invalid input! Using no toll by default.\n" << RESET;
+        toll = 0.0;
+    }
+
+    NavRoadSpec spec;
+    spec.fromID = fromID;
+    spec.toID = toID;
+    spec.distanceKm = distance;
+    spec.status = (status == "Normal") ? NAV_ROAD_NORMAL : (status == "Heavy Traffic") ? NAV_ROAD_HEAVY_TRAFFIC : NAV_ROAD_BLOCKED;
+    spec.oneWay = isOneWay;
+    spec.available = isAvailable;
+    spec.speedLimit = speedLimit;
+    spec.toll = toll;
+
+    int roadsAdded;
+    NavStatus result = navAddRoad(spec, &roadsAdded);
+    if (result == NAV_STORAGE_ERROR) {
+        printJournalError();
+    } else if (result != NAV_OK) {
+        cout << RED << "[ERROR] Road could not be added!\n" << RESET;
+    } else if (isOneWay) {
+        cout << GREEN << "[SUCCESS] One-way road added successfully!\n" << RESET;
+    } else if (roadsAdded == 2) {
+        cout << GREEN << "[SUCCESS] Bidirectional road added successfully!\n" << RESET;
+    } else {
+        cout << YELLOW << "[WARNING] Forward road added, but couldn't add reverse direction.\n" << RESET;
+    }
+}
+
+void viewRoads() {
+    if (roadCount == 0) {
+        cout << YELLOW << "\n[INFO] No roads added yet.\n" << RESET;
+        return;
+    }
+
+    displaySection("ALL ROADS");
+
+    renderText("| ");
+    renderCell("From", 6);
+    renderText("| ");
+    renderCell("To", 6);
+    renderText("| ");
+    renderCell("Distance", 10);
+    renderText("| ");
+    renderCell("Status", 17);
+    renderText("| ");
+    renderCell("Direction", 10);
+    renderText("| ");
+    renderCell("Available", 12);
+    renderText("| ");
+    renderCell("Speed", 9);
+    renderText("| ");
+    renderCell("Toll", 7);
+    renderText("|\n+-------+-------+------------+-------------------+------------+--------------+-----------+---------+\n");
+
+    int rowsShown = 0;
+    for (int i = 0; i < roadCount; i++) {
+        const Road& road = roads[i];
+        renderText("| ");
+        renderCell(road.fromID, 6);
+        renderText("| ");
+        renderCell(road.toID, 6);
+        renderText("| ");
+        renderText(YELLOW);
+        renderCell(to_string(road.distance) + " km", 10);
+        renderText(RESET);
+        renderText("| ");
+        renderText(roadStatusColor(road.status));
+        renderCell(road.status, 17);
+        renderText(RESET);
+        renderText("| ");
+        renderText(CYAN);
+        renderCell(road.isOneWay ? "One-Way" : "Both", 10);
+        renderText(RESET);
+        renderText("| ");
+        renderText(road.isAvailable ? GREEN : RED);
+        renderCell(road.isAvailable ? "Yes" : "No", 12);
+        renderText(RESET);
+        renderText("| ");
+        renderCell(to_string(road.speedLimit) + " km/h", 9);
+        renderText("| ");
+        renderCell(formatFixed(road.toll, 2), 7);
+        renderText("|\n");
+        if (!endRenderRow(rowsShown)) break;
+    }
+    flushRender();
+    closeSectionBorder();
+}
+
+void deleteRoad() {
+    if (roadCount == 0) {
+        cout << YELLOW << "\n[INFO] No roads available to delete.\n" << RESET;
+        return;
+    }
+
+    viewRoads();
+
+    int fromID, toID;
+    cout << "\nEnter From Location ID: ";
+    if (!(cin >> fromID)) {
+        clearBuffer();
+        cout << RED << "[ERROR] Invalid input!\n" << RESET;
+        return;
+    }
+
+    cout << "Enter To Location ID: ";
+    if (!(cin >> toID)) {
+        clearBuffer();
+        cout << RED << "[ERROR] Invalid input!\n" << RESET;
+        return;
+    }
+
+    NavStatus status = navRemoveRoad(fromID, toID);
+    if (status == NAV_STORAGE_ERROR) {
+        printJournalError();
+        return;
+    }
+    if (status != NAV_OK) {
+        cout << RED << "[ERROR] Road not found!\n" << RESET;
+        return;
+    }
+
+    cout << GREEN << "[SUCCESS] Road deleted successfully!\n" << RESET;
+}
+
+// ============================================
+// COMPRESSED GRAPH (DELTA + VARINT EDGES)
+// ============================================
+
+// Compact adjacency for networks too large to hold as GraphNode lists.
+// Every road between two existing locations is encoded, usable or not.
+// Each location's edges form one byte run, sorted by destination: the first
+// destination is stored as a zigzag delta from the source, the rest as the
+// gap to the previous destination, each followed by one varint holding the
+// road's distance shifted above four flag bits (status in bits 0-1, one-way
+// in bit 2, available in bit 3). Searches decode runs as they relax them and
+// turn distance and flags into the vehicle profile's weight, skipping
+// blocked and unavailable roads. In compressed graph mode the published
+// snapshots carry this instead of edge blocks.
+
+const int COMPRESSED_FLAG_BITS = 4;
+const unsigned int COMPRESSED_HEAVY_TRAFFIC = 1;
+const unsigned int COMPRESSED_BLOCKED = 2;
+const unsigned int COMPRESSED_ONE_WAY = 4;
+const unsigned int COMPRESSED_AVAILABLE = 8;
+
+struct CompressedGraph {
+    double congestionFactor;            // Heavy Traffic multiplier of the profile it was encoded for
+    int edgeCount;
+    vector<unsigned int> offset;        // byte run of location i is [offset[i], offset[i + 1])
+    vector<unsigned char> bytes;
+};
+
+bool compressedGraphMode = false;       // snapshots carry the compressed graph instead of edge blocks
+
+void putVarint(vector<unsigned char>& out, unsigned int value) {
+    while (value >= 0x80) {
+        out.push_back((unsigned char)(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((unsigned char)value);
+}
+
+inline unsigned int takeVarint(const unsigned char*& p) {
+    unsigned int value = *p & 0x7f;
+    for (int shift = 7; *p++ & 0x80; shift += 7) value |= (unsigned int)(*p & 0x7f) << shift;
+    return value;
+}
+
+unsigned int roadStatusBits(const string& status) {
+    if (status == "Heavy Traffic") return COMPRESSED_HEAVY_TRAFFIC;
+    if (status == "Blocked") return COMPRESSED_BLOCKED;
+    return 0;
+}
+
+// Inverse of roadStatusBits(), kept separate so the round-trip check tests it
+const char* compressedStatusName(unsigned int flags) {
+    switch (flags & 3) {
+        case COMPRESSED_HEAVY_TRAFFIC: return "Heavy Traffic";
+        case COMPRESSED_BLOCKED: return "Blocked";
+        default: return "Normal";
+    }
+}
+
+double activeCongestionFactor() {
+    switch (activeVehicleProfile) {
+        case VEHICLE_MOTORBIKE: return MotorbikeProfile::congestionFactor();
+        case VEHICLE_TRUCK: return TruckProfile::congestionFactor();
+        case VEHICLE_BUS: return BusProfile::congestionFactor();
+        default: return CarProfile::congestionFactor();
+    }
+}
+
+// Same result as roadTravelWeight() on the road the edge was encoded from
+inline int compressedEdgeWeight(const CompressedGraph& graph, int distance, unsigned int flags) {
+    if ((flags & 3) == COMPRESSED_BLOCKED || !(flags & COMPRESSED_AVAILABLE)) return -1;
+    double multiplier = (flags & 3) == COMPRESSED_HEAVY_TRAFFIC ? graph.congestionFactor : 1.0;
+    return (int)(distance * multiplier);
+}
+
+// Calls visit(destination, distance, flags) for each road leaving u
+template <typename Visit>
+inline void forEachCompressedEdge(const CompressedGraph& graph, int u, Visit visit) {
+    const unsigned char* p = graph.bytes.data() + graph.offset[u];
+    const unsigned char* end = graph.bytes.data() + graph.offset[u + 1];
+    if (p == end) return;
+    unsigned int first = takeVarint(p);
+    int v = u + (int)((first >> 1) ^ (0u - (first & 1)));
+    while (true) {
+        unsigned int packed = takeVarint(p);
+        visit(v, (int)(packed >> COMPRESSED_FLAG_BITS), packed & ((1u << COMPRESSED_FLAG_BITS) - 1));
+        if (p == end) break;
+        v += (int)takeVarint(p);
+    }
+}
+
+// Appends the run of location index u, found through the road index
+int encodeCompressedRun(vector<unsigned char>& out, int u) {
+    const vector<int>& outgoing = roadsFromLocation(locations[u].id);
+    vector<pair<int, unsigned int>> run;    // (destination, packed distance and flags)
+    for (size_t k = 0; k < outgoing.size(); k++) {
+        const Road& road = roads[outgoing[k]];
+        int toIndex = findLocationIndexByID(road.toID);
+        if (toIndex == -1) continue;
+        unsigned int flags = roadStatusBits(road.status) | (road.isOneWay ? COMPRESSED_ONE_WAY : 0) |
+                             (road.isAvailable ? COMPRESSED_AVAILABLE : 0);
+        run.push_back(make_pair(toIndex, ((unsigned int)road.distance << COMPRESSED_FLAG_BITS) | flags));
+    }
+    sort(run.begin(), run.end());
+
+    for (size_t e = 0; e < run.size(); e++) {
+        if (e == 0) {
+            int delta = run[e].first - u;
+            putVarint(out, (unsigned int)((delta << 1) ^ (delta >> 31)));
+        } else {
+            putVarint(out, (unsigned int)(run[e].first - run[e - 1].first));
+        }
+        putVarint(out, run[e].second);
+    }
+    return (int)run.size();
+}
+
+// Main thread only. Encodes the runs of the listed location indexes
+// (ascending) and copies each stretch of unchanged runs from previous in
+// one piece; with no previous graph every run is encoded.
+void encodeCompressedGraph(CompressedGraph& graph, const CompressedGraph* previous, const vector<int>& rebuild) {
+    TraceSpan span("compressed graph build", "preprocessing");
+    int reusable = previous == nullptr ? 0 : (int)previous->offset.size() - 1;
+    graph.congestionFactor = activeCongestionFactor();
+    graph.edgeCount = previous == nullptr ? 0 : previous->edgeCount;
+    graph.offset.assign(locationCount + 1, 0);
+    graph.bytes.clear();
+    if (previous != nullptr) graph.bytes.reserve(previous->bytes.size() + 64);
+
+    size_t next = 0;
+    int u = 0;
+    while (u < locationCount) {
+        int stop = min(reusable, next < rebuild.size() ? rebuild[next] : locationCount);
+        if (u < stop) {
+            long long shift = (long long)graph.bytes.size() - previous->offset[u];
+            for (int w = u; w < stop; w++) graph.offset[w] = (unsigned int)(previous->offset[w] + shift);
+            graph.bytes.insert(graph.bytes.end(), previous->bytes.begin() + previous->offset[u],
+                               previous->bytes.begin() + previous->offset[stop]);
+            u = stop;
+            continue;
+        }
+        graph.offset[u] = (unsigned int)graph.bytes.size();
+        if (u < reusable) forEachCompressedEdge(*previous, u, [&](int, int, unsigned int) { graph.edgeCount--; });
+        graph.edgeCount += encodeCompressedRun(graph.bytes, u);
+        if (next < rebuild.size() && rebuild[next] == u) next++;
+        u++;
+    }
+    graph.offset[locationCount] = (unsigned int)graph.bytes.size();
+    if (previous == nullptr) graph.bytes.shrink_to_fit();
+    span.counter("bytes", (long long)graph.bytes.size());
+}
+
+// Same contract as dijkstraFromIndex() on the forward graph; safe to run
+// from any thread
+void compressedDijkstra(const CompressedGraph& graph, int sourceIndex, vector<int>& dist, vector<int>& parent) {
+    TraceSpan span("dijkstra (compressed)");
+    int n = (int)graph.offset.size() - 1;
+    dist.assign(n, INF_DISTANCE);
+    parent.assign(n, -1);
+
+    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> pq;
+    dist[sourceIndex] = 0;
+    pq.push(make_pair(0, sourceIndex));
+    long long settled = 0;
+
+    while (!pq.empty()) {
+        int d = pq.top().first;
+        int u = pq.top().second;
+        pq.pop();
+        if (d > dist[u]) continue;
+        settled++;
+
+        forEachCompressedEdge(graph, u, [&](int v, int distance, unsigned int flags) {
+            int weight = compressedEdgeWeight(graph, distance, flags);
+            if (weight < 0) return;
+            int nd = d + weight;
+            if (nd < dist[v]) {
+                dist[v] = nd;
+                parent[v] = u;
+                pq.push(make_pair(nd, v));
+            }
+        });
+    }
+    span.counter("settled", settled);
+}
+
+// ============================================
+// GRAPH SNAPSHOTS (RCU)
+// ============================================
+
+// Route searches read the road graph through immutable, versioned snapshots
+// instead of the global arrays: the console route and service area queries,
+// the trip optimiser, navShortestPath()/navDistanceMatrix() and, from any
+// thread, navRouteDistance(). Writers (the main thread) edit roads[] as
+// before and then publish a new snapshot: outgoing roads are stored in one
+// block per location and blocks are grouped into fixed-size chunks. A
+// publication looks up the roads of the changed locations in the road index,
+// rebuilds just their blocks and copies just their chunks; every other chunk
+// is shared with the previous version. In compressed graph mode a snapshot
+// holds the compressed graph instead, re-encoding only the changed runs.
+//
+// The current snapshot is a plain atomic pointer. A reader registers with
+// the reader count of the current epoch, loads the pointer, takes its own
+// shared_ptr and leaves again: a few atomic operations and no lock, so
+// readers never wait on a writer or on each other. The writer parks each
+// replaced snapshot on a retired list and drops its reference only once the
+// epoch has moved on twice, which it does only when no reader that could
+// have loaded the old pointer is still registered. A reader keeps whichever
+// version it took for as long as it holds the shared_ptr.
+
+typedef vector<GraphNode> EdgeBlock;
+typedef vector<shared_ptr<const EdgeBlock>> EdgeBlockChunk;
+const int SNAPSHOT_CHUNK_SIZE = 128;        // edge blocks per chunk
+
+struct GraphSnapshot : enable_shared_from_this<GraphSnapshot> {
+    int version;                                // publication sequence number
+    int topologyVersion;
+    int weightVersion;
+    int locationCount;
+    shared_ptr<const vector<int>> locationIDs;  // by location index; shared while the topology is unchanged
+    shared_ptr<const unordered_map<int, int>> indexByID;
+    vector<shared_ptr<const EdgeBlockChunk>> chunks;    // usable outgoing roads, SNAPSHOT_CHUNK_SIZE locations each
+    shared_ptr<const CompressedGraph> compressed;       // set (and chunks empty) in compressed graph mode
+};
+
+atomic<const GraphSnapshot*> currentSnapshot(nullptr);
+atomic<unsigned> snapshotEpoch(0);
+atomic<int> snapshotReaders[2];             // readers inside acquireGraphSnapshot(), by epoch parity
+shared_ptr<const GraphSnapshot> publishedSnapshot;              // writer's reference to the current snapshot
+vector<shared_ptr<const GraphSnapshot>> retiredSnapshots[2];    // by the epoch parity they were replaced in
+int snapshotBlocksCopied = 0;       // by the most recent publication
+int snapshotBlocksShared = 0;
+
+// Usable outgoing roads of location index v; list snapshots only
+const EdgeBlock& snapshotBlock(const GraphSnapshot& snapshot, int v) {
+    return *(*snapshot.chunks[v / SNAPSHOT_CHUNK_SIZE])[v % SNAPSHOT_CHUNK_SIZE];
+}
+
+// For snapshots that are not published yet (scenario overlays): replaces one
+// block, copying the chunk that holds it
+void replaceSnapshotBlock(GraphSnapshot& snapshot, int v, const shared_ptr<const EdgeBlock>& block) {
+    shared_ptr<EdgeBlockChunk> chunk = make_shared<EdgeBlockChunk>(*snapshot.chunks[v / SNAPSHOT_CHUNK_SIZE]);
+    (*chunk)[v % SNAPSHOT_CHUNK_SIZE] = block;
+    snapshot.chunks[v / SNAPSHOT_CHUNK_SIZE] = chunk;
+}
+
+// Readers: lock-free, never waits on writers. Registering is retried only if
+// the writer advanced the epoch in between.
+shared_ptr<const GraphSnapshot> acquireGraphSnapshot() {
+    unsigned epoch = snapshotEpoch.load();
+    while (true) {
+        snapshotReaders[epoch & 1]++;
+        unsigned now = snapshotEpoch.load();
+        if (now == epoch) break;
+        snapshotReaders[epoch & 1]--;
+        epoch = now;
+    }
+    const GraphSnapshot* current = currentSnapshot.load();
+    shared_ptr<const GraphSnapshot> snapshot;
+    if (current != nullptr) snapshot = current->shared_from_this();
+    snapshotReaders[epoch & 1]--;
+    return snapshot;
+}
+
+// Writers only. The epoch advances when every reader registered in the
+// previous epoch has left; at that point nobody can still be reaching for a
+// snapshot retired before the current epoch began, so those are released.
+void reclaimGraphSnapshots() {
+    for (int step = 0; step < 2; step++) {
+        unsigned epoch = snapshotEpoch.load();
+        if (snapshotReaders[(epoch + 1) & 1].load() != 0) return;
+        retiredSnapshots[(epoch + 1) & 1].clear();
+        snapshotEpoch.store(epoch + 1);
+    }
+}
+
+// Writers only. Rebuilds the blocks of the changed locations (every block
+// when the list is empty or locations/roads were added or removed, unless
+// appended says the one change since the previous snapshot was an append)
+// and publishes the result as the new current snapshot. A partial rebuild
+// costs the changed locations' roads plus one pointer per chunk. Nothing is
+// published while snapshotPauseDepth is raised; the caller publishes in
+// full after.
+void publishGraphSnapshot(const vector<int>& changedLocations, bool appended) {
+    if (snapshotPauseDepth > 0) return;
+    TraceSpan span("snapshot publish", "preprocessing");
+    shared_ptr<const GraphSnapshot> previous = publishedSnapshot;
+    bool appendOnly = appended && previous && previous->topologyVersion == topologyVersion - 1 &&
+                      previous->locationCount <= locationCount;
+    bool rebuildAll = changedLocations.empty() || !previous || (previous->compressed != nullptr) != compressedGraphMode ||
+                      (previous->topologyVersion != topologyVersion && !appendOnly);
+
+    // Location indexes whose blocks are rebuilt, ascending
+    vector<int> rebuild;
+    for (int v = rebuildAll ? 0 : previous->locationCount; v < locationCount; v++) rebuild.push_back(v);
+    if (!rebuildAll) {
+        for (size_t i = 0; i < changedLocations.size(); i++) {
+            if (changedLocations[i] >= 0 && changedLocations[i] < locationCount) rebuild.push_back(changedLocations[i]);
+        }
+        sort(rebuild.begin(), rebuild.end());
+        rebuild.erase(unique(rebuild.begin(), rebuild.end()), rebuild.end());
+    }
+
+    shared_ptr<GraphSnapshot> next = make_shared<GraphSnapshot>();
+    next->version = previous ? previous->version + 1 : 1;
+    next->topologyVersion = topologyVersion;
+    next->weightVersion = weightVersion;
+    next->locationCount = locationCount;
+    if (compressedGraphMode) {
+        shared_ptr<CompressedGraph> compressed = make_shared<CompressedGraph>();
+        encodeCompressedGraph(*compressed, rebuildAll ? nullptr : previous->compressed.get(), rebuild);
+        next->compressed = compressed;
+    } else {
+        if (!rebuildAll) next->chunks = previous->chunks;
+        next->chunks.resize((locationCount + SNAPSHOT_CHUNK_SIZE - 1) / SNAPSHOT_CHUNK_SIZE);
+    }
+
+    shared_ptr<EdgeBlockChunk> chunk;
+    int chunkIndex = -1;
+    for (size_t i = 0; i < rebuild.size() && !compressedGraphMode; i++) {
+        int v = rebuild[i];
+        if (v / SNAPSHOT_CHUNK_SIZE != chunkIndex) {
+            if (chunk) next->chunks[chunkIndex] = chunk;
+            chunkIndex = v / SNAPSHOT_CHUNK_SIZE;
+            const shared_ptr<const EdgeBlockChunk>& shared = next->chunks[chunkIndex];
+            chunk = shared ? make_shared<EdgeBlockChunk>(*shared) : make_shared<EdgeBlockChunk>();
+            chunk->resize(min(SNAPSHOT_CHUNK_SIZE, locationCount - chunkIndex * SNAPSHOT_CHUNK_SIZE));
+        }
+
+        EdgeBlock block;
+        const vector<int>& outgoing = roadsFromLocation(locations[v].id);
+        for (size_t k = 0; k < outgoing.size(); k++) {
+            const Road& road = roads[outgoing[k]];
+            int weight = roadTravelWeight(road);
+            int toIndex = findLocationIndexByID(road.toID);
+            if (weight < 0 || toIndex == -1) continue;
+
+            GraphNode edge;
+            edge.destination = toIndex;
+            edge.distance = weight;
+            edge.roadIndex = outgoing[k];
+            block.push_back(edge);
+        }
+        (*chunk)[v % SNAPSHOT_CHUNK_SIZE] = make_shared<const EdgeBlock>(move(block));
+    }
+    if (chunk) next->chunks[chunkIndex] = chunk;
+    snapshotBlocksCopied = (int)rebuild.size();
+    snapshotBlocksShared = locationCount - snapshotBlocksCopied;
+
+    if (previous && (previous->topologyVersion == topologyVersion || appendOnly) &&
+        previous->locationCount == locationCount) {
+        next->locationIDs = previous->locationIDs;
+        next->indexByID = previous->indexByID;
+    } else if (appendOnly) {
+        shared_ptr<vector<int>> locationIDs = make_shared<vector<int>>(*previous->locationIDs);
+        shared_ptr<unordered_map<int, int>> indexByID = make_shared<unordered_map<int, int>>(*previous->indexByID);
+        for (int v = previous->locationCount; v < locationCount; v++) {
+            locationIDs->push_back(locations[v].id);
+            indexByID->insert(make_pair(locations[v].id, v));
+        }
+        next->locationIDs = locationIDs;
+        next->indexByID = indexByID;
+    } else {
+        shared_ptr<vector<int>> locationIDs = make_shared<vector<int>>(locationCount);
+        shared_ptr<unordered_map<int, int>> indexByID = make_shared<unordered_map<int, int>>();
+        for (int v = 0; v < locationCount; v++) {
+            (*locationIDs)[v] = locations[v].id;
+            indexByID->insert(make_pair(locations[v].id, v));
+        }
+        next->locationIDs = locationIDs;
+        next->indexByID = indexByID;
+    }
+
+    currentSnapshot.store(next.get());
+    if (previous) retiredSnapshots[snapshotEpoch.load() & 1].push_back(previous);
+    publishedSnapshot = next;
+    reclaimGraphSnapshots();
+    span.counter("blocks copied", snapshotBlocksCopied);
+}
+
+// Dijkstra over a snapshot, with the same contract as dijkstraFromIndex() on
+// the forward graph; safe to run from any thread
+void snapshotDijkstra(const GraphSnapshot& snapshot, int sourceIndex, vector<int>& dist, vector<int>& parent) {
+    if (snapshot.compressed) {
+        compressedDijkstra(*snapshot.compressed, sourceIndex, dist, parent);
+        return;
+    }
+    int n = snapshot.locationCount;
+    dist.assign(n, INF_DISTANCE);
+    parent.assign(n, -1);
+
+    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> pq;
+    dist[sourceIndex] = 0;
+    pq.push(make_pair(0, sourceIndex));
+
+    while (!pq.empty()) {
+        int d = pq.top().first;
+        int u = pq.top().second;
+        pq.pop();
+        if (d > dist[u]) continue;
+
+        const EdgeBlock& block = snapshotBlock(snapshot, u);
+        for (size_t j = 0; j < block.size(); j++) {
+            int v = block[j].destination;
+            int nd = d + block[j].distance;
+            if (nd < dist[v]) {
+                dist[v] = nd;
+                parent[v] = u;
+                pq.push(make_pair(nd, v));
+            }
+        }
+    }
+}
+
+void snapshotDijkstra(const GraphSnapshot& snapshot, int sourceIndex, vector<int>& dist) {
+    vector<int> parent;
+    snapshotDijkstra(snapshot, sourceIndex, dist, parent);
+}
+
+// Index of a location in the snapshot, or -1
+int snapshotLocationIndex(const GraphSnapshot& snapshot, int id) {
+    unordered_map<int, int>::const_iterator found = snapshot.indexByID->find(id);
+    return found == snapshot.indexByID->end() ? -1 : found->second;
+}
+
+// Edge blocks for a snapshot: a list snapshot as it is, a compressed one
+// decoded into a private copy. Main thread only (road indexes come from the
+// hash index); for consumers that walk blocks rather than search.
+shared_ptr<const GraphSnapshot> expandGraphSnapshot(const shared_ptr<const GraphSnapshot>& snapshot) {
+    if (!snapshot->compressed) return snapshot;
+    const CompressedGraph& graph = *snapshot->compressed;
+    const vector<int>& ids = *snapshot->locationIDs;
+    shared_ptr<GraphSnapshot> expanded = make_shared<GraphSnapshot>(*snapshot);
+    expanded->compressed.reset();
+    expanded->chunks.assign((snapshot->locationCount + SNAPSHOT_CHUNK_SIZE - 1) / SNAPSHOT_CHUNK_SIZE,
+                            shared_ptr<const EdgeBlockChunk>());
+    for (int c = 0; c < (int)expanded->chunks.size(); c++) {
+        shared_ptr<EdgeBlockChunk> chunk = make_shared<EdgeBlockChunk>();
+        for (int u = c * SNAPSHOT_CHUNK_SIZE; u < min(snapshot->locationCount, (c + 1) * SNAPSHOT_CHUNK_SIZE); u++) {
+            EdgeBlock block;
+            forEachCompressedEdge(graph, u, [&](int v, int distance, unsigned int flags) {
+                int weight = compressedEdgeWeight(graph, distance, flags);
+                if (weight < 0) return;
+                GraphNode edge;
+                edge.destination = v;
+                edge.distance = weight;
+                edge.roadIndex = findRoadIndex(ids[u], ids[v]);
+                block.push_back(edge);
+            });
+            chunk->push_back(make_shared<const EdgeBlock>(move(block)));
+        }
+        expanded->chunks[c] = chunk;
+    }
+    return expanded;
+}
+
+// Adjacency lists in both directions copied out of a list snapshot, for the
+// searches that need a reverse graph
+void snapshotGraphs(const GraphSnapshot& snapshot, vector<vector<GraphNode>>& forwardGraph,
+                    vector<vector<GraphNode>>& reverseGraph) {
+    int n = snapshot.locationCount;
+    forwardGraph.assign(n, vector<GraphNode>());
+    reverseGraph.assign(n, vector<GraphNode>());
+    for (int u = 0; u < n; u++) {
+        const EdgeBlock& block = snapshotBlock(snapshot, u);
+        forwardGraph[u] = block;
+        for (size_t j = 0; j < block.size(); j++) {
+            GraphNode reverseEdge = block[j];
+            reverseEdge.destination = u;
+            reverseGraph[block[j].destination].push_back(reverseEdge);
+        }
+    }
+}
+
+// ============================================
+// BATCH ROAD UPDATES (TRAFFIC FEED)
+// ============================================
+
+struct RoadUpdate {
+    int fromID;
+    int toID;
+    string status;      // "" keeps the current status
+    int availability;   // 1 = available, 0 = unavailable, -1 = keep
+};
+
+struct RoadUpdateReport {
+    int applied;
+    int notFound;
+    int invalid;
+    bool saved;         // false when the applied updates could not be journaled
+};
+
+bool isValidRoadStatus(const string& status) {
+    return status == "Normal" || status == "Heavy Traffic" || status == "Blocked";
+}
+
+// Applies a batch of status/availability changes. Each road is found through
+// the hash index and the reverse direction of a bidirectional road is updated
+// with it. Derived data is invalidated, and the journal committed, once for
+// the whole batch.
+RoadUpdateReport applyRoadUpdates(const vector<RoadUpdate>& updates) {
+    TraceSpan span("apply road updates", "traffic");
+    span.counter("updates", (long long)updates.size());
+    RoadUpdateReport report = {0, 0, 0, true};
+    vector<int> changedLocations;
+
+    for (size_t u = 0; u < updates.size(); u++) {
+        const RoadUpdate& update = updates[u];
+        if (!update.status.empty() && !isValidRoadStatus(update.status)) {
+            report.invalid++;
+            continue;
+        }
+
+        int roadIndex = findRoadIndex(update.fromID, update.toID);
+        if (roadIndex == -1) {
+            report.notFound++;
+            continue;
+        }
+
+        int reverseIndex = roads[roadIndex].isOneWay ? -1 : findRoadIndex(update.toID, update.fromID);
+        for (int k = 0; k < 2; k++) {
+            int index = (k == 0) ? roadIndex : reverseIndex;
+            if (index == -1) continue;
+
+            if (!update.status.empty()) {
+                roads[index].status = update.status;
+            }
+            if (update.availability != -1) {
+                roads[index].isAvailable = (update.availability == 1);
+            }
+            changedLocations.push_back(findLocationIndexByID(roads[index].fromID));
+            journalRoadState(roads[index]);
+        }
+        report.applied++;
+    }
+
+    if (report.applied > 0) {
+        markWeightsChanged(changedLocations);
+        report.saved = journalCommit();
+    }
+    span.counter("applied", report.applied);
+    return report;
+}
+
+// Parses one feed line: from,to,status,availability
+// status is Normal / Heavy Traffic / Blocked and availability is 1 or 0;
+// either may be "-" to keep the current value.
+bool parseRoadUpdateLine(const string& line, RoadUpdate& update) {
+    stringstream fields(line);
+    string fromText, toText, statusText, availabilityText;
+    if (!getline(fields, fromText, ',') || !getline(fields, toText, ',') ||
+        !getline(fields, statusText, ',') || !getline(fields, availabilityText)) {
+        return false;
+    }
+
+    char* end = nullptr;
+    update.fromID = (int)strtol(fromText.c_str(), &end, 10);
+    if (end == fromText.c_str()) return false;
+    update.toID = (int)strtol(toText.c_str(), &end, 10);
+    if (end == toText.c_str()) return false;
+
+    size_t first = statusText.find_first_not_of(' ');
+    size_t last = statusText.find_last_not_of(" \r");
+    statusText = (first == string::npos) ? "" : statusText.substr(first, last - first + 1);
+    update.status = (statusText == "-") ? "" : statusText;
+
+    availabilityText.erase(remove(availabilityText.begin(), availabilityText.end(), ' '), availabilityText.end());
+    availabilityText.erase(remove(availabilityText.begin(), availabilityText.end(), '\r'), availabilityText.end());
+    if (availabilityText == "-") update.availability = -1;
+    else if (availabilityText == "1") update.availability = 1;
+    else if (availabilityText == "0") update.availability = 0;
+    else return false;
+
+    return true;
+}
+
+// Reads feed lines until end of stream or a line reading END.
+// Blank lines and lines starting with # are skipped.
+void readRoadUpdates(istream& in, vector<RoadUpdate>& updates, int& badLines) {
+    string line;
+    while (getline(in, line)) {
+        if (!line.empty() && line[line.size() - 1] == '\r') line.erase(line.size() - 1);
+        if (line == "END") break;
+        if (line.empty() || line[0] == '#') continue;
+
+        RoadUpdate update;
+        if (parseRoadUpdateLine(line, update)) {
+            updates.push_back(update);
+        } else {
+            badLines++;
+        }
+    }
+}
+
+void importTrafficFeed() {
+    cout << "\nFeed format, one change per line: from,to,status,availability\n";
+    cout << "  e.g. 1,2,Heavy Traffic,1   or   3,4,-,0   ('-' keeps the current value)\n";
+    cout << "Enter feed file path (or - to type lines, finishing with END): ";
+
+    string path;
+    cin >> path;
+    clearBuffer();
+
+    vector<RoadUpdate> updates;
+    int badLines = 0;
+    if (path == "-") {
+        readRoadUpdates(cin, updates, badLines);
+    } else {
+        ifstream feed(path.c_str());
+        if (!feed) {
+            cout << RED << "[ERROR] Could not open " << path << "!\n" << RESET;
+            return;
+        }
+        TraceSpan span("parse traffic feed", "traffic");
+        readRoadUpdates(feed, updates, badLines);
+        span.counter("updates", (long long)updates.size());
+        span.counter("bad lines", badLines);
+    }
+
+    chrono::steady_clock::time_point started = chrono::steady_clock::now();
+    RoadUpdateReport report = applyRoadUpdates(updates);
+    double elapsedMs = chrono::duration<double, milli>(chrono::steady_clock::now() - started).count();
+
+    if (!report.saved) {
+        printJournalError();
+    } else {
+        cout << GREEN << "[SUCCESS] Applied " << report.applied << " of " << updates.size()
+             << " road updates in " << fixed << setprecision(3) << elapsedMs << " ms.\n" << RESET;
+    }
+    if (report.notFound > 0) {
+        cout << YELLOW << "[WARNING] " << report.notFound << " update(s) referred to roads that do not exist.\n" << RESET;
+    }
+    if (report.invalid > 0 || badLines > 0) {
+        cout << YELLOW << "[WARNING] " << (report.invalid + badLines) << " line(s) were malformed or had an invalid status.\n" << RESET;
+    }
+}
+
+void updateRoadDistance() {
+    if (roadCount == 0) {
+        cout << YELLOW << "\n[INFO] No roads available.\n" << RESET;
+        return;
+    }
+
+    viewRoads();
+
+    int fromID, toID, newDistance;
+    cout << "\nEnter From Location ID: ";
+    if (!(cin >> fromID)) {
+        clearBuffer();
+        cout << RED << "[ERROR] Invalid input!\n" << RESET;
+        return;
+    }
+
+    cout << "Enter To Location ID: ";
+    if (!(cin >> toID)) {
+        clearBuffer();
+        cout << RED << "[ERROR] Invalid input!\n" << RESET;
+        return;
+    }
+
+    cout << "Enter new distance (km): ";
+    if (!(cin >> newDistance) || newDistance <= 0) {
+        clearBuffer();
+        cout << RED << "[ERROR] Distance must be positive!\n" << RESET;
+        return;
+    }
+
+    NavStatus status = navSetRoadDistance(fromID, toID, newDistance);
+
+    if (status == NAV_STORAGE_ERROR) {
+        printJournalError();
+    } else if (status == NAV_OK) {
+        cout << GREEN << "[SUCCESS] Distance updated!\n" << RESET;
+    } else {
+        cout << RED << "[ERROR] Road not found!\n" << RESET;
+    }
+}
+
+void updateRoadStatus() {
+    if (roadCount == 0) {
+        cout << YELLOW << "\n[INFO] No roads available.\n" << RESET;
+        return;
+    }
+
+    viewRoads();
+
+    int fromID, toID;
+    string newStatus;
+
+    cout << "\nEnter From Location ID: ";
+    if (!(cin >> fromID)) {
+        clearBuffer();
+        cout << RED << "[ERROR] Invalid input!\n" << RESET;
+        return;
+    }
+
+    cout << "Enter To Location ID: ";
+    if (!(cin >> toID)) {
+        clearBuffer();
+        cout << RED << "[ERROR] Invalid input!\n" << RESET;
+        return;
+    }
+
+    clearBuffer();
+    cout << "Enter New Status (Normal/Heavy Traffic/Blocked): ";
+    getline(cin, newStatus);
+
+    if (newStatus != "Normal" && newStatus != "Heavy Traffic" && newStatus != "Blocked") {
+        cout << RED << "[ERROR] Invalid status!\n" << RESET;
+        return;
+    }
+
+    RoadUpdate update = {fromID, toID, newStatus, -1};
+    RoadUpdateReport report = applyRoadUpdates(vector<RoadUpdate>(1, update));
+
+    if (!report.saved) {
+        printJournalError();
+    } else if (report.applied == 1) {
+        cout << GREEN << "[SUCCESS] Road status updated!\n" << RESET;
+    } else {
+        cout << RED << "[ERROR] Road not found!\n" << RESET;
+    }
+}
+
+void toggleRoadAvailability() {
+    if (roadCount == 0) {
+        cout << YELLOW << "\n[INFO] No roads available.\n" << RESET;
+        return;
+    }
+
+    viewRoads();
+
+    int fromID, toID;
+    cout << "\nEnter From Location ID: ";
+    if (!(cin >> fromID)) {
+        clearBuffer();
+        cout << RED << "[ERROR] Invalid input!\n" << RESET;
+        return;
+    }
+
+    cout << "Enter To Location ID: ";
+    if (!(cin >> toID)) {
+        clearBuffer();
+        cout << RED << "[ERROR] Invalid input!\n" << RESET;
+        return;
+    }
+
+    int roadIndex = findRoadIndex(fromID, toID);
+    bool found = (roadIndex != -1);
+    if (found) {
+        // The reverse direction of a bidirectional road follows automatically
+        RoadUpdate update = {fromID, toID, "", roads[roadIndex].isAvailable ? 0 : 1};
+        if (!applyRoadUpdates(vector<RoadUpdate>(1, update)).saved) {
+            printJournalError();
+            return;
+        }
+
+        string status = roads[roadIndex].isAvailable ? "available" : "unavailable (under construction)";
+        cout << GREEN << "[SUCCESS] Road is now " << status << "!\n" << RESET;
+    }
+
+    if (!found) {
+        cout << RED << "[ERROR] Road not found!\n" << RESET;
+    }
+}
+
+// ============================================
+// MANUAL ROUTE BUILDER (STACK)
+// ============================================
+
+struct RouteTotals {
+    int distance;           // physical km
+    int weightedDistance;   // km including traffic delays
+    double fuel;            // litres
+    double minutes;
+    int unusableHops;       // blocked or unavailable roads on the path
+};
+
+RouteTotals emptyRouteTotals() {
+    RouteTotals totals = {0, 0, 0.0, 0.0, 0};
+    return totals;
+}
+
+// Adds one road to running route totals. Roads that cannot be used right now
+// are costed at their plain distance and counted so the caller can warn.
+void addRoadToTotals(const Road& road, RouteTotals& totals) {
+    int weighted = roadTravelWeight(road);
+    double minutes = roadTravelMinutes(road);
+    if (weighted < 0) {
+        totals.unusableHops++;
+        weighted = road.distance;
+        minutes = road.distance * 60.0 / road.speedLimit;
+    }
+    totals.distance += road.distance;
+    totals.weightedDistance += weighted;
+    totals.fuel += estimateTrip(weighted).fuel;
+    totals.minutes += minutes;
+}
+
+// Checks that every consecutive pair of IDs is joined by a road and costs the
+// path in the same pass, using O(1) hash lookups per hop. Returns -1 for a
+// valid path, otherwise the position of the first ID that is unknown or
+// cannot be reached from the previous one.
+int validateAndCostPath(const vector<int>& locationIDs, RouteTotals& totals) {
+    totals = emptyRouteTotals();
+    for (size_t i = 0; i < locationIDs.size(); i++) {
+        if (findLocationIndexByID(locationIDs[i]) == -1) {
+            return (int)i;
+        }
+        if (i == 0) continue;
+
+        int roadIndex = findRoadIndex(locationIDs[i - 1], locationIDs[i]);
+        if (roadIndex == -1) {
+            return (int)i;
+        }
+        addRoadToTotals(roads[roadIndex], totals);
+    }
+    return -1;
+}
+
+void printRouteTotals(const RouteTotals& totals) {
+    int totalMinutes = (int)(totals.minutes + 0.5);
+    cout << CYAN << "Totals: " << RESET << totals.distance << " km"
+         << " (weighted " << YELLOW << totals.weightedDistance << " km" << RESET << ")"
+         << ", fuel " << GREEN << fixed << setprecision(2) << totals.fuel << " L" << RESET
+         << ", time " << CYAN << totalMinutes / 60 << "h " << totalMinutes % 60 << "m" << RESET << "\n";
+    if (totals.unusableHops > 0) {
+        cout << YELLOW << "[WARNING] " << totals.unusableHops
+             << " road(s) on this path are blocked or unavailable.\n" << RESET;
+    }
+}
+
+void manualRouteBuilder() {
+    // A vector used as the stack: back() is the top and front-to-back is the
+    // travel order. routeTotals[k] holds the running totals up to routeStack[k],
+    // so push and pop update the totals in O(1).
+    vector<int> routeStack;
+    vector<RouteTotals> routeTotals;
+
+    cout << "\n--- Manual Route Builder (using Stack) ---\n";
+    cout << "You can push locations to create your custom path.\n";
+
+    while (true) {
+        cout << "\nCurrent Path: ";
+        if (routeStack.empty()) {
+            cout << "(empty)\n";
+        } else {
+            for (size_t i = 0; i < routeStack.size(); i++) {
+                if (i > 0) cout << " -> ";
+                cout << routeStack[i];
+            }
+            cout << "\n";
+            printRouteTotals(routeTotals.back());
+        }
+        cout << "\n1. Push Location\n";
+        cout << "2. Pop Location\n";
+        cout << "3. View Current Path\n";
+        cout << "4. Save Path to History\n";
+        cout << "5. Validate & Cost a Typed Path\n";
+        cout << "6. Exit Manual Builder\n";
+        cout << "Enter choice: ";
+
+        int choice;
+        if (!(cin >> choice)) {
+            clearBuffer();
+            cout << RED << "[ERROR] Invalid input!\n" << RESET;
+            continue;
+        }
+
+        if (choice == 1) {
+            cout << "Enter Location ID to push: ";
+            int id;
+            if (!(cin >> id)) {
+                clearBuffer();
+                cout << RED << "[ERROR] Invalid input!\n" << RESET;
+                continue;
+            }
+
+            if (!locationExists(id)) {
+                cout << RED << "[ERROR] Location not found!\n" << RESET;
+                continue;
+            }
+
+            RouteTotals totals = emptyRouteTotals();
+
+            // Check if road exists from current top location to new location
+            if (!routeStack.empty()) {
+                int currentTop = routeStack.back();
+                int roadIndex = findRoadIndex(currentTop, id);
+                if (roadIndex == -1) {
+                    NameRef fromName = findLocationNameByID(currentTop);
+                    NameRef toName = findLocationNameByID(id);
+                    cout << RED << "[ERROR] No road exists from " << fromName
+                         << " (ID: " << currentTop << ") to " << toName
+                         << " (ID: " << id << ")!\n" << RESET;
+                    cout << YELLOW << "[INFO] Please add a road between these locations first using 'Manage Roads'.\n" << RESET;
+                    continue;
+                }
+
+                totals = routeTotals.back();
+                addRoadToTotals(roads[roadIndex], totals);
+            }
+
+            routeStack.push_back(id);
+            routeTotals.push_back(totals);
+            cout << GREEN << "[SUCCESS] Location " << id << " pushed!\n" << RESET;
+        } else if (choice == 2) {
+            if (!routeStack.empty()) {
+                cout << GREEN << "[SUCCESS] Popped: " << routeStack.back() << "\n" << RESET;
+                routeStack.pop_back();
+                routeTotals.pop_back();
+            } else {
+                cout << YELLOW << "[INFO] Stack is empty!\n" << RESET;
+            }
+        } else if (choice == 3) {
+            cout << "\n--- Current Stack (Top to Bottom) ---\n";
+            if (routeStack.empty()) {
+                cout << "(empty)\n";
+            } else {
+                int count = 1;
+                for (int i = (int)routeStack.size() - 1; i >= 0; i--) {
+                    cout << count << ". Location ID: " << routeStack[i] << "\n";
+                    count++;
+                }
+            }
+        } else if (choice == 4) {
+            if (routeStack.empty()) {
+                cout << RED << "[ERROR] Path is empty!\n" << RESET;
+            } else {
+                vector<NameRef> hops(routeStack.size());
+                for (size_t i = 0; i < routeStack.size(); i++) hops[i] = findLocationNameByID(routeStack[i]);
+                saveRouteToHistory(hops, " (end)");
+
+                cout << GREEN << "[SUCCESS] Path saved to history!\n" << RESET;
+                renderText("Path: ");
+                renderText(YELLOW);
+                renderRouteHops(hops);
+                renderText(" (end)");
+                renderText(RESET);
+                renderText("\n");
+                flushRender();
+            }
+        } else if (choice == 5) {
+            cout << "Enter number of locations on the path: ";
+            int hopCount;
+            if (!(cin >> hopCount) || hopCount < 2) {
+                clearBuffer();
+                cout << RED << "[ERROR] A path needs at least 2 locations!\n" << RESET;
+                continue;
+            }
+
+            cout << "Enter the Location IDs in travel order: ";
+            vector<int> typedPath(hopCount);
+            bool readOk = true;
+            for (int i = 0; i < hopCount && readOk; i++) {
+                readOk = (bool)(cin >> typedPath[i]);
+            }
+            if (!readOk) {
+                clearBuffer();
+                cout << RED << "[ERROR] Invalid input!\n" << RESET;
+                continue;
+            }
+
+            RouteTotals totals;
+            chrono::steady_clock::time_point started = chrono::steady_clock::now();
+            int badHop = validateAndCostPath(typedPath, totals);
+            double elapsedUs = chrono::duration<double, micro>(chrono::steady_clock::now() - started).count();
+
+            if (badHop != -1) {
+                if (badHop == 0 || !locationExists(typedPath[badHop])) {
+                    cout << RED << "[ERROR] Location " << typedPath[badHop] << " (position "
+                         << (badHop + 1) << ") not found!\n" << RESET;
+                } else {
+                    cout << RED << "[ERROR] No road from " << typedPath[badHop - 1] << " to "
+                         << typedPath[badHop] << " (hop " << badHop << ")!\n" << RESET;
+                }
+            } else {
+                cout << GREEN << "[SUCCESS] Path is valid (" << (hopCount - 1) << " hops, checked in "
+                     << fixed << setprecision(1) << elapsedUs << " us).\n" << RESET;
+                printRouteTotals(totals);
+            }
+        } else if (choice == 6) {
+            break;
+        } else {
+            cout << RED << "[ERROR] Invalid choice!\n" << RESET;
+        }
+    }
+}
+
+// ============================================
+// ROUTE HISTORY (LINKED LIST)
+// ============================================
+
+void viewRouteHistory() {
+    if (routeHistoryHead == nullptr) {
+        cout << YELLOW << "\n[INFO] No route history available.\n" << RESET;
+        return;
+    }
+
+    displaySection("ROUTE HISTORY");
+    Node* current = routeHistoryHead;
+    int count = 1;
+
+    while (current != nullptr) {
+        renderText(to_string(count));
+        renderText(". ");
+        renderText(YELLOW);
+        renderRouteHops(current->hops);
+        renderText(current->note);
+        renderText(RESET);
+        renderText("\n");
+        current = current->next;
+        count++;
+    }
+    flushRender();
+    closeSectionBorder();
+}
+
+void clearRouteHistory() {
+    while (routeHistoryHead != nullptr) {
+        Node* temp = routeHistoryHead;
+        routeHistoryHead = routeHistoryHead->next;
+        delete temp;
+    }
+    cout << GREEN << "\n[SUCCESS] Route history cleared!\n" << RESET;
+}
+
+// ============================================
+// ROUTING GRAPH HELPERS
+// ============================================
+
+// Builds adjacency lists indexed by location index (not ID). The reverse
+// graph holds every usable road backwards, for searches towards a target.
+template <class Profile>
+void buildIndexedGraphFor(vector<vector<GraphNode>>& forwardGraph, vector<vector<GraphNode>>& reverseGraph) {
+    forwardGraph.assign(locationCount, vector<GraphNode>());
+    reverseGraph.assign(locationCount, vector<GraphNode>());
+
+    for (int i = 0; i < roadCount; i++) {
+        int weight = profileTravelWeight<Profile>(roads[i]);
+        if (weight < 0) continue;
+
+        int fromIndex = findLocationIndexByID(roads[i].fromID);
+        int toIndex = findLocationIndexByID(roads[i].toID);
+        if (fromIndex == -1 || toIndex == -1) continue;
+
+        GraphNode forwardEdge;
+        forwardEdge.destination = toIndex;
+        forwardEdge.distance = weight;
+        forwardEdge.roadIndex = i;
+        forwardGraph[fromIndex].push_back(forwardEdge);
+
+        GraphNode reverseEdge;
+        reverseEdge.destination = fromIndex;
+        reverseEdge.distance = weight;
+        reverseEdge.roadIndex = i;
+        reverseGraph[toIndex].push_back(reverseEdge);
+    }
+}
+
+// Weights for the active vehicle profile are folded into the edges here,
+// so searches over the result never look at the profile again
+void buildIndexedGraph(vector<vector<GraphNode>>& forwardGraph, vector<vector<GraphNode>>& reverseGraph) {
+    switch (activeVehicleProfile) {
+        case VEHICLE_MOTORBIKE: buildIndexedGraphFor<MotorbikeProfile>(forwardGraph, reverseGraph); break;
+        case VEHICLE_TRUCK: buildIndexedGraphFor<TruckProfile>(forwardGraph, reverseGraph); break;
+        case VEHICLE_BUS: buildIndexedGraphFor<BusProfile>(forwardGraph, reverseGraph); break;
+        default: buildIndexedGraphFor<CarProfile>(forwardGraph, reverseGraph); break;
+    }
+}
+
+// Dijkstra with a binary heap. Fills dist[] and parent[] for every location
+// index; on a reverse graph parent[v] is the next hop from v towards source.
+void dijkstraFromIndex(const vector<vector<GraphNode>>& graph, int sourceIndex,
+                       vector<int>& dist, vector<int>& parent) {
+    TraceSpan span("dijkstra");
+    int n = (int)graph.size();
+    dist.assign(n, INF_DISTANCE);
+    parent.assign(n, -1);
+
+    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> pq;
+    dist[sourceIndex] = 0;
+    pq.push(make_pair(0, sourceIndex));
+    long long settled = 0, relaxed = 0;
+
+    while (!pq.empty()) {
+        int d = pq.top().first;
+        int u = pq.top().second;
+        pq.pop();
+        if (d > dist[u]) continue;
+        settled++;
+
+        for (size_t j = 0; j < graph[u].size(); j++) {
+            int v = graph[u][j].destination;
+            int nd = d + graph[u][j].distance;
+            if (nd < dist[v]) {
+                dist[v] = nd;
+                parent[v] = u;
+                pq.push(make_pair(nd, v));
+                relaxed++;
+            }
+        }
+    }
+    span.counter("settled", settled);
+    span.counter("relaxed", relaxed);
+}
+
+int edgeWeightBetween(const vector<vector<GraphNode>>& graph, int fromIndex, int toIndex) {
+    int best = -1;
+    for (size_t j = 0; j < graph[fromIndex].size(); j++) {
+        if (graph[fromIndex][j].destination == toIndex &&
+            (best == -1 || graph[fromIndex][j].distance < best)) {
+            best = graph[fromIndex][j].distance;
+        }
+    }
+    return best;
+}
+
+// Weighted length of the road segments a path has in common with another path.
+// nextInOther is scratch space of graph.size() entries, all -1 on entry and
+// on return; only the other path's locations are touched.
+int sharedPathDistance(const vector<vector<GraphNode>>& graph, const vector<int>& path, const vector<int>& other,
+                       vector<int>& nextInOther) {
+    for (size_t i = 0; i + 1 < other.size(); i++) {
+        nextInOther[other[i]] = other[i + 1];
+    }
+
+    int shared = 0;
+    for (size_t i = 0; i + 1 < path.size(); i++) {
+        if (nextInOther[path[i]] == path[i + 1]) {
+            shared += edgeWeightBetween(graph, path[i], path[i + 1]);
+        }
+    }
+
+    for (size_t i = 0; i + 1 < other.size(); i++) {
+        nextInOther[other[i]] = -1;
+    }
+    return shared;
+}
+
+// ============================================
+// REACHABILITY INDEX (SCC + CONDENSATION DAG)
+// ============================================
+
+// Strongly connected components of the usable road graph (Tarjan), with
+// the components numbered so every DAG edge goes from a higher number to a
+// lower one. The condensation DAG is kept in CSR form. Up to
+// REACH_CLOSURE_MAX_COMPONENTS components, each component also keeps a
+// bitset of the components it can reach (C*C bits, 2 MB at the cap), so "is
+// there any path from A to B" is one bit test. Above the cap a query
+// searches the DAG instead, entering only components numbered between B and
+// A. Rebuilt lazily when roads or locations are added or removed, or when
+// an edit makes some road usable or unusable; any other weight edit only
+// re-checks the roads leaving the locations it changed (every road when it
+// did not say). Main thread only, like the hash indexes.
+const int REACH_CLOSURE_MAX_COMPONENTS = 4096;
+
+struct ReachabilityIndex {
+    int topologyVersion;
+    int weightVersion;
+    vector<char> roadUsable;                        // per road slot, as of the build
+    vector<int> componentOf;                        // per location index
+    vector<int> componentSize;
+    vector<int> dagStart;                           // successors of component c are
+    vector<int> dagTargets;                         // dagTargets[dagStart[c] .. dagStart[c + 1])
+    vector<vector<unsigned long long>> reaches;     // per component, bit per reachable component; empty above the cap
+    vector<int> visitedStamp;                       // per component, for DAG searches
+    int stamp;
+    vector<int> weightChanges;                      // locations edited since weightVersion; unused when all changed
+    bool allWeightsChanged;
+    int dagEdges;
+    double buildMicros;
+};
+
+ReachabilityIndex reachabilityIndex = {0, 0, vector<char>(), vector<int>(), vector<int>(), vector<int>(), vector<int>(),
+                                       vector<vector<unsigned long long>>(), vector<int>(), 0, vector<int>(), true, 0, 0.0};
+
+void rebuildReachabilityIndex() {
+    TraceSpan span("reachability index build", "preprocessing");
+    chrono::steady_clock::time_point started = chrono::steady_clock::now();
+    int n = locationCount;
+    ReachabilityIndex& index = reachabilityIndex;
+
+    // Usable roads as a CSR adjacency; only connectivity matters here. In
+    // compressed graph mode they are decoded from the current snapshot.
+    index.roadUsable.assign(roadCount, 0);
+    for (int r = 0; r < roadCount; r++) index.roadUsable[r] = roadTravelWeight(roads[r]) >= 0;
+    shared_ptr<const GraphSnapshot> snapshot = acquireGraphSnapshot();
+    bool fromCompressed = snapshot && snapshot->compressed && snapshot->topologyVersion == topologyVersion &&
+                          snapshot->weightVersion == weightVersion;
+    vector<pair<int, int>> usableRoads;
+    vector<int> edgeStart(n + 1, 0);
+    if (fromCompressed) {
+        const CompressedGraph& graph = *snapshot->compressed;
+        for (int u = 0; u < n; u++) {
+            forEachCompressedEdge(graph, u, [&](int v, int distance, unsigned int flags) {
+                if (compressedEdgeWeight(graph, distance, flags) < 0) return;
+                usableRoads.push_back(make_pair(u, v));
+                edgeStart[u + 1]++;
+            });
+        }
+    } else {
+        for (int r = 0; r < roadCount; r++) {
+            if (!index.roadUsable[r]) continue;
+            int fromIndex = findLocationIndexByID(roads[r].fromID), toIndex = findLocationIndexByID(roads[r].toID);
+            if (fromIndex == -1 || toIndex == -1) continue;
+            usableRoads.push_back(make_pair(fromIndex, toIndex));
+            edgeStart[fromIndex + 1]++;
+        }
+    }
+    for (int u = 0; u < n; u++) edgeStart[u + 1] += edgeStart[u];
+    vector<int> edgeTarget(usableRoads.size());
+    {
+        vector<int> fill(edgeStart.begin(), edgeStart.end() - 1);
+        for (size_t e = 0; e < usableRoads.size(); e++) edgeTarget[fill[usableRoads[e].first]++] = usableRoads[e].second;
+    }
+
+    index.componentOf.assign(n, -1);
+    index.componentSize.clear();
+
+    // Iterative Tarjan: components complete sinks-first, which is exactly
+    // the reverse topological order of the condensation
+    vector<int> order(n, -1), low(n, 0), members;
+    vector<bool> onStack(n, false);
+    vector<pair<int, int>> callStack;       // (location, next edge to look at)
+    int counter = 0;
+    for (int root = 0; root < n; root++) {
+        if (order[root] != -1) continue;
+        callStack.push_back(make_pair(root, edgeStart[root]));
+        order[root] = low[root] = counter++;
+        members.push_back(root);
+        onStack[root] = true;
+
+        while (!callStack.empty()) {
+            int u = callStack.back().first;
+            int& edge = callStack.back().second;
+            if (edge < edgeStart[u + 1]) {
+                int v = edgeTarget[edge++];
+                if (order[v] == -1) {
+                    order[v] = low[v] = counter++;
+                    members.push_back(v);
+                    onStack[v] = true;
+                    callStack.push_back(make_pair(v, edgeStart[v]));
+                } else if (onStack[v]) {
+                    low[u] = min(low[u], order[v]);
+                }
+                continue;
+            }
+
+            callStack.pop_back();
+            if (!callStack.empty()) {
+                int caller = callStack.back().first;
+                low[caller] = min(low[caller], low[u]);
+            }
+            if (low[u] == order[u]) {
+                int component = (int)index.componentSize.size();
+                int size = 0, w;
+                do {
+                    w = members.back();
+                    members.pop_back();
+                    onStack[w] = false;
+                    index.componentOf[w] = component;
+                    size++;
+                } while (w != u);
+                index.componentSize.push_back(size);
+            }
+        }
+    }
+
+    int components = (int)index.componentSize.size();
+    vector<vector<int>> successors(components);
+    for (int u = 0; u < n; u++) {
+        for (int e = edgeStart[u]; e < edgeStart[u + 1]; e++) {
+            int from = index.componentOf[u], to = index.componentOf[edgeTarget[e]];
+            if (from != to) successors[from].push_back(to);
+        }
+    }
+    index.dagStart.assign(components + 1, 0);
+    index.dagTargets.clear();
+    for (int c = 0; c < components; c++) {
+        sort(successors[c].begin(), successors[c].end());
+        successors[c].erase(unique(successors[c].begin(), successors[c].end()), successors[c].end());
+        index.dagTargets.insert(index.dagTargets.end(), successors[c].begin(), successors[c].end());
+        index.dagStart[c + 1] = (int)index.dagTargets.size();
+    }
+    index.dagEdges = (int)index.dagTargets.size();
+    index.visitedStamp.assign(components, 0);
+    index.stamp = 0;
+
+    index.reaches.clear();
+    if (components <= REACH_CLOSURE_MAX_COMPONENTS) {
+        int words = (components + 63) / 64;
+        index.reaches.assign(components, vector<unsigned long long>(words, 0));
+        for (int c = 0; c < components; c++) {
+            // Successors are numbered lower, so their sets are already final
+            index.reaches[c][c / 64] |= 1ULL << (c % 64);
+            for (int e = index.dagStart[c]; e < index.dagStart[c + 1]; e++) {
+                const vector<unsigned long long>& next = index.reaches[index.dagTargets[e]];
+                for (int w = 0; w < words; w++) index.reaches[c][w] |= next[w];
+            }
+        }
+    }
+
+    index.topologyVersion = topologyVersion;
+    index.weightVersion = weightVersion;
+    index.weightChanges.clear();
+    index.allWeightsChanged = false;
+    span.counter("components", components);
+    index.buildMicros = chrono::duration<double, micro>(chrono::steady_clock::now() - started).count();
+}
+
+void noteReachabilityWeightChange(const vector<int>& changedLocations) {
+    ReachabilityIndex& index = reachabilityIndex;
+    if (index.allWeightsChanged) return;
+    if (changedLocations.empty() || (int)(index.weightChanges.size() + changedLocations.size()) > locationCount) {
+        index.allWeightsChanged = true;
+        index.weightChanges.clear();
+        return;
+    }
+    index.weightChanges.insert(index.weightChanges.end(), changedLocations.begin(), changedLocations.end());
+}
+
+bool roadUsabilityChanged(int r) {
+    return (roadTravelWeight(roads[r]) >= 0) != (reachabilityIndex.roadUsable[r] != 0);
+}
+
+const ReachabilityIndex& currentReachabilityIndex() {
+    ReachabilityIndex& index = reachabilityIndex;
+    if (index.topologyVersion == topologyVersion && index.weightVersion != weightVersion) {
+        // Distance and congestion edits leave every road as usable as it was
+        bool usabilityChanged = false;
+        if (index.allWeightsChanged) {
+            for (int r = 0; r < roadCount && !usabilityChanged; r++) usabilityChanged = roadUsabilityChanged(r);
+        } else {
+            for (size_t i = 0; i < index.weightChanges.size() && !usabilityChanged; i++) {
+                int v = index.weightChanges[i];
+                if (v < 0 || v >= locationCount) continue;
+                const vector<int>& outgoing = roadsFromLocation(locations[v].id);
+                for (size_t k = 0; k < outgoing.size() && !usabilityChanged; k++) usabilityChanged = roadUsabilityChanged(outgoing[k]);
+            }
+        }
+        if (!usabilityChanged) {
+            index.weightVersion = weightVersion;
+            index.weightChanges.clear();
+            index.allWeightsChanged = false;
+        }
+    }
+    if (index.topologyVersion != topologyVersion || index.weightVersion != weightVersion) {
+        rebuildReachabilityIndex();
+    }
+    return index;
+}
+
+// Depth-first search of the condensation DAG. Every DAG edge leads to a
+// lower number, so nothing numbered below the target is ever entered.
+bool componentReaches(int from, int to) {
+    ReachabilityIndex& index = reachabilityIndex;
+    if (from == to) return true;
+    if (from < to) return false;
+    if (++index.stamp == INT_MAX) {
+        fill(index.visitedStamp.begin(), index.visitedStamp.end(), 0);
+        index.stamp = 1;
+    }
+    vector<int> pending(1, from);
+    index.visitedStamp[from] = index.stamp;
+    while (!pending.empty()) {
+        int c = pending.back();
+        pending.pop_back();
+        for (int e = index.dagStart[c]; e < index.dagStart[c + 1]; e++) {
+            int next = index.dagTargets[e];
+            if (next == to) return true;
+            if (next < to || index.visitedStamp[next] == index.stamp) continue;
+            index.visitedStamp[next] = index.stamp;
+            pending.push_back(next);
+        }
+    }
+    return false;
+}
+
+// True when some usable path leads from one location index to the other
+bool locationReachable(int fromIndex, int toIndex) {
+    const ReachabilityIndex& index = currentReachabilityIndex();
+    int from = index.componentOf[fromIndex], to = index.componentOf[toIndex];
+    if (index.reaches.empty()) return componentReaches(from, to);
+    return (index.reaches[from][to / 64] >> (to % 64)) & 1ULL;
+}
+
+// ============================================
+// ALL-PAIRS TABLE (BLOCKED FLOYD-WARSHALL)
+// ============================================
+
+// Every weighted distance and the first hop of every shortest path, for
+// networks small enough to hold n^2 entries. The matrices are split into
+// APSP_TILE x APSP_TILE tiles; for each block of intermediate locations the
+// diagonal tile is relaxed first, then its row and column tiles, then all
+// remaining tiles, with the tiles of each phase spread over worker threads.
+// The inner loop is branch-free min/select over contiguous rows so the
+// compiler can vectorise it. Rebuilt lazily after any road or location edit.
+const int APSP_MAX_LOCATIONS = 1024;    // above this the n^3 rebuild after an edit costs more than it saves
+const int APSP_TILE = 64;
+const int APSP_UNREACHABLE = INT_MAX / 2;   // sums of two stay below INT_MAX
+
+struct AllPairsTable {
+    int topologyVersion;
+    int weightVersion;
+    int n;
+    int stride;                     // row length, padded to whole tiles
+    vector<int> dist;               // dist[i * stride + j]
+    vector<unsigned short> next;    // first hop from i towards j
+    double buildMs;
+};
+
+AllPairsTable allPairsTable = {0, 0, 0, 0, vector<int>(), vector<unsigned short>(), 0.0};
+
+// Relaxes tile (ib, jb) through the intermediate locations of block kb
+void relaxAllPairsTile(AllPairsTable& table, int ib, int jb, int kb) {
+    int stride = table.stride;
+    int* dist = table.dist.data();
+    unsigned short* next = table.next.data();
+    int kEnd = min(table.n, (kb + 1) * APSP_TILE);
+    int iEnd = min(table.n, (ib + 1) * APSP_TILE);
+    int jBegin = jb * APSP_TILE, jEnd = min(table.n, jBegin + APSP_TILE);
+
+    for (int k = kb * APSP_TILE; k < kEnd; k++) {
+        const int* rowK = dist + (size_t)k * stride;
+        for (int i = ib * APSP_TILE; i < iEnd; i++) {
+            int* rowI = dist + (size_t)i * stride;
+            unsigned short* nextI = next + (size_t)i * stride;
+            int throughK = rowI[k];
+            unsigned short hopK = nextI[k];
+            if (throughK >= APSP_UNREACHABLE) continue;
+            for (int j = jBegin; j < jEnd; j++) {
+                int candidate = throughK + rowK[j];
+                bool better = candidate < rowI[j];
+                rowI[j] = better ? candidate : rowI[j];
+                nextI[j] = better ? hopK : nextI[j];
+            }
+        }
+    }
+}
+
+void rebuildAllPairsTable() {
+    TraceSpan span("all-pairs table build", "preprocessing");
+    chrono::steady_clock::time_point started = chrono::steady_clock::now();
+    AllPairsTable& table = allPairsTable;
+    int n = locationCount;
+    int tiles = (n + APSP_TILE - 1) / APSP_TILE;
+    table.n = n;
+    table.stride = max(1, tiles) * APSP_TILE;
+    table.dist.assign((size_t)table.stride * table.stride, APSP_UNREACHABLE);
+    table.next.assign((size_t)table.stride * table.stride, 0xFFFF);
+
+    for (int i = 0; i < n; i++) {
+        table.dist[(size_t)i * table.stride + i] = 0;
+        table.next[(size_t)i * table.stride + i] = (unsigned short)i;
+    }
+    for (int r = 0; r < roadCount; r++) {
+        int weight = roadTravelWeight(roads[r]);
+        int from = findLocationIndexByID(roads[r].fromID);
+        int to = findLocationIndexByID(roads[r].toID);
+        if (weight < 0 || from == -1 || to == -1) continue;
+        size_t cell = (size_t)from * table.stride + to;
+        if (weight < table.dist[cell]) {
+            table.dist[cell] = weight;
+            table.next[cell] = (unsigned short)to;
+        }
+    }
+
+    for (int kb = 0; kb < tiles; kb++) {
+        relaxAllPairsTile(table, kb, kb, kb);
+
+        // Row and column tiles of this block depend only on the diagonal
+        parallelFor(2 * (tiles - 1), [&table, kb, tiles](int job, int) {
+            int other = job % (tiles - 1);
+            if (other >= kb) other++;
+            if (job < tiles - 1) relaxAllPairsTile(table, kb, other, kb);
+            else relaxAllPairsTile(table, other, kb, kb);
+        });
+
+        parallelFor((tiles - 1) * (tiles - 1), [&table, kb, tiles](int job, int) {
+            int ib = job / (tiles - 1), jb = job % (tiles - 1);
+            if (ib >= kb) ib++;
+            if (jb >= kb) jb++;
+            relaxAllPairsTile(table, ib, jb, kb);
+        });
+    }
+
+    table.topologyVersion = topologyVersion;
+    table.weightVersion = weightVersion;
+    span.counter("locations", n);
+    span.counter("tiles", tiles);
+    table.buildMs = chrono::duration<double, milli>(chrono::steady_clock::now() - started).count();
+}
+
+// Weighted distance between two location indices from the table, or
+// INF_DISTANCE when unreachable
+int allPairsDistance(int fromIndex, int toIndex) {
+    AllPairsTable& table = allPairsTable;
+    if (table.topologyVersion != topologyVersion || table.weightVersion != weightVersion) {
+        rebuildAllPairsTable();
+    }
+    int distance = table.dist[(size_t)fromIndex * table.stride + toIndex];
+    return distance >= APSP_UNREACHABLE ? INF_DISTANCE : distance;
+}
+
+// As allPairsDistance(), with the path written to 'path'
+int allPairsLookup(int fromIndex, int toIndex, vector<int>& path) {
+    const AllPairsTable& table = allPairsTable;
+    path.clear();
+    int distance = allPairsDistance(fromIndex, toIndex);
+    if (distance == INF_DISTANCE) return INF_DISTANCE;
+    for (int v = fromIndex; v != toIndex; v = table.next[(size_t)v * table.stride + toIndex]) {
+        path.push_back(v);
+    }
+    path.push_back(toIndex);
+    return distance;
+}
+
+// ============================================
+// HUB LABELS (DISTANCE ORACLE)
+// ============================================
+
+// Every location stores two short labels: the hubs it can reach with their
+// distances (out-label) and the hubs that reach it (in-label). The distance
+// s -> t is the best out(s) + in(t) over hubs the two labels share, found by
+// merging two rank-sorted arrays. Hubs are taken in reverse contraction
+// order (the location a contraction hierarchy would keep longest comes
+// first) and labels are built by pruned Dijkstra searches, so a hub is only
+// recorded where no more important hub already covers the pair. Each entry
+// also stores the neighbour towards its hub, which lets full paths be
+// unpacked from the labels alone.
+
+const int HUB_SENTINEL = INT_MAX;       // closes every label so merges need no bounds checks
+
+struct HubLabelIndex {
+    int topologyVersion;
+    int weightVersion;
+    vector<int> hubOrder;               // location index of each rank
+    // Flattened labels, rank-sorted, each terminated by HUB_SENTINEL
+    vector<int> outOffset, outHub, outDist, outVia;     // via = next location towards the hub
+    vector<int> inOffset, inHub, inDist, inVia;         // via = previous location from the hub
+    double orderMs;
+    double buildMs;
+};
+
+HubLabelIndex hubLabels = {0, 0, vector<int>(), vector<int>(), vector<int>(), vector<int>(), vector<int>(),
+                           vector<int>(), vector<int>(), vector<int>(), vector<int>(), 0.0, 0.0};
+
+// Shortcuts needed to contract v: pairs u -> v -> w with no witness path
+// of at most the same length that avoids v
+int contractionShortcuts(int v, const vector<map<int, int>>& out, const vector<map<int, int>>& in,
+                         vector<pair<int, int>>* shortcuts, vector<int>* shortcutWeights) {
+    int added = 0;
+    for (map<int, int>::const_iterator a = in[v].begin(); a != in[v].end(); ++a) {
+        int u = a->first;
+        int limit = 0;
+        for (map<int, int>::const_iterator b = out[v].begin(); b != out[v].end(); ++b) {
+            limit = max(limit, a->second + b->second);
+        }
+
+        // Witness search from u, skipping v, bounded by the longest detour
+        map<int, int> dist;
+        priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> pq;
+        dist[u] = 0;
+        pq.push(make_pair(0, u));
+        while (!pq.empty()) {
+            int d = pq.top().first, x = pq.top().second;
+            pq.pop();
+            if (d > dist[x] || d > limit) continue;
+            for (map<int, int>::const_iterator e = out[x].begin(); e != out[x].end(); ++e) {
+                if (e->first == v) continue;
+                int nd = d + e->second;
+                map<int, int>::iterator known = dist.find(e->first);
+                if (known == dist.end() || nd < known->second) {
+                    dist[e->first] = nd;
+                    pq.push(make_pair(nd, e->first));
+                }
+            }
+        }
+
+        for (map<int, int>::const_iterator b = out[v].begin(); b != out[v].end(); ++b) {
+            int w = b->first;
+            if (w == u) continue;
+            int through = a->second + b->second;
+            map<int, int>::const_iterator witness = dist.find(w);
+            if (witness != dist.end() && witness->second <= through) continue;
+            added++;
+            if (shortcuts != nullptr) {
+                shortcuts->push_back(make_pair(u, w));
+                shortcutWeights->push_back(through);
+            }
+        }
+    }
+    return added;
+}
+
+// Greedy node contraction with lazy updates; importance is the edge
+// difference plus the number of already contracted neighbours. Returns the
+// locations from most to least important.
+vector<int> computeContractionOrder(const vector<vector<GraphNode>>& graph) {
+    int n = (int)graph.size();
+    vector<map<int, int>> out(n), in(n);
+    for (int u = 0; u < n; u++) {
+        for (size_t j = 0; j < graph[u].size(); j++) {
+            int v = graph[u][j].destination, w = graph[u][j].distance;
+            if (v == u) continue;
+            if (!out[u].count(v) || w < out[u][v]) {
+                out[u][v] = w;
+                in[v][u] = w;
+            }
+        }
+    }
+
+    vector<int> contractedNeighbours(n, 0);
+    vector<bool> contracted(n, false);
+    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> queue;
+    for (int v = 0; v < n; v++) {
+        int importance = contractionShortcuts(v, out, in, nullptr, nullptr) - (int)(in[v].size() + out[v].size());
+        queue.push(make_pair(importance, v));
+    }
+
+    vector<int> order;
+    while (!queue.empty()) {
+        int v = queue.top().second;
+        queue.pop();
+        if (contracted[v]) continue;
+
+        int importance = contractionShortcuts(v, out, in, nullptr, nullptr) - (int)(in[v].size() + out[v].size())
+                         + contractedNeighbours[v];
+        if (!queue.empty() && importance > queue.top().first) {
+            queue.push(make_pair(importance, v));
+            continue;
+        }
+
+        vector<pair<int, int>> shortcuts;
+        vector<int> weights;
+        contractionShortcuts(v, out, in, &shortcuts, &weights);
+        for (size_t s = 0; s < shortcuts.size(); s++) {
+            int u = shortcuts[s].first, w = shortcuts[s].second;
+            if (!out[u].count(w) || weights[s] < out[u][w]) {
+                out[u][w] = weights[s];
+                in[w][u] = weights[s];
+            }
+        }
+        for (map<int, int>::iterator e = out[v].begin(); e != out[v].end(); ++e) {
+            in[e->first].erase(v);
+            contractedNeighbours[e->first]++;
+        }
+        for (map<int, int>::iterator e = in[v].begin(); e != in[v].end(); ++e) {
+            out[e->first].erase(v);
+            contractedNeighbours[e->first]++;
+        }
+        out[v].clear();
+        in[v].clear();
+        contracted[v] = true;
+        order.push_back(v);
+    }
+
+    reverse(order.begin(), order.end());
+    return order;
+}
+
+// Best out(s) + in(t) over shared hubs. Both labels are rank-sorted and end
+// with the sentinel, so the merge advances with comparisons only.
+inline int hubMergeDistance(const int* outHub, const int* outDist, const int* inHub, const int* inDist, int* bestHub) {
+    int best = INF_DISTANCE;
+    int hub = -1;
+    size_t i = 0, j = 0;
+    while (true) {
+        int a = outHub[i], b = inHub[j];
+        if (a == b) {
+            if (a == HUB_SENTINEL) break;
+            int d = outDist[i] + inDist[j];
+            if (d < best) {
+                best = d;
+                hub = a;
+            }
+        }
+        i += (a <= b);
+        j += (b <= a);
+    }
+    if (bestHub != nullptr) *bestHub = hub;
+    return best;
+}
+
+void rebuildHubLabels() {
+    TraceSpan span("hub label build", "preprocessing");
+    chrono::steady_clock::time_point started = chrono::steady_clock::now();
+    HubLabelIndex& index = hubLabels;
+    vector<vector<GraphNode>> graph, reverseGraph;
+    buildIndexedGraph(graph, reverseGraph);
+    int n = locationCount;
+
+    index.hubOrder = computeContractionOrder(graph);
+    index.orderMs = chrono::duration<double, milli>(chrono::steady_clock::now() - started).count();
+
+    // Labels grow in rank order, so each stays sorted without a final sort
+    vector<vector<int>> outHub(n), outDist(n), outVia(n), inHub(n), inDist(n), inVia(n);
+    vector<int> dist(n, INF_DISTANCE), via(n, -1), touched;
+    for (int rank = 0; rank < n; rank++) {
+        int h = index.hubOrder[rank];
+        for (int direction = 0; direction < 2; direction++) {
+            // direction 0: h -> v fills in-labels; direction 1: v -> h fills out-labels
+            const vector<vector<GraphNode>>& edges = direction == 0 ? graph : reverseGraph;
+            priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> pq;
+            dist[h] = 0;
+            via[h] = h;
+            touched.push_back(h);
+            pq.push(make_pair(0, h));
+            while (!pq.empty()) {
+                int d = pq.top().first, v = pq.top().second;
+                pq.pop();
+                if (d > dist[v]) continue;
+
+                // Prune when more important hubs already give this distance
+                vector<int>& sourceHub = direction == 0 ? outHub[h] : outHub[v];
+                vector<int>& sourceDist = direction == 0 ? outDist[h] : outDist[v];
+                vector<int>& targetHub = direction == 0 ? inHub[v] : inHub[h];
+                vector<int>& targetDist = direction == 0 ? inDist[v] : inDist[h];
+                sourceHub.push_back(HUB_SENTINEL);
+                targetHub.push_back(HUB_SENTINEL);
+                int known = hubMergeDistance(sourceHub.data(), sourceDist.data(), targetHub.data(), targetDist.data(), nullptr);
+                sourceHub.pop_back();
+                targetHub.pop_back();
+                if (known <= d) continue;
+
+                if (direction == 0) {
+                    inHub[v].push_back(rank);
+                    inDist[v].push_back(d);
+                    inVia[v].push_back(via[v]);
+                } else {
+                    outHub[v].push_back(rank);
+                    outDist[v].push_back(d);
+                    outVia[v].push_back(via[v]);
+                }
+                for (size_t j = 0; j < edges[v].size(); j++) {
+                    int w = edges[v][j].destination;
+                    int nd = d + edges[v][j].distance;
+                    if (nd < dist[w]) {
+                        if (dist[w] == INF_DISTANCE) touched.push_back(w);
+                        dist[w] = nd;
+                        via[w] = v;
+                        pq.push(make_pair(nd, w));
+                    }
+                }
+            }
+            for (size_t t = 0; t < touched.size(); t++) {
+                dist[touched[t]] = INF_DISTANCE;
+                via[touched[t]] = -1;
+            }
+            touched.clear();
+        }
+    }
+
+    index.outOffset.assign(n + 1, 0);
+    index.inOffset.assign(n + 1, 0);
+    index.outHub.clear(); index.outDist.clear(); index.outVia.clear();
+    index.inHub.clear(); index.inDist.clear(); index.inVia.clear();
+    for (int v = 0; v < n; v++) {
+        index.outOffset[v] = (int)index.outHub.size();
+        index.outHub.insert(index.outHub.end(), outHub[v].begin(), outHub[v].end());
+        index.outDist.insert(index.outDist.end(), outDist[v].begin(), outDist[v].end());
+        index.outVia.insert(index.outVia.end(), outVia[v].begin(), outVia[v].end());
+        index.outHub.push_back(HUB_SENTINEL);
+        index.outDist.push_back(0);
+        index.outVia.push_back(-1);
+
+        index.inOffset[v] = (int)index.inHub.size();
+        index.inHub.insert(index.inHub.end(), inHub[v].begin(), inHub[v].end());
+        index.inDist.insert(index.inDist.end(), inDist[v].begin(), inDist[v].end());
+        index.inVia.insert(index.inVia.end(), inVia[v].begin(), inVia[v].end());
+        index.inHub.push_back(HUB_SENTINEL);
+        index.inDist.push_back(0);
+        index.inVia.push_back(-1);
+    }
+    index.outOffset[n] = (int)index.outHub.size();
+    index.inOffset[n] = (int)index.inHub.size();
+
+    index.topologyVersion = topologyVersion;
+    index.weightVersion = weightVersion;
+    index.buildMs = chrono::duration<double, milli>(chrono::steady_clock::now() - started).count();
+    span.counter("label entries", (long long)(index.outHub.size() + index.inHub.size() - 2 * n));
+}
+
+const HubLabelIndex& currentHubLabels() {
+    if (hubLabels.topologyVersion != topologyVersion || hubLabels.weightVersion != weightVersion) {
+        rebuildHubLabels();
+    }
+    return hubLabels;
+}
+
+// Weighted distance between two location indices, INF_DISTANCE if none
+int hubLabelDistance(int fromIndex, int toIndex) {
+    const HubLabelIndex& index = currentHubLabels();
+    int o = index.outOffset[fromIndex], i = index.inOffset[toIndex];
+    return hubMergeDistance(&index.outHub[o], &index.outDist[o], &index.inHub[i], &index.inDist[i], nullptr);
+}
+
+// As hubLabelDistance(), also unpacking the path from the labels' via links
+int hubLabelPath(int fromIndex, int toIndex, vector<int>& path) {
+    const HubLabelIndex& index = currentHubLabels();
+    path.clear();
+    int o = index.outOffset[fromIndex], i = index.inOffset[toIndex];
+    int rank;
+    int distance = hubMergeDistance(&index.outHub[o], &index.outDist[o], &index.inHub[i], &index.inDist[i], &rank);
+    if (distance == INF_DISTANCE) return distance;
+    int hub = index.hubOrder[rank];
+
+    // Walk the out-labels from the start up to the hub ...
+    for (int v = fromIndex; ; ) {
+        path.push_back(v);
+        if (v == hub) break;
+        int entry = index.outOffset[v];
+        while (index.outHub[entry] != rank) entry++;
+        v = index.outVia[entry];
+    }
+    // ... and the in-labels back from the end down to the hub
+    vector<int> tail;
+    for (int v = toIndex; v != hub; ) {
+        tail.push_back(v);
+        int entry = index.inOffset[v];
+        while (index.inHub[entry] != rank) entry++;
+        v = index.inVia[entry];
+    }
+    path.insert(path.end(), tail.rbegin(), tail.rend());
+    return distance;
+}
+
+void hubLabelMenu() {
+    if (locationCount < 2) {
+        cout << YELLOW << "\n[INFO] Add at least 2 locations first.\n" << RESET;
+        return;
+    }
+
+    const HubLabelIndex& index = currentHubLabels();
+    int n = locationCount;
+    size_t entries = index.outHub.size() + index.inHub.size() - 2 * n;
+    size_t largest = 0;
+    for (int v = 0; v < n; v++) {
+        largest = max(largest, (size_t)(index.outOffset[v + 1] - index.outOffset[v] - 1 +
+                                        index.inOffset[v + 1] - index.inOffset[v] - 1));
+    }
+    size_t bytes = (index.outHub.size() + index.inHub.size()) * 3 * sizeof(int) + (2 * n + 2) * sizeof(int);
+
+    // Time every pair and check it against the all-pairs table; above the
+    // table's size limit, use the pairs from an even spread of sources and
+    // check them against one Dijkstra search per source
+    bool fromTable = n <= APSP_MAX_LOCATIONS;
+    int sourceCount = fromTable ? n : min(n, 64);
+    int mismatches = 0, pairs = 0;
+    volatile long long sink = 0;
+    chrono::steady_clock::time_point started = chrono::steady_clock::now();
+    for (int k = 0; k < sourceCount; k++) {
+        int s = (int)((long long)k * n / sourceCount);
+        for (int t = 0; t < n; t++) {
+            sink += hubLabelDistance(s, t);
+            pairs++;
+        }
+    }
+    double queryNs = chrono::duration<double, nano>(chrono::steady_clock::now() - started).count() / pairs;
+    vector<vector<GraphNode>> graph, reverseGraph;
+    if (!fromTable) buildIndexedGraph(graph, reverseGraph);
+    vector<int> dist, parent;
+    for (int k = 0; k < sourceCount; k++) {
+        int s = (int)((long long)k * n / sourceCount);
+        if (!fromTable) dijkstraFromIndex(graph, s, dist, parent);
+        for (int t = 0; t < n; t++) {
+            if (hubLabelDistance(s, t) != (fromTable ? allPairsDistance(s, t) : dist[t])) mismatches++;
+        }
+    }
+
+    displaySection("HUB LABELS");
+    cout << CYAN << "Build time: " << RESET << formatFixed(index.buildMs, 3) << " ms (contraction order "
+         << formatFixed(index.orderMs, 3) << " ms)\n";
+    cout << CYAN << "Label entries: " << RESET << entries << " (avg " << formatFixed((double)entries / n, 2)
+         << " per location, largest " << largest << ")\n";
+    cout << CYAN << "Memory: " << RESET << bytes << " bytes\n";
+    cout << CYAN << "Query latency: " << RESET << formatFixed(queryNs, 1) << " ns avg over " << pairs << " pairs\n";
+    cout << CYAN << "Check against " << (fromTable ? "all-pairs table" : "Dijkstra") << ": " << RESET
+         << (mismatches == 0 ? GREEN : RED) << mismatches
+         << " mismatches" << RESET << "\n";
+    cout << CYAN << "Top hubs: " << RESET;
+    for (int r = 0; r < min(n, 5); r++) cout << (r > 0 ? ", " : "") << locations[index.hubOrder[r]].name;
+    cout << "\n";
+
+    while (true) {
+        cout << "\nEnter Start Location ID (0 to go back): ";
+        int startID;
+        if (!(cin >> startID)) {
+            clearBuffer();
+            cout << RED << "[ERROR] Invalid input!\n" << RESET;
+            continue;
+        }
+        if (startID == 0) break;
+        cout << "Enter End Location ID: ";
+        int endID;
+        if (!(cin >> endID)) {
+            clearBuffer();
+            cout << RED << "[ERROR] Invalid input!\n" << RESET;
+            continue;
+        }
+        if (!locationExists(startID) || !locationExists(endID)) {
+            cout << RED << "[ERROR] Invalid location IDs!\n" << RESET;
+            continue;
+        }
+
+        vector<int> path;
+        chrono::steady_clock::time_point queryStart = chrono::steady_clock::now();
+        int distance = hubLabelPath(findLocationIndexByID(startID), findLocationIndexByID(endID), path);
+        double queryUs = chrono::duration<double, micro>(chrono::steady_clock::now() - queryStart).count();
+        if (distance == INF_DISTANCE) {
+            cout << RED << "[ERROR] No path exists between the locations!\n" << RESET;
+            continue;
+        }
+        cout << CYAN << "Path: " << RESET;
+        for (size_t i = 0; i < path.size(); i++) {
+            cout << YELLOW << locations[path[i]].name << RESET;
+            if (i < path.size() - 1) cout << " -> ";
+        }
+        cout << "\n" << GREEN << "Total Weighted Distance: " << distance << " km" << RESET
+             << " (distance and path in " << formatFixed(queryUs, 2) << " us)\n";
+    }
+}
+
+// ============================================
+// GRAPH LAYOUT (CACHE LOCALITY)
+// ============================================
+
+// The location index is the slot in locations[], so it follows insertion
+// order and a search's dist[]/parent[] accesses jump around. A layout pass
+// renumbers the slots so neighbouring locations sit next to each other and
+// regroups roads[] by source to match; location IDs are untouched. Orders
+// and measurements work on plain coordinate and adjacency arrays, so the
+// benchmark can also run on a generated network far larger than the tables.
+
+const int LAYOUT_INTS_PER_LINE = 16;        // 4-byte entries per 64-byte cache line
+
+enum {
+    LAYOUT_CURRENT,
+    LAYOUT_BFS,
+    LAYOUT_DFS,
+    LAYOUT_HILBERT,
+    LAYOUT_COUNT
+};
+
+const char* layoutName(int layout) {
+    switch (layout) {
+        case LAYOUT_BFS: return "BFS";
+        case LAYOUT_DFS: return "DFS";
+        case LAYOUT_HILBERT: return "Hilbert curve";
+        default: return "Current";
+    }
+}
+
+struct LayoutReport {
+    double averageGap;          // mean |from - to| index distance over edges
+    double sameLinePercent;     // edges whose dist[] entries share a cache line
+    long long lineCrossings;    // relaxations touching a different line than the settled location
+    double searchUs;            // mean time of a single-source search
+};
+
+// Position of a point along a Hilbert curve over a 2^16 x 2^16 grid
+long long hilbertIndex(unsigned int x, unsigned int y) {
+    long long d = 0;
+    for (unsigned int s = 1u << 15; s > 0; s >>= 1) {
+        unsigned int rx = (x & s) > 0;
+        unsigned int ry = (y & s) > 0;
+        d += (long long)s * s * ((3 * rx) ^ ry);
+        if (ry == 0) {
+            if (rx == 1) {
+                x = s - 1 - x;
+                y = s - 1 - y;
+            }
+            swap(x, y);
+        }
+    }
+    return d;
+}
+
+// order[newIndex] = current index, for locations at coordinates[i]
+// (latitude, longitude) joined by graph. BFS and DFS treat roads as
+// undirected and seed each component from its lowest-degree location.
+vector<int> computeLayoutOrder(int layout, const vector<pair<double, double>>& coordinates,
+                               const vector<vector<GraphNode>>& graph) {
+    int n = (int)coordinates.size();
+    vector<int> order;
+    if (layout == LAYOUT_HILBERT) {
+        double minLat = 0, maxLat = 0, minLon = 0, maxLon = 0;
+        for (int i = 0; i < n; i++) {
+            if (i == 0 || coordinates[i].first < minLat) minLat = coordinates[i].first;
+            if (i == 0 || coordinates[i].first > maxLat) maxLat = coordinates[i].first;
+            if (i == 0 || coordinates[i].second < minLon) minLon = coordinates[i].second;
+            if (i == 0 || coordinates[i].second > maxLon) maxLon = coordinates[i].second;
+        }
+        double span = max(max(maxLat - minLat, maxLon - minLon), 1e-9);
+        vector<pair<long long, int>> keyed(n);
+        for (int i = 0; i < n; i++) {
+            unsigned int x = (unsigned int)((coordinates[i].second - minLon) / span * 65535.0);
+            unsigned int y = (unsigned int)((coordinates[i].first - minLat) / span * 65535.0);
+            keyed[i] = make_pair(hilbertIndex(x, y), i);
+        }
+        sort(keyed.begin(), keyed.end());
+        for (int i = 0; i < n; i++) order.push_back(keyed[i].second);
+        return order;
+    }
+    if (layout != LAYOUT_BFS && layout != LAYOUT_DFS) {
+        for (int i = 0; i < n; i++) order.push_back(i);
+        return order;
+    }
+
+    vector<vector<int>> neighbours(n);
+    for (int u = 0; u < n; u++) {
+        for (size_t j = 0; j < graph[u].size(); j++) {
+            neighbours[u].push_back(graph[u][j].destination);
+            neighbours[graph[u][j].destination].push_back(u);
+        }
+    }
+    vector<pair<int, int>> seeds(n);
+    for (int u = 0; u < n; u++) {
+        sort(neighbours[u].begin(), neighbours[u].end());
+        neighbours[u].erase(unique(neighbours[u].begin(), neighbours[u].end()), neighbours[u].end());
+        seeds[u] = make_pair((int)neighbours[u].size(), u);
+    }
+    sort(seeds.begin(), seeds.end());
+
+    vector<bool> placed(n, false);
+    for (int s = 0; s < n; s++) {
+        int seed = seeds[s].second;
+        if (placed[seed]) continue;
+        if (layout == LAYOUT_BFS) {
+            size_t head = order.size();
+            order.push_back(seed);
+            placed[seed] = true;
+            while (head < order.size()) {
+                int u = order[head++];
+                for (size_t j = 0; j < neighbours[u].size(); j++) {
+                    int v = neighbours[u][j];
+                    if (!placed[v]) {
+                        placed[v] = true;
+                        order.push_back(v);
+                    }
+                }
+            }
+        } else {
+            vector<int> stack(1, seed);
+            while (!stack.empty()) {
+                int u = stack.back();
+                stack.pop_back();
+                if (placed[u]) continue;
+                placed[u] = true;
+                order.push_back(u);
+                for (size_t j = neighbours[u].size(); j-- > 0; ) {
+                    if (!placed[neighbours[u][j]]) stack.push_back(neighbours[u][j]);
+                }
+            }
+        }
+    }
+    return order;
+}
+
+LayoutReport measureLayout(const vector<vector<GraphNode>>& graph, const vector<int>& order) {
+    int n = (int)graph.size();
+    vector<int> newIndex(n);
+    for (int i = 0; i < n; i++) newIndex[order[i]] = i;
+
+    // Renumbered copy with each adjacency list sorted, as the applied layout
+    // would build it
+    vector<vector<GraphNode>> permuted(n);
+    LayoutReport report = {0.0, 0.0, 0, 0.0};
+    long long edges = 0, gapTotal = 0, sameLine = 0;
+    for (int i = 0; i < n; i++) {
+        permuted[i] = graph[order[i]];
+        for (size_t j = 0; j < permuted[i].size(); j++) {
+            int v = newIndex[permuted[i][j].destination];
+            permuted[i][j].destination = v;
+            gapTotal += abs(v - i);
+            sameLine += (v / LAYOUT_INTS_PER_LINE == i / LAYOUT_INTS_PER_LINE);
+            edges++;
+        }
+        sort(permuted[i].begin(), permuted[i].end(),
+             [](const GraphNode& a, const GraphNode& b) { return a.destination < b.destination; });
+    }
+    if (edges > 0) {
+        report.averageGap = (double)gapTotal / edges;
+        report.sameLinePercent = 100.0 * sameLine / edges;
+    }
+
+    // Every relaxation reads dist[v] right after the settled dist[u]
+    vector<int> dist, parent;
+    dijkstraFromIndex(permuted, 0, dist, parent);
+    for (int u = 0; u < n; u++) {
+        if (dist[u] == INF_DISTANCE) continue;
+        for (size_t j = 0; j < permuted[u].size(); j++) {
+            report.lineCrossings += (permuted[u][j].destination / LAYOUT_INTS_PER_LINE != u / LAYOUT_INTS_PER_LINE);
+        }
+    }
+
+    // The same sources (by original index) for every layout, with the
+    // total work capped so large generated networks finish in seconds
+    int searches = max(1, min(20000, 4000000 / max(1, n)));
+    chrono::steady_clock::time_point started = chrono::steady_clock::now();
+    for (int k = 0; k < searches; k++) {
+        dijkstraFromIndex(permuted, newIndex[(int)((long long)k * 7919 % n)], dist, parent);
+    }
+    report.searchUs = chrono::duration<double, micro>(chrono::steady_clock::now() - started).count() / searches;
+    return report;
+}
+
+// A jittered street grid of about n locations with two-way roads between
+// grid neighbours, numbered in random order as real insertion order would be
+void generateLayoutNetwork(int n, unsigned int seed, vector<pair<double, double>>& coordinates,
+                           vector<vector<GraphNode>>& graph) {
+    int side = (int)ceil(sqrt((double)n));
+    n = side * side;
+    mt19937 rng(seed);
+    uniform_real_distribution<double> jitter(-0.3, 0.3);
+    vector<int> slot(n);
+    for (int i = 0; i < n; i++) slot[i] = i;
+    shuffle(slot.begin(), slot.end(), rng);
+
+    coordinates.assign(n, make_pair(0.0, 0.0));
+    graph.assign(n, vector<GraphNode>());
+    const double CELL_DEGREES = 0.005;
+    for (int r = 0; r < side; r++) {
+        for (int c = 0; c < side; c++) {
+            coordinates[slot[r * side + c]] = make_pair((r + jitter(rng)) * CELL_DEGREES, (c + jitter(rng)) * CELL_DEGREES);
+        }
+    }
+    for (int r = 0; r < side; r++) {
+        for (int c = 0; c < side; c++) {
+            for (int d = 0; d < 2; d++) {
+                int r2 = r + (d == 0), c2 = c + (d == 1);
+                if (r2 >= side || c2 >= side) continue;
+                int u = slot[r * side + c], v = slot[r2 * side + c2];
+                GraphNode edge;
+                edge.distance = 1 + (int)(rng() % 5);
+                edge.roadIndex = -1;
+                edge.destination = v;
+                graph[u].push_back(edge);
+                edge.destination = u;
+                graph[v].push_back(edge);
+            }
+        }
+    }
+}
+
+void printLayoutReports(const vector<LayoutReport>& reports) {
+    cout << CYAN << left << setw(16) << "Layout" << setw(12) << "Avg Gap" << setw(14) << "Same Line"
+         << setw(16) << "Line Crossings" << "Search (us)" << RESET << "\n";
+    for (int layout = 0; layout < LAYOUT_COUNT; layout++) {
+        const LayoutReport& r = reports[layout];
+        cout << left << setw(16) << layoutName(layout) << setw(12) << formatFixed(r.averageGap, 2)
+             << setw(14) << (formatFixed(r.sameLinePercent, 1) + "%") << setw(16) << r.lineCrossings
+             << formatFixed(r.searchUs, 2);
+        if (layout != LAYOUT_CURRENT && reports[LAYOUT_CURRENT].searchUs > 0) {
+            double change = 100.0 * (reports[LAYOUT_CURRENT].searchUs - r.searchUs) / reports[LAYOUT_CURRENT].searchUs;
+            cout << (change >= 0 ? GREEN : RED) << "  (" << (change >= 0 ? "-" : "+")
+                 << formatFixed(fabs(change), 1) << "%)" << RESET;
+        }
+        cout << "\n";
+    }
+    cout << "Line crossings count relaxations whose dist[] entry lies on a different\n"
+         << "64-byte line than the settled location's, for one search from slot 0.\n";
+}
+
+// Moves locations into the given order and groups roads by their new source
+// slot. The new order is saved as a checkpoint, since the journal has no
+// record for road order; returns false if that checkpoint failed.
+bool applyLocationLayout(const vector<int>& order) {
+    TraceSpan span("apply layout", "preprocessing");
+    vector<Location> reordered(locationCount);
+    unordered_map<int, int> slotOfID;
+    for (int i = 0; i < locationCount; i++) {
+        reordered[i] = locations[order[i]];
+        slotOfID[reordered[i].id] = i;
+    }
+    for (int i = 0; i < locationCount; i++) locations[i] = reordered[i];
+
+    stable_sort(roads, roads + roadCount, [&slotOfID](const Road& a, const Road& b) {
+        int aFrom = slotOfID.count(a.fromID) ? slotOfID[a.fromID] : INT_MAX;
+        int bFrom = slotOfID.count(b.fromID) ? slotOfID[b.fromID] : INT_MAX;
+        if (aFrom != bFrom) return aFrom < bFrom;
+        int aTo = slotOfID.count(a.toID) ? slotOfID[a.toID] : INT_MAX;
+        int bTo = slotOfID.count(b.toID) ? slotOfID[b.toID] : INT_MAX;
+        return aTo < bTo;
+    });
+    markTopologyChanged();
+    return writeCheckpoint();
+}
+
+void graphLayoutMenu() {
+    cout << "\nBenchmark on (1 = current network, 2 = generated street grid): ";
+    int source;
+    if (!(cin >> source) || (source != 1 && source != 2)) {
+        clearBuffer();
+        cout << RED << "[ERROR] Invalid choice!\n" << RESET;
+        return;
+    }
+
+    if (source == 2) {
+        cout << "Number of locations (1000-4000000): ";
+        int n;
+        if (!(cin >> n) || n < 1000 || n > 4000000) {
+            clearBuffer();
+            cout << RED << "[ERROR] Invalid number of locations!\n" << RESET;
+            return;
+        }
+        vector<pair<double, double>> coordinates;
+        vector<vector<GraphNode>> graph;
+        generateLayoutNetwork(n, 42, coordinates, graph);
+        vector<LayoutReport> reports(LAYOUT_COUNT);
+        for (int layout = 0; layout < LAYOUT_COUNT; layout++) {
+            reports[layout] = measureLayout(graph, computeLayoutOrder(layout, coordinates, graph));
+        }
+        displaySection("LAYOUT BENCHMARK (" + to_string(graph.size()) + " GENERATED)");
+        printLayoutReports(reports);
+        cout << YELLOW << "[INFO] The generated network is not stored; nothing to apply.\n" << RESET;
+        return;
+    }
+
+    if (locationCount < 2) {
+        cout << YELLOW << "\n[INFO] Add at least 2 locations first.\n" << RESET;
+        return;
+    }
+
+    vector<vector<GraphNode>> graph, reverseGraph;
+    buildIndexedGraph(graph, reverseGraph);
+    vector<pair<double, double>> coordinates(locationCount);
+    for (int i = 0; i < locationCount; i++) coordinates[i] = make_pair(locations[i].latitude, locations[i].longitude);
+    vector<vector<int>> orders(LAYOUT_COUNT);
+    vector<LayoutReport> reports(LAYOUT_COUNT);
+    for (int layout = 0; layout < LAYOUT_COUNT; layout++) {
+        orders[layout] = computeLayoutOrder(layout, coordinates, graph);
+        reports[layout] = measureLayout(graph, orders[layout]);
+    }
+
+    displaySection("GRAPH LAYOUT BENCHMARK");
+    printLayoutReports(reports);
+
+    cout << "\nApply a layout? (1 = BFS, 2 = DFS, 3 = Hilbert, 0 = keep current): ";
+    int choice;
+    if (!(cin >> choice) || choice < 0 || choice >= LAYOUT_COUNT) {
+        clearBuffer();
+        cout << RED << "[ERROR] Invalid choice!\n" << RESET;
+        return;
+    }
+    if (choice == LAYOUT_CURRENT) return;
+    if (!applyLocationLayout(orders[choice])) {
+        cout << RED << "\n[ERROR] Locations were renumbered, but the checkpoint that saves the new order "
+             << "could not be written!\n" << RESET;
+        return;
+    }
+    cout << GREEN << "\n[SUCCESS] Locations renumbered in " << layoutName(choice)
+         << " order. Location IDs are unchanged.\n" << RESET;
+}
+
+// ============================================
+// COMPRESSED GRAPH MODE
+// ============================================
+
+// Single-source search on the published snapshot, in whichever form the
+// mode selects
+void routeSearchFromIndex(int sourceIndex, vector<int>& dist, vector<int>& parent) {
+    TraceSpan span("dijkstra (snapshot)");
+    snapshotDijkstra(*acquireGraphSnapshot(), sourceIndex, dist, parent);
+}
+
+// Shortest path between two location indices, from the all-pairs table on
+// small networks and by one route search on larger ones (and in compressed
+// graph mode). Returns INF_DISTANCE with an empty path if there is none.
+int shortestPathLookup(int fromIndex, int toIndex, vector<int>& path) {
+    if (!compressedGraphMode && locationCount <= APSP_MAX_LOCATIONS) {
+        return allPairsLookup(fromIndex, toIndex, path);
+    }
+    vector<int> dist, parent;
+    routeSearchFromIndex(fromIndex, dist, parent);
+    path.clear();
+    for (int v = toIndex; dist[toIndex] != INF_DISTANCE && v != -1; v = parent[v]) path.push_back(v);
+    reverse(path.begin(), path.end());
+    return dist[toIndex];
+}
+
+// Bytes held by a snapshot's edges as allocated: chunk and block pointers,
+// block headers and edges for lists, offsets and byte runs when compressed
+size_t snapshotEdgeBytes(const GraphSnapshot& snapshot) {
+    if (snapshot.compressed) {
+        return snapshot.compressed->offset.capacity() * sizeof(unsigned int) + snapshot.compressed->bytes.capacity();
+    }
+    size_t bytes = snapshot.chunks.capacity() * sizeof(shared_ptr<const EdgeBlockChunk>);
+    for (size_t c = 0; c < snapshot.chunks.size(); c++) {
+        const EdgeBlockChunk& chunk = *snapshot.chunks[c];
+        bytes += sizeof(EdgeBlockChunk) + chunk.capacity() * sizeof(shared_ptr<const EdgeBlock>);
+        for (size_t b = 0; b < chunk.size(); b++) bytes += sizeof(EdgeBlock) + chunk[b]->capacity() * sizeof(GraphNode);
+    }
+    return bytes;
+}
+
+void compressedGraphMenu() {
+    if (locationCount < 2) {
+        cout << YELLOW << "\n[INFO] Add at least 2 locations first.\n" << RESET;
+        return;
+    }
+
+    // Both forms exist only for the comparison; the published snapshot keeps one
+    vector<vector<GraphNode>> forwardGraph, reverseGraph;
+    buildIndexedGraph(forwardGraph, reverseGraph);
+    shared_ptr<const GraphSnapshot> published = acquireGraphSnapshot();
+    CompressedGraph encoded;
+    if (!published->compressed) encodeCompressedGraph(encoded, nullptr, vector<int>());
+    const CompressedGraph& graph = published->compressed ? *published->compressed : encoded;
+    int n = locationCount;
+    size_t edges = graph.edgeCount;
+
+    size_t indexedBytes = 2 * forwardGraph.capacity() * sizeof(vector<GraphNode>);
+    for (int u = 0; u < n; u++) indexedBytes += (forwardGraph[u].capacity() + reverseGraph[u].capacity()) * sizeof(GraphNode);
+    size_t blockBytes = snapshotEdgeBytes(*expandGraphSnapshot(published));
+    size_t packedBytes = graph.offset.capacity() * sizeof(unsigned int) + graph.bytes.capacity();
+
+    // Every road must decode back to itself, every search to the same distances
+    int mismatches = 0, encodable = 0;
+    for (int r = 0; r < roadCount; r++) {
+        if (locationExists(roads[r].fromID) && locationExists(roads[r].toID)) encodable++;
+    }
+    if (encodable != graph.edgeCount) mismatches++;
+    for (int u = 0; u < n; u++) {
+        forEachCompressedEdge(graph, u, [&](int v, int distance, unsigned int flags) {
+            int r = findRoadIndex(locations[u].id, locations[v].id);
+            if (r == -1 || roads[r].distance != distance || roads[r].status != compressedStatusName(flags) ||
+                roads[r].isOneWay != ((flags & COMPRESSED_ONE_WAY) != 0) ||
+                roads[r].isAvailable != ((flags & COMPRESSED_AVAILABLE) != 0) ||
+                roadTravelWeight(roads[r]) != compressedEdgeWeight(graph, distance, flags)) {
+                mismatches++;
+            }
+        });
+    }
+    // Every source on small networks, an even spread of them on large ones,
+    // with the total work capped so the benchmark finishes in seconds
+    int searches = max(1, min(20000, 4000000 / n));
+    int checkedSources = min(n, searches);
+    vector<int> dist, parent, packedDist, packedParent;
+    for (int k = 0; k < checkedSources; k++) {
+        int s = (int)((long long)k * n / checkedSources);
+        dijkstraFromIndex(forwardGraph, s, dist, parent);
+        compressedDijkstra(graph, s, packedDist, packedParent);
+        if (dist != packedDist) mismatches++;
+    }
+
+    chrono::steady_clock::time_point started = chrono::steady_clock::now();
+    for (int k = 0; k < searches; k++) dijkstraFromIndex(forwardGraph, k % n, dist, parent);
+    double listUs = chrono::duration<double, micro>(chrono::steady_clock::now() - started).count() / searches;
+    started = chrono::steady_clock::now();
+    for (int k = 0; k < searches; k++) compressedDijkstra(graph, k % n, packedDist, packedParent);
+    double packedUs = chrono::duration<double, micro>(chrono::steady_clock::now() - started).count() / searches;
+
+    displaySection("COMPRESSED GRAPH");
+    cout << CYAN << "Mode: " << RESET << (compressedGraphMode ? GREEN : YELLOW)
+         << (compressedGraphMode ? "ON" : "OFF") << RESET << " (" << n << " locations, " << edges << " roads)\n";
+    cout << CYAN << left << setw(24) << "Representation" << setw(12) << "Bytes" << setw(14) << "Bytes/Road"
+         << "Search (us)" << RESET << "\n";
+    double perRoad = max((size_t)1, edges);
+    cout << left << setw(24) << "Indexed graph (fwd+rev)" << setw(12) << indexedBytes << setw(14)
+         << formatFixed(indexedBytes / perRoad, 2) << formatFixed(listUs, 2) << "\n";
+    cout << left << setw(24) << "Snapshot edge blocks" << setw(12) << blockBytes << setw(14)
+         << formatFixed(blockBytes / perRoad, 2) << "-\n";
+    cout << left << setw(24) << "Delta + varint" << setw(12) << packedBytes << setw(14)
+         << formatFixed(packedBytes / perRoad, 2) << formatFixed(packedUs, 2) << "\n";
+    cout << CYAN << "Memory vs indexed graph: " << RESET
+         << formatFixed(100.0 * (1.0 - (double)packedBytes / max((size_t)1, indexedBytes)), 1) << "% smaller; "
+         << CYAN << "vs edge blocks: " << RESET
+         << formatFixed(100.0 * (1.0 - (double)packedBytes / max((size_t)1, blockBytes)), 1) << "% smaller; "
+         << CYAN << "search slowdown vs lists: " << RESET
+         << formatFixed(100.0 * (packedUs - listUs) / max(listUs, 1e-9), 1) << "%\n";
+    cout << CYAN << "Round-trip check: " << RESET << (mismatches == 0 ? GREEN : RED) << mismatches
+         << " mismatches" << RESET << " over " << edges << " road(s) and " << checkedSources << " source(s)\n";
+    cout << "Bytes are measured from allocated capacity; in compressed mode the snapshots hold only the\n"
+         << "delta + varint form, and the roads table remains the record the journal saves.\n";
+
+    cout << "\nUse the compressed graph for route searches? (1 = yes, 0 = no): ";
+    int choice;
+    if (!(cin >> choice) || (choice != 0 && choice != 1)) {
+        clearBuffer();
+        cout << RED << "[ERROR] Invalid choice!\n" << RESET;
+        return;
+    }
+    if (compressedGraphMode != (choice == 1)) {
+        compressedGraphMode = choice == 1;
+        publishGraphSnapshot(vector<int>());
+    }
+    cout << GREEN << "\n[SUCCESS] Compressed graph mode " << (compressedGraphMode ? "enabled" : "disabled")
+         << ".\n" << RESET;
+}
+
+// ============================================
+// ALTERNATIVE ROUTES (PLATEAU METHOD)
+// ============================================
+
+// Finds meaningfully different alternatives to the shortest route. A plateau
+// is a chain of roads lying on both the forward tree from the start and the
+// backward tree into the end; every plateau yields a via-route that is
+// locally optimal over the plateau's length. Costs one extra Dijkstra run
+// plus a linear scan over the trees.
+void findAlternativeRoutes(const vector<vector<GraphNode>>& forwardGraph,
+                           const vector<vector<GraphNode>>& reverseGraph,
+                           int startIndex, int endIndex,
+                           const vector<int>& forwardDist, const vector<int>& forwardParent,
+                           const vector<int>& bestPath,
+                           vector<AlternativeRoute>& alternatives) {
+    alternatives.clear();
+
+    vector<int> backwardDist, nextHop;
+    dijkstraFromIndex(reverseGraph, endIndex, backwardDist, nextHop);
+
+    int n = (int)forwardGraph.size();
+    int optimal = forwardDist[endIndex];
+
+    // Road u -> v is on a plateau if it is in both shortest path trees
+    vector<bool> plateauOut(n, false);
+    vector<bool> plateauIn(n, false);
+    for (int v = 0; v < n; v++) {
+        int u = forwardParent[v];
+        if (u != -1 && nextHop[u] == v) {
+            plateauOut[u] = true;
+            plateauIn[v] = true;
+        }
+    }
+
+    // (detour length, plateau start, plateau end) for every candidate plateau
+    vector<tuple<int, int, int>> candidates;
+    for (int u = 0; u < n; u++) {
+        if (!plateauOut[u] || plateauIn[u]) continue;
+
+        int last = u;
+        while (plateauOut[last]) {
+            last = nextHop[last];
+        }
+
+        if (u == startIndex && last == endIndex) continue;   // the shortest route itself
+
+        long long routeLength = (long long)forwardDist[last] + backwardDist[last];
+        int plateauLength = forwardDist[last] - forwardDist[u];
+        if (routeLength > optimal * (1.0 + ALT_MAX_STRETCH)) continue;
+        if (plateauLength < optimal * ALT_MIN_PLATEAU) continue;
+
+        candidates.push_back(make_tuple((int)routeLength - plateauLength, u, last));
+    }
+    sort(candidates.begin(), candidates.end());
+
+    vector<vector<int>> acceptedPaths;
+    acceptedPaths.push_back(bestPath);
+
+    // Scratch shared by every candidate and reset through the paths that
+    // touched it, so rejected plateaus cost their path length, not n
+    vector<char> seen(n, 0);
+    vector<int> nextInOther(n, -1);
+
+    for (size_t c = 0; c < candidates.size() && (int)alternatives.size() < MAX_ALTERNATIVE_ROUTES; c++) {
+        int plateauStart = get<1>(candidates[c]);
+        int plateauEnd = get<2>(candidates[c]);
+
+        AlternativeRoute route;
+        for (int v = plateauStart; v != -1; v = forwardParent[v]) {
+            route.path.push_back(v);
+        }
+        reverse(route.path.begin(), route.path.end());
+        for (int v = nextHop[plateauStart]; v != -1; v = nextHop[v]) {
+            route.path.push_back(v);
+        }
+
+        // Via-routes can loop back on themselves; only simple paths qualify
+        size_t visited = 0;
+        while (visited < route.path.size() && !seen[route.path[visited]]) {
+            seen[route.path[visited]] = 1;
+            visited++;
+        }
+        bool simple = visited == route.path.size();
+        for (size_t i = 0; i < visited; i++) seen[route.path[i]] = 0;
+        if (!simple) continue;
+
+        route.distance = forwardDist[plateauEnd] + backwardDist[plateauEnd];
+        route.sharedDistance = sharedPathDistance(forwardGraph, route.path, bestPath, nextInOther);
+
+        bool distinct = true;
+        for (size_t a = 0; a < acceptedPaths.size(); a++) {
+            if (sharedPathDistance(forwardGraph, route.path, acceptedPaths[a], nextInOther) > optimal * ALT_MAX_SHARING) {
+                distinct = false;
+                break;
+            }
+        }
+        if (!distinct) continue;
+
+        acceptedPaths.push_back(route.path);
+        alternatives.push_back(route);
+    }
+}
+
+// ============================================
+// MULTI-CRITERIA (PARETO) ROUTING
+// ============================================
+
+struct ParetoEdge {
+    int destination;    // location index
+    int distance;       // physical km
+    double minutes;     // travel time including traffic delays
+    double cost;        // fuel cost plus toll ($)
+};
+
+struct ParetoLabel {
+    int distance;
+    double minutes;
+    double cost;
+    int locationIndex;
+    int previousLabel;  // index into the label pool, -1 at the start
+};
+
+struct ParetoRoute {
+    vector<int> path;   // location indices from start to end
+    int distance;
+    double minutes;
+    double cost;
+};
+
+template <class Profile>
+void buildParetoGraphFor(vector<vector<ParetoEdge>>& graph) {
+    graph.assign(locationCount, vector<ParetoEdge>());
+
+    for (int i = 0; i < roadCount; i++) {
+        if (profileTravelWeight<Profile>(roads[i]) < 0) continue;
+
+        int fromIndex = findLocationIndexByID(roads[i].fromID);
+        int toIndex = findLocationIndexByID(roads[i].toID);
+        if (fromIndex == -1 || toIndex == -1) continue;
+
+        ParetoEdge edge;
+        edge.destination = toIndex;
+        edge.distance = roads[i].distance;
+        edge.minutes = profileTravelMinutes<Profile>(roads[i]);
+        edge.cost = profileRoadCost<Profile>(roads[i]);
+        graph[fromIndex].push_back(edge);
+    }
+}
+
+void buildParetoGraph(vector<vector<ParetoEdge>>& graph) {
+    switch (activeVehicleProfile) {
+        case VEHICLE_MOTORBIKE: buildParetoGraphFor<MotorbikeProfile>(graph); break;
+        case VEHICLE_TRUCK: buildParetoGraphFor<TruckProfile>(graph); break;
+        case VEHICLE_BUS: buildParetoGraphFor<BusProfile>(graph); break;
+        default: buildParetoGraphFor<CarProfile>(graph); break;
+    }
+}
+
+bool paretoDominates(const ParetoLabel& a, const ParetoLabel& b) {
+    const double EPS = 1e-9;
+    return a.distance <= b.distance && a.minutes <= b.minutes + EPS && a.cost <= b.cost + EPS;
+}
+
+// Label-setting search that returns the Pareto front of routes over
+// (distance, time, cost). Labels are settled in lexicographic order, so a
+// settled label can never be dominated by a later one. Each location keeps at
+// most MAX_PARETO_LABELS settled labels, and labels dominated by an already
+// found route to the end are pruned before they are expanded.
+void paretoRouteSearch(int startIndex, int endIndex, vector<ParetoRoute>& front) {
+    front.clear();
+
+    vector<vector<ParetoEdge>> graph;
+    buildParetoGraph(graph);
+
+    vector<ParetoLabel> pool;
+    vector<vector<int>> settled(graph.size());
+
+    // (distance, minutes, cost, pool index), smallest first
+    typedef tuple<int, double, double, int> QueueEntry;
+    priority_queue<QueueEntry, vector<QueueEntry>, greater<QueueEntry>> pq;
+
+    ParetoLabel startLabel = {0, 0.0, 0.0, startIndex, -1};
+    pool.push_back(startLabel);
+    pq.push(make_tuple(0, 0.0, 0.0, 0));
+
+    while (!pq.empty()) {
+        int labelIndex = get<3>(pq.top());
+        pq.pop();
+        ParetoLabel label = pool[labelIndex];
+        int u = label.locationIndex;
+
+        if ((int)settled[u].size() >= MAX_PARETO_LABELS) continue;
+
+        bool dominated = false;
+        for (size_t k = 0; k < settled[u].size() && !dominated; k++) {
+            dominated = paretoDominates(pool[settled[u][k]], label);
+        }
+        for (size_t k = 0; k < settled[endIndex].size() && !dominated && u != endIndex; k++) {
+            dominated = paretoDominates(pool[settled[endIndex][k]], label);
+        }
+        if (dominated) continue;
+
+        settled[u].push_back(labelIndex);
+        if (u == endIndex) continue;
+
+        for (size_t j = 0; j < graph[u].size(); j++) {
+            const ParetoEdge& edge = graph[u][j];
+            ParetoLabel next = {label.distance + edge.distance, label.minutes + edge.minutes,
+                                label.cost + edge.cost, edge.destination, labelIndex};
+
+            // Cheap pre-check against the target's front keeps the queue small
+            bool prune = false;
+            for (size_t k = 0; k < settled[endIndex].size() && !prune; k++) {
+                prune = paretoDominates(pool[settled[endIndex][k]], next);
+            }
+            if (prune) continue;
+
+            pool.push_back(next);
+            pq.push(make_tuple(next.distance, next.minutes, next.cost, (int)pool.size() - 1));
+        }
+    }
+
+    for (size_t k = 0; k < settled[endIndex].size(); k++) {
+        const ParetoLabel& label = pool[settled[endIndex][k]];
+        ParetoRoute route;
+        route.distance = label.distance;
+        route.minutes = label.minutes;
+        route.cost = label.cost;
+        for (int l = settled[endIndex][k]; l != -1; l = pool[l].previousLabel) {
+            route.path.push_back(pool[l].locationIndex);
+        }
+        reverse(route.path.begin(), route.path.end());
+        front.push_back(route);
+    }
+}
+
+// ============================================
+// DIJKSTRA'S SHORTEST PATH
+// ============================================
+
+void shortestPathDijkstra() {
+    if (locationCount < 2) {
+        cout << YELLOW << "\n[INFO] Add at least 2 locations first.\n" << RESET;
+        return;
+    }
+
+    viewLocations();
+
+    int startID, endID;
+    cout << "\nEnter Start Location ID: ";
+    if (!(cin >> startID)) {
+        clearBuffer();
+        cout << RED << "[ERROR] Invalid input!\n" << RESET;
+        return;
+    }
+
+    cout << "Enter End Location ID: ";
+    if (!(cin >> endID)) {
+        clearBuffer();
+        cout << RED << "[ERROR] Invalid input!\n" << RESET;
+        return;
+    }
+
+    if (!locationExists(startID) || !locationExists(endID)) {
+        cout << RED << "[ERROR] Invalid location IDs!\n" << RESET;
+        return;
+    }
+
+    if (startID == endID) {
+        cout << YELLOW << "[INFO] Start and end locations are the same!\n" << RESET;
+        return;
+    }
+
+    int startIndex = findLocationIndexByID(startID);
+    int endIndex = findLocationIndexByID(endID);
+
+    TraceSpan querySpan("shortest path query");
+    querySpan.counter("from", startID);
+    querySpan.counter("to", endID);
+
+    // Answered from the component index without searching
+    bool reachable;
+    {
+        TraceSpan span("reachability check");
+        reachable = locationReachable(startIndex, endIndex);
+    }
+    if (!reachable) {
+        cout << RED << "\n[ERROR] No path exists between the locations!\n" << RESET;
+        cout << YELLOW << "[INFO] This may be due to blocked or unavailable roads.\n" << RESET;
+        return;
+    }
+
+    vector<int> dist, parent;
+    routeSearchFromIndex(startIndex, dist, parent);
+
+    vector<int> path;
+    {
+        TraceSpan span("path reconstruction");
+        int current = endIndex;
+        while (current != -1) {
+            path.push_back(current);
+            current = parent[current];
+        }
+        reverse(path.begin(), path.end());
+        span.counter("hops", (long long)path.size() - 1);
+    }
+    querySpan.counter("distance", dist[endIndex]);
+
+    displaySection("SHORTEST PATH FOUND");
+
+    renderText(CYAN);
+    renderText("Path: ");
+    renderText(RESET);
+    renderLocationPath(path);
+    renderText("\n");
+    flushRender();
+
+    cout << GREEN << "Total Weighted Distance: " << dist[endIndex] << " km" << RESET;
+    cout << YELLOW << " (includes traffic delays)\n" << RESET;
+
+    {
+        TraceSpan span("cost estimation");
+        displaySection("COST ESTIMATION");
+        cout << CYAN << "Route: " << RESET << findLocationNameByID(startID) << " -> " << findLocationNameByID(endID) << "\n";
+        printTripEstimateTable(dist[endIndex]);
+    }
+
+    // The plateau search needs both directions as lists, which compressed
+    // mode exists to avoid building
+    vector<AlternativeRoute> alternatives;
+    if (!compressedGraphMode) {
+        TraceSpan span("alternative routes");
+        vector<vector<GraphNode>> forwardGraph, reverseGraph;
+        snapshotGraphs(*acquireGraphSnapshot(), forwardGraph, reverseGraph);
+        findAlternativeRoutes(forwardGraph, reverseGraph, startIndex, endIndex, dist, parent, path, alternatives);
+        span.counter("found", (long long)alternatives.size());
+    }
+
+    displaySection("ALTERNATIVE ROUTES");
+    if (compressedGraphMode) {
+        cout << YELLOW << "[INFO] Alternative routes are not searched in compressed graph mode.\n" << RESET;
+    } else if (alternatives.empty()) {
+        cout << YELLOW << "[INFO] No meaningfully different alternative route found.\n" << RESET;
+    }
+    for (size_t a = 0; a < alternatives.size(); a++) {
+        const AlternativeRoute& route = alternatives[a];
+        cout << CYAN << "Alternative " << (a + 1) << ": " << RESET;
+        for (size_t i = 0; i < route.path.size(); i++) {
+            cout << YELLOW << locations[route.path[i]].name << RESET;
+            if (i < route.path.size() - 1) cout << " -> ";
+        }
+        cout << "\n";
+
+        double optimal = max(1, dist[endIndex]);    // zero-length roads can make the optimum 0 km
+        int extraPercent = (int)((route.distance - dist[endIndex]) * 100.0 / optimal + 0.5);
+        int sharedPercent = (int)(route.sharedDistance * 100.0 / optimal + 0.5);
+        cout << "   " << GREEN << route.distance << " km" << RESET
+             << " (+" << extraPercent << "%, shares " << sharedPercent << "% with shortest route)\n";
+    }
+    closeSectionBorder();
+
+    {
+        TraceSpan span("history insert");
+        saveRouteToHistory(locationPathNames(path), " (Distance: " + to_string(dist[endIndex]) + " km)");
+    }
+
+    cout << GREEN << "\n[SUCCESS] Path saved to history!\n" << RESET;
+}
+
+// ============================================
+// ASCII MAP VIEW
+// ============================================
+
+void displayASCIIMap() {
+    if (locationCount == 0) {
+        cout << YELLOW << "\n[INFO] Add locations first to see the map.\n" << RESET;
+        return;
+    }
+
+    displaySection("ASCII MAP VIEW");
+    cout << "\nLocations and Road Network:\n\n";
+
+    // Group roads by origin once instead of rescanning every road per location
+    vector<vector<int>> outgoingRoads(locationCount);
+    for (int j = 0; j < roadCount; j++) {
+        int fromIndex = findLocationIndexByID(roads[j].fromID);
+        if (fromIndex != -1) {
+            outgoingRoads[fromIndex].push_back(j);
+        }
+    }
+
+    int rowsShown = 0;
+    for (int i = 0; i < locationCount; i++) {
+        renderText("[");
+        renderText(YELLOW);
+        renderText(to_string(locations[i].id));
+        renderText(RESET);
+        renderText("] ");
+        renderText(locations[i].name);
+        renderText("\n");
+
+        for (size_t k = 0; k < outgoingRoads[i].size(); k++) {
+            const Road& road = roads[outgoingRoads[i][k]];
+            int toIndex = findLocationIndexByID(road.toID);
+
+            renderText("    |--(");
+            renderText(YELLOW);
+            renderText(to_string(road.distance));
+            renderText("km");
+            renderText(RESET);
+            renderText(", ");
+            renderText(roadStatusColor(road.status));
+            renderText(road.status);
+            renderText(RESET);
+            renderText(", ");
+            renderText(road.isAvailable ? RESET : RED);
+            renderText(road.isAvailable ? "Available" : "Unavailable");
+            renderText(RESET);
+            renderText(")--");
+
+            // Indicate one-way road
+            if (road.isOneWay) {
+                renderText(" (->)");
+            }
+
+            renderText("[");
+            renderText(YELLOW);
+            renderText(to_string(road.toID));
+            renderText(RESET);
+            renderText("] ");
+            if (toIndex != -1) {
+                renderText(locations[toIndex].name);
+            } else {
+                renderText("Unknown");
+            }
+            renderText("\n");
+        }
+
+        if (outgoingRoads[i].empty()) {
+            renderText("    (no outgoing roads)\n");
+        }
+        if (!endRenderRow(rowsShown)) break;
+    }
+
+    flushRender();
+    cout << "\n";
+}
+
+// ============================================
+// ROAD CRITICALITY (BETWEENNESS CENTRALITY)
+// ============================================
+
+// Brandes' algorithm on the weighted graph: one Dijkstra per source counts
+// shortest paths, then a sweep in reverse settle order hands each target's
+// dependency back to its predecessors, crediting both the location and the
+// road used. Sources are spread over worker threads, each adding into its
+// own accumulators that are summed at the end. Large networks search a
+// random sample of sources and scale the result by n / sample.
+
+const int BETWEENNESS_EXACT_LIMIT = 2000;       // above this, statistics use sampling
+const int BETWEENNESS_DEFAULT_SAMPLES = 256;
+const unsigned int BETWEENNESS_DEFAULT_SEED = 2024;
+
+struct BetweennessResult {
+    int topologyVersion;
+    int weightVersion;
+    int vehicleProfile;
+    int sources;                // sources searched
+    bool sampled;
+    vector<double> location;    // by location index
+    vector<double> road;        // by road index
+    double buildMs;
+};
+
+BetweennessResult betweenness = {0, 0, -1, 0, false, vector<double>(), vector<double>(), 0.0};
+
+struct BrandesWorkspace {
+    vector<int> dist;
+    vector<double> sigma, delta;
+    vector<vector<pair<int, int>>> predecessors;    // (location, road index)
+    vector<int> settledOrder;
+    vector<double> location, road;                  // this worker's totals
+};
+
+void brandesFromSource(const vector<vector<GraphNode>>& graph, int source, BrandesWorkspace& w) {
+    int n = (int)graph.size();
+    w.dist.assign(n, INF_DISTANCE);
+    w.sigma.assign(n, 0.0);
+    w.delta.assign(n, 0.0);
+    for (int v = 0; v < n; v++) w.predecessors[v].clear();
+    w.settledOrder.clear();
+
+    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> pq;
+    w.dist[source] = 0;
+    w.sigma[source] = 1.0;
+    pq.push(make_pair(0, source));
+    while (!pq.empty()) {
+        int d = pq.top().first, u = pq.top().second;
+        pq.pop();
+        if (d > w.dist[u]) continue;
+        w.settledOrder.push_back(u);
+        for (size_t j = 0; j < graph[u].size(); j++) {
+            int v = graph[u][j].destination;
+            int nd = d + graph[u][j].distance;
+            if (nd < w.dist[v]) {
+                w.dist[v] = nd;
+                w.sigma[v] = w.sigma[u];
+                w.predecessors[v].assign(1, make_pair(u, graph[u][j].roadIndex));
+                pq.push(make_pair(nd, v));
+            } else if (nd == w.dist[v] && v != u) {
+                w.sigma[v] += w.sigma[u];
+                w.predecessors[v].push_back(make_pair(u, graph[u][j].roadIndex));
+            }
+        }
+    }
+
+    for (size_t k = w.settledOrder.size(); k-- > 1; ) {
+        int v = w.settledOrder[k];
+        for (size_t p = 0; p < w.predecessors[v].size(); p++) {
+            int u = w.predecessors[v][p].first;
+            double share = w.sigma[u] / w.sigma[v] * (1.0 + w.delta[v]);
+            w.road[w.predecessors[v][p].second] += share;
+            w.delta[u] += share;
+        }
+        w.location[v] += w.delta[v];
+    }
+}
+
+// sampleSize 0 (or at least the location count) searches every source
+void computeBetweenness(int sampleSize, unsigned int seed) {
+    TraceSpan span("betweenness", "analysis");
+    chrono::steady_clock::time_point started = chrono::steady_clock::now();
+    vector<vector<GraphNode>> graph, reverseGraph;
+    buildIndexedGraph(graph, reverseGraph);
+    int n = locationCount;
+
+    vector<int> sources(n);
+    for (int i = 0; i < n; i++) sources[i] = i;
+    bool sampled = sampleSize > 0 && sampleSize < n;
+    if (sampled) {
+        mt19937 rng(seed);
+        shuffle(sources.begin(), sources.end(), rng);
+        sources.resize(sampleSize);
+    }
+
+    int workers = parallelWorkerCount((int)sources.size());
+    vector<BrandesWorkspace> workspaces(workers);
+    for (int k = 0; k < workers; k++) {
+        workspaces[k].predecessors.assign(n, vector<pair<int, int>>());
+        workspaces[k].location.assign(n, 0.0);
+        workspaces[k].road.assign(roadCount, 0.0);
+    }
+    parallelFor((int)sources.size(), [&](int job, int worker) {
+        brandesFromSource(graph, sources[job], workspaces[worker]);
+    });
+
+    double scale = sampled ? (double)n / sources.size() : 1.0;
+    betweenness.location.assign(n, 0.0);
+    betweenness.road.assign(roadCount, 0.0);
+    for (int k = 0; k < workers; k++) {
+        for (int v = 0; v < n; v++) betweenness.location[v] += workspaces[k].location[v] * scale;
+        for (int r = 0; r < roadCount; r++) betweenness.road[r] += workspaces[k].road[r] * scale;
+    }
+    betweenness.sources = (int)sources.size();
+    betweenness.sampled = sampled;
+    betweenness.topologyVersion = topologyVersion;
+    betweenness.weightVersion = weightVersion;
+    betweenness.vehicleProfile = activeVehicleProfile;
+    betweenness.buildMs = chrono::duration<double, milli>(chrono::steady_clock::now() - started).count();
+    span.counter("sources", betweenness.sources);
+}
+
+const BetweennessResult& currentBetweenness() {
+    if (betweenness.topologyVersion != topologyVersion || betweenness.weightVersion != weightVersion ||
+        betweenness.vehicleProfile != activeVehicleProfile) {
+        computeBetweenness(locationCount > BETWEENNESS_EXACT_LIMIT ? BETWEENNESS_DEFAULT_SAMPLES : 0,
+                           BETWEENNESS_DEFAULT_SEED);
+    }
+    return betweenness;
+}
+
+// Indices ordered by descending score, at most 'limit' of them
+vector<int> topByScore(const vector<double>& scores, int limit) {
+    vector<int> order(scores.size());
+    for (size_t i = 0; i < scores.size(); i++) order[i] = (int)i;
+    limit = min(limit, (int)order.size());
+    partial_sort(order.begin(), order.begin() + limit, order.end(),
+                 [&scores](int a, int b) { return scores[a] > scores[b]; });
+    order.resize(limit);
+    return order;
+}
+
+void printBetweennessSummary(const BetweennessResult& result, int limit) {
+    vector<int> topLocations = topByScore(result.location, limit);
+    vector<int> topRoads = topByScore(result.road, limit);
+    cout << "  " << CYAN << "Busiest Locations: " << RESET;
+    for (size_t i = 0; i < topLocations.size(); i++) {
+        cout << (i > 0 ? ", " : "") << locations[topLocations[i]].name << " ("
+             << formatFixed(result.location[topLocations[i]], 1) << ")";
+    }
+    cout << "\n  " << CYAN << "Busiest Roads: " << RESET;
+    for (size_t i = 0; i < topRoads.size(); i++) {
+        const Road& road = roads[topRoads[i]];
+        cout << (i > 0 ? ", " : "") << road.fromID << "->" << road.toID << " ("
+             << formatFixed(result.road[topRoads[i]], 1) << ")";
+    }
+    cout << "\n";
+}
+
+// Quotes a CSV field, doubling any embedded quotes (RFC 4180).
+string csvQuoted(const string& field) {
+    string quoted = "\"";
+    for (size_t i = 0; i < field.size(); i++) {
+        if (field[i] == '"') quoted += '"';
+        quoted += field[i];
+    }
+    return quoted + "\"";
+}
+
+bool exportBetweenness(const BetweennessResult& result, const string& path) {
+    ofstream out(path.c_str());
+    if (!out) return false;
+    out << "kind,from_id,to_id,name,status,betweenness\n";
+    for (int v = 0; v < locationCount; v++) {
+        out << "location," << locations[v].id << ",," << csvQuoted(nameString(locations[v].name)) << ",,"
+            << formatFixed(result.location[v], 4) << "\n";
+    }
+    for (int r = 0; r < roadCount; r++) {
+        out << "road," << roads[r].fromID << "," << roads[r].toID << ",," << roads[r].status << ","
+            << formatFixed(result.road[r], 4) << "\n";
+    }
+    return (bool)out;
+}
+
+void roadCriticalityMenu() {
+    if (locationCount < 2) {
+        cout << YELLOW << "\n[INFO] Add at least 2 locations first.\n" << RESET;
+        return;
+    }
+
+    cout << "\nSources to sample (0 = exact, all " << locationCount << " sources): ";
+    int sampleSize;
+    if (!(cin >> sampleSize) || sampleSize < 0) {
+        clearBuffer();
+        cout << RED << "[ERROR] Invalid input!\n" << RESET;
+        return;
+    }
+    unsigned int seed = BETWEENNESS_DEFAULT_SEED;
+    if (sampleSize > 0 && sampleSize < locationCount) {
+        cout << "Random seed: ";
+        if (!(cin >> seed)) {
+            clearBuffer();
+            cout << RED << "[ERROR] Invalid seed!\n" << RESET;
+            return;
+        }
+    }
+    computeBetweenness(sampleSize, seed);
+
+    displaySection("ROAD CRITICALITY");
+    cout << CYAN << "Method: " << RESET << (betweenness.sampled ? "sampled" : "exact") << " Brandes, "
+         << betweenness.sources << " source(s) on " << parallelWorkerCount(betweenness.sources) << " thread(s) in "
+         << formatFixed(betweenness.buildMs, 2) << " ms\n";
+    printBetweennessSummary(betweenness, 10);
+    closeSectionBorder();
+
+    cout << "\nExport to CSV? Enter file path (or - to skip): ";
+    string path;
+    cin >> path;
+    if (path == "-") return;
+    if (exportBetweenness(betweenness, path)) {
+        cout << GREEN << "[SUCCESS] Scores written to " << path << "\n" << RESET;
     } else {
-        isOneWay = (oneWayChoice == 1);
+        cout << RED << "[ERROR] Could not write " << path << "!\n" << RESET;
+    }
+}
+
+// ============================================
+// SYSTEM STATISTICS
+// ============================================
+
+void displaySystemStatistics() {
+    displaySection("SYSTEM STATISTICS");
+
+    cout << CYAN << "Total Locations: " << RESET << locationCount << "/" << MAX_LOCATIONS << "\n";
+    cout << CYAN << "Total Roads: " << RESET << roadCount << "/" << MAX_ROADS << "\n";
+
+    if (roadCount > 0) {
+        int normalCount = 0, heavyCount = 0, blockedCount = 0;
+        int availableCount = 0, unavailableCount = 0;
+        int oneWayCount = 0, bidirectionalCount = 0;
+
+        for (int i = 0; i < roadCount; i++) {
+            if (roads[i].status == "Normal") normalCount++;
+            else if (roads[i].status == "Heavy Traffic") heavyCount++;
+            else if (roads[i].status == "Blocked") blockedCount++;
+
+            if (roads[i].isAvailable) availableCount++;
+            else unavailableCount++;
+
+            if (roads[i].isOneWay) oneWayCount++;
+            else bidirectionalCount++;
+        }
+
+        cout << "\nRoad Status Breakdown:\n";
+        cout << "  " << GREEN << "Normal Roads: " << normalCount << RESET << "\n";
+        cout << "  " << YELLOW << "Heavy Traffic: " << heavyCount << RESET << "\n";
+        cout << "  " << RED << "Blocked Roads: " << blockedCount << RESET << "\n";
+
+        cout << "\nRoad Availability:\n";
+        cout << "  " << GREEN << "Available Roads: " << availableCount << RESET << "\n";
+        cout << "  " << RED << "Unavailable Roads: " << unavailableCount << RESET << "\n";
+
+        cout << "\nRoad Direction:\n";
+        cout << "  " << CYAN << "One-Way Roads: " << oneWayCount << RESET << "\n";
+        cout << "  " << BLUE << "Bidirectional Roads: " << (bidirectionalCount / 2) << RESET << "\n";
+
+        int totalDistance = 0;
+        for (int i = 0; i < roadCount; i++) {
+            totalDistance += roads[i].distance;
+        }
+        double avgDistance = (double)totalDistance / roadCount;
+        cout << fixed << setprecision(2);
+        cout << "\n" << CYAN << "Average Road Distance: " << RESET << avgDistance << " km\n";
+    }
+
+    // Count routes in history
+    int routeCount = 0;
+    Node* current = routeHistoryHead;
+    while (current != nullptr) {
+        routeCount++;
+        current = current->next;
+    }
+    cout << CYAN << "Paths in History: " << RESET << routeCount << "\n";
+
+    if (locationCount > 0) {
+        const ReachabilityIndex& index = currentReachabilityIndex();
+        int components = (int)index.componentSize.size();
+        cout << "\nConnectivity (usable roads):\n";
+        cout << "  " << CYAN << "Strongly Connected Components: " << RESET << components
+             << (components == 1 ? GREEN : YELLOW) << (components == 1 ? " (every location reaches every other)" : "")
+             << RESET << "\n";
+        cout << "  " << CYAN << "Condensation DAG Edges: " << RESET << index.dagEdges
+             << (index.reaches.empty() ? " (queries search the DAG)" : " (queries use the closure bitsets)") << "\n";
+        cout << "  " << CYAN << "Index Build Time: " << RESET << formatFixed(index.buildMicros, 1) << " us\n";
+        if (components > 1) {
+            const int shownComponents = 10;
+            const int shownMembers = 12;
+            for (int c = components - 1; c >= 0 && c >= components - shownComponents; c--) {
+                cout << "  C" << (components - 1 - c) << " (" << index.componentSize[c] << "): ";
+                int shown = 0;
+                for (int v = 0; v < locationCount && shown < shownMembers; v++) {
+                    if (index.componentOf[v] != c) continue;
+                    cout << (shown > 0 ? ", " : "") << locations[v].name;
+                    shown++;
+                }
+                if (index.componentSize[c] > shown) cout << ", ... " << index.componentSize[c] - shown << " more";
+                cout << "\n";
+            }
+            if (components > shownComponents) cout << "  ... " << components - shownComponents << " more\n";
+        }
+
+        const BetweennessResult& criticality = currentBetweenness();
+        cout << "\nRoad Criticality (" << (criticality.sampled ? "sampled" : "exact") << " betweenness, "
+             << criticality.sources << " sources):\n";
+        printBetweennessSummary(criticality, 3);
+    }
+
+    shared_ptr<const GraphSnapshot> snapshot = acquireGraphSnapshot();
+    if (snapshot) {
+        cout << CYAN << "Graph Snapshot: " << RESET << "version " << snapshot->version
+             << " (last publish copied " << snapshotBlocksCopied << ", shared " << snapshotBlocksShared << " blocks)\n";
+    }
+}
+
+// ============================================
+// EVENT-DRIVEN TRAFFIC SIMULATOR (TIMING WHEEL)
+// ============================================
+
+const int WHEEL_BITS = 8;
+const int WHEEL_SLOTS = 1 << WHEEL_BITS;   // slots per wheel level
+const int WHEEL_LEVELS = 4;                // 1 s ticks, covers 2^32 s ahead
+
+enum TrafficEventType {
+    CONGESTION_START, CONGESTION_END,
+    INCIDENT_START, INCIDENT_END,
+    CLOSURE_START, CLOSURE_END,
+    NEXT_ARRIVAL        // draws the next random event for the road
+};
+
+struct TrafficEvent {
+    unsigned long long time;    // simulated seconds
+    int roadIndex;
+    int type;
+};
+
+// Hierarchical timing wheel: level L holds events due within 256^(L+1)
+// ticks, in the slot given by the matching 8 bits of their due time. When
+// a lower level wraps, the next slot of the level above is cascaded down.
+// Scheduling and expiry are O(1) per event regardless of queue size.
+struct TimingWheel {
+    unsigned long long now;
+    vector<TrafficEvent> slots[WHEEL_LEVELS][WHEEL_SLOTS];
+};
+
+void wheelSchedule(TimingWheel& wheel, const TrafficEvent& event) {
+    unsigned long long due = max(event.time, wheel.now + 1);
+    unsigned long long delta = due - wheel.now;
+
+    int level = 0;
+    while (level < WHEEL_LEVELS - 1 && delta >= (1ULL << (WHEEL_BITS * (level + 1)))) {
+        level++;
+    }
+    int slot = (int)((due >> (WHEEL_BITS * level)) & (WHEEL_SLOTS - 1));
+
+    TrafficEvent scheduled = event;
+    scheduled.time = due;
+    wheel.slots[level][slot].push_back(scheduled);
+}
+
+// Moves the wheel forward one tick and appends the events now due to 'due'
+void wheelAdvance(TimingWheel& wheel, vector<TrafficEvent>& due) {
+    wheel.now++;
+
+    for (int level = 1; level < WHEEL_LEVELS; level++) {
+        if ((wheel.now & ((1ULL << (WHEEL_BITS * level)) - 1)) != 0) break;
+
+        int slot = (int)((wheel.now >> (WHEEL_BITS * level)) & (WHEEL_SLOTS - 1));
+        vector<TrafficEvent> cascading;
+        cascading.swap(wheel.slots[level][slot]);
+        for (size_t i = 0; i < cascading.size(); i++) {
+            if (cascading[i].time == wheel.now) {
+                due.push_back(cascading[i]);
+            } else {
+                wheelSchedule(wheel, cascading[i]);
+            }
+        }
+    }
+
+    vector<TrafficEvent>& current = wheel.slots[0][wheel.now & (WHEEL_SLOTS - 1)];
+    due.insert(due.end(), current.begin(), current.end());
+    current.clear();
+}
+
+// Road status and availability, saved so a simulation run can be undone
+// Simulations run between these two calls. Journaling is paused meanwhile;
+// if the user keeps the result, only the net change per road is journaled.
+vector<pair<string, bool>> captureRoadStates() {
+    journalPauseDepth++;
+    vector<pair<string, bool>> states(roadCount);
+    for (int i = 0; i < roadCount; i++) {
+        states[i] = make_pair(roads[i].status, roads[i].isAvailable);
+    }
+    return states;
+}
+
+void keepOrRestoreRoadStates(const vector<pair<string, bool>>& savedStates) {
+    journalPauseDepth--;
+    cout << "Keep the simulated road states? (1 = Yes, 0 = No): ";
+    int keep;
+    if (!(cin >> keep) || keep != 1) {
+        if (!cin) clearBuffer();
+        for (int i = 0; i < roadCount && i < (int)savedStates.size(); i++) {
+            roads[i].status = savedStates[i].first;
+            roads[i].isAvailable = savedStates[i].second;
+        }
+        markWeightsChanged();
+        cout << GREEN << "[SUCCESS] Road states restored!\n" << RESET;
+    } else {
+        for (int i = 0; i < roadCount && i < (int)savedStates.size(); i++) {
+            if (roads[i].status != savedStates[i].first || roads[i].isAvailable != savedStates[i].second) {
+                journalRoadState(roads[i]);
+            }
+        }
+        if (!journalCommit()) {
+            printJournalError();
+            return;
+        }
+        cout << GREEN << "[SUCCESS] Simulated road states kept!\n" << RESET;
+    }
+}
+
+struct SimulatedRoadState {
+    string baseStatus;
+    bool baseAvailable;
+    int congestions;    // active overlapping events of each kind
+    int incidents;
+    int closures;
+};
+
+struct TrafficSimulationReport {
+    long long eventsProcessed;
+    long long statusChanges;
+    long long snapshotPublishes;
+    double wallSeconds;
+    long long probeQueries;
+    long long unreachableQueries;
+    double probeSeconds;
+};
+
+// Runs random route queries against the live graph and accumulates timings
+void probeRouting(mt19937_64& rng, int queries, TrafficSimulationReport& report) {
+    if (locationCount < 2) return;
+
+    chrono::steady_clock::time_point started = chrono::steady_clock::now();
+    vector<vector<GraphNode>> forwardGraph, reverseGraph;
+    buildIndexedGraph(forwardGraph, reverseGraph);
+
+    uniform_int_distribution<int> pickLocation(0, locationCount - 1);
+    vector<int> dist, parent;
+    for (int q = 0; q < queries; q++) {
+        int from = pickLocation(rng);
+        int to = pickLocation(rng);
+        dijkstraFromIndex(forwardGraph, from, dist, parent);
+        if (dist[to] == INF_DISTANCE) report.unreachableQueries++;
+        report.probeQueries++;
+    }
+    report.probeSeconds += chrono::duration<double>(chrono::steady_clock::now() - started).count();
+}
+
+// Simulates random congestion, incidents and closures on every road for the
+// given number of hours. Status changes are applied to the live graph once
+// per simulated second (one batch), and every probeInterval seconds a set of
+// random route queries measures routing throughput under the changing graph.
+// Snapshot publication is paused for the run and done once per probe
+// interval, so the event rate measures the wheel and the batches rather than
+// a full snapshot rebuild every simulated second.
+TrafficSimulationReport runTrafficSimulation(double hours, double eventsPerRoadHour,
+                                             unsigned long long seed, int probeInterval) {
+    TrafficSimulationReport report = {0, 0, 0, 0.0, 0, 0, 0.0};
+    mt19937_64 rng(seed);
+
+    // Mean durations in seconds; the event mix is 60% congestion, 30% incident, 10% closure
+    const double MEAN_CONGESTION = 20 * 60.0, MEAN_INCIDENT = 10 * 60.0, MEAN_CLOSURE = 60 * 60.0;
+    exponential_distribution<double> interArrival(eventsPerRoadHour / 3600.0);
+    uniform_real_distribution<double> unit(0.0, 1.0);
+
+    // One simulated road per physical road: the reverse of a bidirectional
+    // road follows it through applyRoadUpdates()
+    vector<SimulatedRoadState> state(roadCount);
+    TimingWheel* wheel = new TimingWheel();
+    wheel->now = 0;
+    for (int i = 0; i < roadCount; i++) {
+        SimulatedRoadState roadState = {roads[i].status, roads[i].isAvailable, 0, 0, 0};
+        state[i] = roadState;
+
+        int reverseIndex = roads[i].isOneWay ? -1 : findRoadIndex(roads[i].toID, roads[i].fromID);
+        if (reverseIndex != -1 && reverseIndex < i) continue;
+
+        TrafficEvent first = {(unsigned long long)(interArrival(rng) + 1), i, NEXT_ARRIVAL};
+        wheelSchedule(*wheel, first);
+    }
+
+    unsigned long long endTime = (unsigned long long)(hours * 3600.0);
+    vector<TrafficEvent> due;
+    vector<int> dirtyRoads;
+    vector<bool> isDirty(roadCount, false);
+    vector<RoadUpdate> batch;
+
+    snapshotPauseDepth++;
+    chrono::steady_clock::time_point started = chrono::steady_clock::now();
+    while (wheel->now < endTime) {
+        due.clear();
+        wheelAdvance(*wheel, due);
+
+        for (size_t e = 0; e < due.size(); e++) {
+            TrafficEvent event = due[e];
+            SimulatedRoadState& road = state[event.roadIndex];
+            report.eventsProcessed++;
+
+            if (event.type == NEXT_ARRIVAL) {
+                double pick = unit(rng);
+                TrafficEvent start = event;
+                TrafficEvent finish = event;
+                double mean;
+                if (pick < 0.6) {
+                    start.type = CONGESTION_START; finish.type = CONGESTION_END; mean = MEAN_CONGESTION;
+                } else if (pick < 0.9) {
+                    start.type = INCIDENT_START; finish.type = INCIDENT_END; mean = MEAN_INCIDENT;
+                } else {
+                    start.type = CLOSURE_START; finish.type = CLOSURE_END; mean = MEAN_CLOSURE;
+                }
+                exponential_distribution<double> duration(1.0 / mean);
+                finish.time = event.time + 1 + (unsigned long long)duration(rng);
+                wheelSchedule(*wheel, finish);
+
+                // Apply the start right away and draw the road's next event
+                event = start;
+                TrafficEvent next = {event.time + 1 + (unsigned long long)interArrival(rng), event.roadIndex, NEXT_ARRIVAL};
+                wheelSchedule(*wheel, next);
+            }
+
+            switch (event.type) {
+                case CONGESTION_START: road.congestions++; break;
+                case CONGESTION_END:   road.congestions--; break;
+                case INCIDENT_START:   road.incidents++; break;
+                case INCIDENT_END:     road.incidents--; break;
+                case CLOSURE_START:    road.closures++; break;
+                case CLOSURE_END:      road.closures--; break;
+            }
+
+            if (!isDirty[event.roadIndex]) {
+                isDirty[event.roadIndex] = true;
+                dirtyRoads.push_back(event.roadIndex);
+            }
+        }
+
+        // One batch per tick: only roads whose effective state changed
+        batch.clear();
+        for (size_t d = 0; d < dirtyRoads.size(); d++) {
+            int i = dirtyRoads[d];
+            isDirty[i] = false;
+            const SimulatedRoadState& road = state[i];
+
+            // Congestion only worsens a road; it never reopens a blocked one
+            string status = road.baseStatus;
+            if (road.incidents > 0) {
+                status = "Blocked";
+            } else if (road.congestions > 0 && status != "Blocked") {
+                status = "Heavy Traffic";
+            }
+            bool available = road.closures > 0 ? false : road.baseAvailable;
+            if (status != roads[i].status || available != roads[i].isAvailable) {
+                RoadUpdate update = {roads[i].fromID, roads[i].toID, status, available ? 1 : 0};
+                batch.push_back(update);
+            }
+        }
+        dirtyRoads.clear();
+        if (!batch.empty()) {
+            report.statusChanges += applyRoadUpdates(batch).applied;
+        }
+
+        if (probeInterval > 0 && wheel->now % probeInterval == 0) {
+            snapshotPauseDepth--;
+            publishGraphSnapshot(vector<int>());
+            snapshotPauseDepth++;
+            report.snapshotPublishes++;
+            probeRouting(rng, 20, report);
+        }
+    }
+    snapshotPauseDepth--;
+    publishGraphSnapshot(vector<int>());
+    report.snapshotPublishes++;
+    report.wallSeconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+
+    delete wheel;
+    return report;
+}
+
+void runTrafficSimulationMenu() {
+    cout << "\nSimulated hours: ";
+    double hours;
+    if (!(cin >> hours) || hours <= 0) {
+        clearBuffer();
+        cout << RED << "[ERROR] Hours must be positive!\n" << RESET;
+        return;
+    }
+
+    cout << "Events per road per hour: ";
+    double eventRate;
+    if (!(cin >> eventRate) || eventRate <= 0) {
+        clearBuffer();
+        cout << RED << "[ERROR] Event rate must be positive!\n" << RESET;
+        return;
+    }
+
+    cout << "Random seed: ";
+    unsigned long long seed;
+    if (!(cin >> seed)) {
+        clearBuffer();
+        cout << RED << "[ERROR] Invalid seed!\n" << RESET;
+        return;
+    }
+
+    vector<pair<string, bool>> savedStates = captureRoadStates();
+
+    TrafficSimulationReport baseline = {0, 0, 0, 0.0, 0, 0, 0.0};
+    mt19937_64 probeRng(seed ^ 0x9E3779B97F4A7C15ULL);
+    probeRouting(probeRng, 200, baseline);
+
+    TrafficSimulationReport report = runTrafficSimulation(hours, eventRate, seed, 300);
+
+    double simulatedHours = hours;
+    displaySection("SIMULATION REPORT");
+    cout << fixed << setprecision(2);
+    cout << CYAN << "Events processed: " << RESET << report.eventsProcessed
+         << " (" << (long long)(report.eventsProcessed / simulatedHours) << " per simulated hour)\n";
+    cout << CYAN << "Road status changes applied: " << RESET << report.statusChanges
+         << " (" << report.snapshotPublishes << " snapshot publishes)\n";
+    double eventSeconds = report.wallSeconds - report.probeSeconds;
+    cout << CYAN << "Wall time: " << RESET << report.wallSeconds * 1000.0 << " ms ("
+         << (eventSeconds > 0 ? (long long)(report.eventsProcessed / eventSeconds) : 0)
+         << " events/s outside the routing probes)\n";
+    if (baseline.probeSeconds > 0 && report.probeSeconds > 0) {
+        double before = baseline.probeQueries / baseline.probeSeconds;
+        double during = report.probeQueries / report.probeSeconds;
+        cout << CYAN << "Routing throughput before: " << RESET << (long long)before << " queries/s\n";
+        cout << CYAN << "Routing throughput during: " << RESET << (long long)during << " queries/s ("
+             << (during - before) * 100.0 / before << "%)\n";
+        cout << CYAN << "Unreachable queries during simulation: " << RESET << report.unreachableQueries
+             << "/" << report.probeQueries << "\n";
+    }
+    closeSectionBorder();
+
+    keepOrRestoreRoadStates(savedStates);
+}
+
+// ============================================
+// FLEET SIMULATION (MULTI-THREADED)
+// ============================================
+
+const int FLEET_TICK_SECONDS = 5;
+const int FLEET_CHUNK = 1024;               // vehicles per parallel job
+const double FLEET_VEHICLES_PER_KM = 60.0;  // road capacity per km per direction
+const double FLEET_HEAVY_DENSITY = 0.8;     // occupancy/capacity that turns a road Heavy Traffic
+const double FLEET_CLEAR_DENSITY = 0.5;     // ... and that clears it again (hysteresis)
+const int FLEET_MAX_VEHICLES = 200000;      // each keeps its own planned route
+
+// Vehicle state stored as parallel arrays (structure of arrays) so each
+// tick streams through memory. Planned routes are stored back to back in
+// one pool per chunk of FLEET_CHUNK vehicles, so a route takes as many
+// slots as it has roads and each pool is only touched by the worker
+// running its chunk. Replaced routes leave garbage that is compacted once
+// a pool has doubled since its last compaction.
+struct Fleet {
+    int size;
+    vector<int> currentRoad;        // road index being driven, -1 while at a location
+    vector<int> atLocation;         // location index when not on a road
+    vector<int> destination;        // location index
+    vector<float> progressKm;       // distance covered on the current road
+    vector<unsigned int> rngState;  // per-vehicle xorshift state
+    vector<int> routeStart;         // offset of the planned route in its chunk's pool
+    vector<int> routeLength;
+    vector<int> routeCursor;        // next road to take in the planned route
+    vector<int> failedAtReopening;  // reopenings count at the last failed search, -1 if none
+    vector<vector<int>> routePools; // per chunk
+    vector<size_t> compactedSize;   // per chunk, pool size after its last compaction
+};
+
+// Outgoing roads of every location in one flat array, built once per run
+// because the simulation never adds or removes roads. Only the weights
+// change; they are refreshed after every batch of status updates.
+struct FleetGraph {
+    vector<int> firstRoad;          // locationCount + 1 offsets into roadsOut
+    vector<int> roadsOut;           // road indices grouped by source location
+    vector<int> roadSource;         // location index of each road's start
+    vector<int> roadTarget;         // ... and of its end
+    vector<int> roadWeight;         // roadTravelWeight(), -1 while the road cannot be driven
+};
+
+// Per-worker search state. Only the locations a search touched are reset,
+// so a route search costs what it explores, not the size of the network.
+struct FleetSearch {
+    vector<int> dist;
+    vector<int> viaRoad;
+    vector<int> touched;
+    vector<pair<int, int>> heap;
+    vector<int> path;
+};
+
+// Per-worker accumulators, merged after each parallel phase
+struct FleetWorkerTotals {
+    vector<int> occupancy;          // vehicles per road
+    long long arrivals;
+    long long reroutes;
+    long long unroutable;
+};
+
+struct FleetSimulationReport {
+    long long ticks;
+    double wallSeconds;
+    long long arrivals;
+    long long reroutes;
+    long long unroutable;
+    int peakHeavyRoads;
+    int incidents;
+    size_t peakRouteSlots;
+};
+
+unsigned int fleetRandom(unsigned int& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+void buildFleetGraph(FleetGraph& graph) {
+    graph.firstRoad.assign(locationCount + 1, 0);
+    graph.roadSource.resize(roadCount);
+    graph.roadTarget.resize(roadCount);
+    graph.roadWeight.resize(roadCount);
+    for (int i = 0; i < roadCount; i++) {
+        graph.roadSource[i] = findLocationIndexByID(roads[i].fromID);
+        graph.roadTarget[i] = findLocationIndexByID(roads[i].toID);
+        graph.roadWeight[i] = roadTravelWeight(roads[i]);
+        graph.firstRoad[graph.roadSource[i] + 1]++;
+    }
+    for (int u = 0; u < locationCount; u++) graph.firstRoad[u + 1] += graph.firstRoad[u];
+
+    vector<int> filled(graph.firstRoad.begin(), graph.firstRoad.end() - 1);
+    graph.roadsOut.resize(roadCount);
+    for (int i = 0; i < roadCount; i++) graph.roadsOut[filled[graph.roadSource[i]]++] = i;
+}
+
+// Drops the driven and replaced parts of a chunk's routes
+void compactFleetRoutes(Fleet& fleet, int chunk) {
+    vector<int>& pool = fleet.routePools[chunk];
+    vector<int> live;
+    int end = min(fleet.size, (chunk + 1) * FLEET_CHUNK);
+    for (int v = chunk * FLEET_CHUNK; v < end; v++) {
+        int remaining = fleet.routeLength[v] - fleet.routeCursor[v];
+        int start = (int)live.size();
+        if (remaining > 0) {
+            int from = fleet.routeStart[v] + fleet.routeCursor[v];
+            live.insert(live.end(), pool.begin() + from, pool.begin() + from + remaining);
+        }
+        fleet.routeStart[v] = start;
+        fleet.routeLength[v] = max(remaining, 0);
+        fleet.routeCursor[v] = 0;
+    }
+    pool.swap(live);
+    fleet.compactedSize[chunk] = pool.size();
+}
+
+// Plans vehicle v's route from location 'from' with one Dijkstra search
+// that stops at its destination. Returns false if the destination cannot
+// be reached right now.
+bool planFleetRoute(Fleet& fleet, int v, int from, const FleetGraph& graph,
+                    int reopenings, FleetSearch& search) {
+    int target = fleet.destination[v];
+    greater<pair<int, int>> later;
+    bool found = false;
+
+    search.dist[from] = 0;
+    search.touched.push_back(from);
+    search.heap.push_back(make_pair(0, from));
+    while (!search.heap.empty()) {
+        pop_heap(search.heap.begin(), search.heap.end(), later);
+        int d = search.heap.back().first;
+        int u = search.heap.back().second;
+        search.heap.pop_back();
+        if (d > search.dist[u]) continue;
+        if (u == target) {
+            found = true;
+            break;
+        }
+
+        for (int k = graph.firstRoad[u]; k < graph.firstRoad[u + 1]; k++) {
+            int road = graph.roadsOut[k];
+            if (graph.roadWeight[road] < 0) continue;
+            int next = graph.roadTarget[road];
+            int nd = d + graph.roadWeight[road];
+            if (search.dist[next] == INF_DISTANCE) search.touched.push_back(next);
+            if (nd < search.dist[next]) {
+                search.dist[next] = nd;
+                search.viaRoad[next] = road;
+                search.heap.push_back(make_pair(nd, next));
+                push_heap(search.heap.begin(), search.heap.end(), later);
+            }
+        }
     }
 
-    cout << "Is this road available (not under construction)? (1 = Yes, 0 = No): ";
-    int availableChoice;
-    if (!(cin >> availableChoice) || (availableChoice != 0 && availableChoice != 1)) {
-        clearBuffer();
-        cout << RED << "[ERROR] Invalid input! Using available (Yes) by default.\n" << RESET;
-        isAvailable = true;
-    } else {
-        isAvailable = (availableChoice == 1);
+    search.path.clear();
+    for (int u = target; found && u != from; u = graph.roadSource[search.viaRoad[u]]) {
+        search.path.push_back(search.viaRoad[u]);
     }
+    for (size_t i = 0; i < search.touched.size(); i++) search.dist[search.touched[i]] = INF_DISTANCE;
+    search.touched.clear();
+    search.heap.clear();
 
-    roads[roadCount].fromID = fromID;
-    roads[roadCount].toID = toID;
-    roads[roadCount].distance = distance;
-    roads[roadCount].status = status;
-    roads[roadCount].isOneWay = isOneWay;
-    roads[roadCount].isAvailable = isAvailable;
-    roadCount++;
+    fleet.routeCursor[v] = 0;
+    if (!found) {
+        fleet.routeLength[v] = 0;
+        fleet.failedAtReopening[v] = reopenings;
+        return false;
+    }
 
-    if (!isOneWay) {
-        if (roadCount < MAX_ROADS && !roadExists(toID, fromID)) {
-            roads[roadCount].fromID = toID;
-            roads[roadCount].toID = fromID;
-            roads[roadCount].distance = distance;
-            roads[roadCount].status = status;
-            roads[roadCount].isOneWay = false;
-            roads[roadCount].isAvailable = isAvailable;
-            roadCount++;
-            cout << GREEN << "[SUCCESS] Bidirectional road added successfully!\n" << RESET;
-        } else {
-            cout << YELLOW << "[WARNING] Forward road added, but couldn't add reverse direction.\n" << RESET;
-        }
-    } else {
-        cout << GREEN << "[SUCCESS] One-way road added successfully!\n" << RESET;
+    int chunk = v / FLEET_CHUNK;
+    vector<int>& pool = fleet.routePools[chunk];
+    fleet.routeLength[v] = 0;
+    if (pool.size() > 2 * fleet.compactedSize[chunk] + 16 * (size_t)FLEET_CHUNK) {
+        compactFleetRoutes(fleet, chunk);
     }
+    fleet.routeStart[v] = (int)pool.size();
+    fleet.routeLength[v] = (int)search.path.size();
+    pool.insert(pool.end(), search.path.rbegin(), search.path.rend());
+    fleet.failedAtReopening[v] = -1;
+    return true;
 }
 
-void viewRoads() {
-    if (roadCount == 0) {
-        cout << YELLOW << "\n[INFO] No roads added yet.\n" << RESET;
-        return;
+void pickFleetDestination(Fleet& fleet, int v, int from) {
+    int destination = (int)(fleetRandom(fleet.rngState[v]) % (unsigned int)locationCount);
+    if (destination == from) {
+        destination = (destination + 1) % locationCount;
+    }
+    fleet.destination[v] = destination;
+}
+
+// Simulates 'vehicleCount' vehicles driving between random locations on the
+// live road graph. Vehicles are advanced in parallel chunks; road occupancy
+// is then reduced and turned into Heavy Traffic status, random incidents
+// block roads, and vehicles whose planned route hits a blocked or
+// unavailable road are re-routed. Each route is one search from the
+// vehicle's location, so memory grows with the vehicles' route lengths and
+// nothing is rebuilt when only weights change.
+FleetSimulationReport runFleetSimulation(int vehicleCount, int tickCount, double incidentsPerHour,
+                                         unsigned int seed) {
+    FleetSimulationReport report = {0, 0.0, 0, 0, 0, 0, 0, 0};
+
+    FleetGraph graph;
+    buildFleetGraph(graph);
+    vector<int> roadPartner(roadCount);
+    for (int i = 0; i < roadCount; i++) {
+        roadPartner[i] = roads[i].isOneWay ? -1 : findRoadIndex(roads[i].toID, roads[i].fromID);
     }
 
-    displaySection("ALL ROADS");
+    int chunks = (vehicleCount + FLEET_CHUNK - 1) / FLEET_CHUNK;
+    Fleet fleet;
+    fleet.size = vehicleCount;
+    fleet.currentRoad.assign(vehicleCount, -1);
+    fleet.atLocation.assign(vehicleCount, 0);
+    fleet.destination.assign(vehicleCount, 0);
+    fleet.progressKm.assign(vehicleCount, 0.0f);
+    fleet.rngState.assign(vehicleCount, 0);
+    fleet.routeStart.assign(vehicleCount, 0);
+    fleet.routeLength.assign(vehicleCount, 0);
+    fleet.routeCursor.assign(vehicleCount, 0);
+    fleet.failedAtReopening.assign(vehicleCount, -1);
+    fleet.routePools.assign(chunks, vector<int>());
+    fleet.compactedSize.assign(chunks, 0);
+
+    vector<FleetWorkerTotals> workers(parallelWorkerCount(chunks));
+    vector<FleetSearch> searches(workers.size());
+    for (size_t w = 0; w < searches.size(); w++) {
+        searches[w].dist.assign(locationCount, INF_DISTANCE);
+        searches[w].viaRoad.assign(locationCount, -1);
+    }
+    int reopenings = 0;     // roads that became drivable again; failed searches wait for one
+
+    parallelFor(chunks, [&](int chunk, int worker) {
+        int end = min(vehicleCount, (chunk + 1) * FLEET_CHUNK);
+        for (int v = chunk * FLEET_CHUNK; v < end; v++) {
+            fleet.rngState[v] = seed * 2654435761u + (unsigned int)v * 40503u + 1u;
+            fleet.atLocation[v] = (int)(fleetRandom(fleet.rngState[v]) % (unsigned int)locationCount);
+            pickFleetDestination(fleet, v, fleet.atLocation[v]);
+            planFleetRoute(fleet, v, fleet.atLocation[v], graph, reopenings, searches[worker]);
+        }
+    });
+
+    vector<double> speedKmPerTick(roadCount);
+    vector<bool> usable(roadCount);
+    vector<bool> madeHeavy(roadCount, false);
+    vector<unsigned long long> incidentEnds(roadCount, 0);
+    vector<string> statusBeforeIncident(roadCount);
+    mt19937 rng(seed);
+    uniform_real_distribution<double> unit(0.0, 1.0);
+    double incidentChance = incidentsPerHour * FLEET_TICK_SECONDS / 3600.0;
+
+    chrono::steady_clock::time_point started = chrono::steady_clock::now();
+    for (int tick = 0; tick < tickCount; tick++) {
+        unsigned long long now = (unsigned long long)tick * FLEET_TICK_SECONDS;
+        for (int i = 0; i < roadCount; i++) {
+            double minutes = roadTravelMinutes(roads[i]);
+            usable[i] = minutes >= 0;
+            speedKmPerTick[i] = usable[i] ? roads[i].distance / minutes / 60.0 * FLEET_TICK_SECONDS
+                                          : roads[i].speedLimit / 3600.0 * FLEET_TICK_SECONDS;
+        }
+        for (size_t w = 0; w < workers.size(); w++) {
+            workers[w].occupancy.assign(roadCount, 0);
+        }
+
+        // Parallel phase: advance every vehicle and count road occupancy
+        parallelFor(chunks, [&](int chunk, int worker) {
+            FleetWorkerTotals& totals = workers[worker];
+            FleetSearch& search = searches[worker];
+            int end = min(vehicleCount, (chunk + 1) * FLEET_CHUNK);
+            for (int v = chunk * FLEET_CHUNK; v < end; v++) {
+                int road = fleet.currentRoad[v];
+                if (road != -1) {
+                    fleet.progressKm[v] += (float)speedKmPerTick[road];
+                    if (fleet.progressKm[v] >= roads[road].distance) {
+                        fleet.atLocation[v] = graph.roadTarget[road];
+                        fleet.currentRoad[v] = -1;
+                    } else {
+                        totals.occupancy[road]++;
+                    }
+                    continue;
+                }
 
-    cout << "| " << left << setw(6) << "From" << "| " << left << setw(6) << "To"
-         << "| " << left << setw(10) << "Distance" << "| " << left << setw(17) << "Status"
-         << "| " << left << setw(10) << "Direction" << "| " << left << setw(12) << "Available" << "|\n";
-    cout << "+-------+-------+------------+-------------------+------------+--------------+\n";
+                int here = fleet.atLocation[v];
+                if (here == fleet.destination[v]) {
+                    totals.arrivals++;
+                    pickFleetDestination(fleet, v, here);
+                    if (!planFleetRoute(fleet, v, here, graph, reopenings, search)) totals.unroutable++;
+                }
+                if (fleet.routeCursor[v] >= fleet.routeLength[v]) {
+                    if (fleet.failedAtReopening[v] == reopenings) continue;   // nothing reopened since
+                    if (!planFleetRoute(fleet, v, here, graph, reopenings, search)) continue;
+                }
 
-    for (int i = 0; i < roadCount; i++) {
-        string statusColor = RESET;
-        if (roads[i].status == "Normal") statusColor = GREEN;
-        else if (roads[i].status == "Heavy Traffic") statusColor = YELLOW;
-        else if (roads[i].status == "Blocked") statusColor = RED;
-
-        string direction = roads[i].isOneWay ? "One-Way" : "Both";
-        string available = roads[i].isAvailable ? "Yes" : "No";
-        string availColor = roads[i].isAvailable ? GREEN : RED;
-
-        cout << "| " << left << setw(6) << roads[i].fromID
-             << "| " << left << setw(6) << roads[i].toID
-             << "| " << YELLOW << left << setw(10) << (to_string(roads[i].distance) + " km") << RESET
-             << "| " << statusColor << left << setw(17) << roads[i].status << RESET
-             << "| " << CYAN << left << setw(10) << direction << RESET
-             << "| " << availColor << left << setw(12) << available << RESET << "|\n";
+                int next = fleet.routePools[chunk][fleet.routeStart[v] + fleet.routeCursor[v]];
+                if (graph.roadWeight[next] < 0) continue;    // waits for the re-route pass
+                fleet.routeCursor[v]++;
+                fleet.currentRoad[v] = next;
+                fleet.progressKm[v] = 0.0f;
+                totals.occupancy[next]++;
+            }
+        });
+
+        // Serial phase: occupancy feeds back into road status, incidents come and go
+        vector<int> occupancy(roadCount, 0);
+        for (size_t w = 0; w < workers.size(); w++) {
+            for (int i = 0; i < roadCount; i++) occupancy[i] += workers[w].occupancy[i];
+        }
+
+        vector<RoadUpdate> batch;
+        int heavyRoads = 0;
+        for (int i = 0; i < roadCount; i++) {
+            if (roadPartner[i] != -1 && roadPartner[i] < i) continue;   // handled with its partner
+
+            int vehicles = occupancy[i] + (roadPartner[i] != -1 ? occupancy[roadPartner[i]] : 0);
+            double capacity = roads[i].distance * FLEET_VEHICLES_PER_KM * (roadPartner[i] != -1 ? 2 : 1);
+            double density = vehicles / capacity;
+
+            if (incidentEnds[i] != 0 && now >= incidentEnds[i]) {
+                incidentEnds[i] = 0;
+                RoadUpdate update = {roads[i].fromID, roads[i].toID, statusBeforeIncident[i], -1};
+                batch.push_back(update);
+            } else if (incidentEnds[i] == 0 && roads[i].status == "Normal" && density > FLEET_HEAVY_DENSITY) {
+                madeHeavy[i] = true;
+                RoadUpdate update = {roads[i].fromID, roads[i].toID, "Heavy Traffic", -1};
+                batch.push_back(update);
+            } else if (madeHeavy[i] && roads[i].status == "Heavy Traffic" && density < FLEET_CLEAR_DENSITY) {
+                madeHeavy[i] = false;
+                RoadUpdate update = {roads[i].fromID, roads[i].toID, "Normal", -1};
+                batch.push_back(update);
+            }
+            if (roads[i].status == "Heavy Traffic") heavyRoads++;
+        }
+        report.peakHeavyRoads = max(report.peakHeavyRoads, heavyRoads);
+
+        if (incidentChance > 0 && unit(rng) < incidentChance) {
+            int road = (int)(unit(rng) * roadCount) % roadCount;
+            if (roadPartner[road] != -1 && roadPartner[road] < road) road = roadPartner[road];
+            if (roads[road].status != "Blocked" && incidentEnds[road] == 0) {
+                exponential_distribution<double> duration(1.0 / (15 * 60.0));
+                incidentEnds[road] = now + 1 + (unsigned long long)duration(rng);
+                statusBeforeIncident[road] = roads[road].status;
+                RoadUpdate update = {roads[road].fromID, roads[road].toID, "Blocked", -1};
+                batch.push_back(update);
+                report.incidents++;
+            }
+        }
+
+        // New weights for later searches. Planned routes keep their roads
+        // through weight changes; only vehicles whose remaining route uses
+        // a road that can no longer be driven are re-routed.
+        bool closed = false;
+        if (!batch.empty()) {
+            applyRoadUpdates(batch);
+            for (int i = 0; i < roadCount; i++) {
+                int weight = roadTravelWeight(roads[i]);
+                if (weight >= 0 && graph.roadWeight[i] < 0) reopenings++;
+                if (weight < 0 && graph.roadWeight[i] >= 0) closed = true;
+                graph.roadWeight[i] = weight;
+            }
+        }
+        if (closed) {
+            parallelFor(chunks, [&](int chunk, int worker) {
+                FleetWorkerTotals& totals = workers[worker];
+                int end = min(vehicleCount, (chunk + 1) * FLEET_CHUNK);
+                for (int v = chunk * FLEET_CHUNK; v < end; v++) {
+                    bool blocked = false;
+                    for (int k = fleet.routeCursor[v]; k < fleet.routeLength[v] && !blocked; k++) {
+                        blocked = graph.roadWeight[fleet.routePools[chunk][fleet.routeStart[v] + k]] < 0;
+                    }
+                    if (!blocked) continue;
+
+                    int from = fleet.currentRoad[v] != -1 ? graph.roadTarget[fleet.currentRoad[v]] : fleet.atLocation[v];
+                    totals.reroutes++;
+                    if (!planFleetRoute(fleet, v, from, graph, reopenings, searches[worker])) totals.unroutable++;
+                }
+            });
+        }
+
+        size_t routeSlots = 0;
+        for (int c = 0; c < chunks; c++) routeSlots += fleet.routePools[c].size();
+        report.peakRouteSlots = max(report.peakRouteSlots, routeSlots);
+        report.ticks++;
     }
-    closeSectionBorder();
+    report.wallSeconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+
+    for (size_t w = 0; w < workers.size(); w++) {
+        report.arrivals += workers[w].arrivals;
+        report.reroutes += workers[w].reroutes;
+        report.unroutable += workers[w].unroutable;
+    }
+    return report;
 }
 
-void deleteRoad() {
-    if (roadCount == 0) {
-        cout << YELLOW << "\n[INFO] No roads available to delete.\n" << RESET;
+void runFleetSimulationMenu() {
+    if (locationCount < 2) {
+        cout << YELLOW << "\n[INFO] Add at least 2 locations first.\n" << RESET;
         return;
     }
 
-    viewRoads();
-
-    int fromID, toID;
-    cout << "\nEnter From Location ID: ";
-    if (!(cin >> fromID)) {
+    cout << "\nNumber of vehicles: ";
+    int vehicleCount;
+    if (!(cin >> vehicleCount) || vehicleCount <= 0 || vehicleCount > FLEET_MAX_VEHICLES) {
         clearBuffer();
-        cout << RED << "[ERROR] Invalid input!\n" << RESET;
+        cout << RED << "[ERROR] Number of vehicles must be 1 to " << FLEET_MAX_VEHICLES << "!\n" << RESET;
         return;
     }
 
-    cout << "Enter To Location ID: ";
-    if (!(cin >> toID)) {
+    cout << "Number of ticks (" << FLEET_TICK_SECONDS << " simulated seconds each): ";
+    int tickCount;
+    if (!(cin >> tickCount) || tickCount <= 0) {
         clearBuffer();
-        cout << RED << "[ERROR] Invalid input!\n" << RESET;
+        cout << RED << "[ERROR] Invalid number of ticks!\n" << RESET;
         return;
     }
 
-    int foundIndex = -1;
-    for (int i = 0; i < roadCount; i++) {
-        if (roads[i].fromID == fromID && roads[i].toID == toID) {
-            foundIndex = i;
-            break;
-        }
+    cout << "Random incidents per simulated hour (0 for none): ";
+    double incidentsPerHour;
+    if (!(cin >> incidentsPerHour) || incidentsPerHour < 0) {
+        clearBuffer();
+        cout << RED << "[ERROR] Invalid incident rate!\n" << RESET;
+        return;
     }
 
-    if (foundIndex == -1) {
-        cout << RED << "[ERROR] Road not found!\n" << RESET;
+    cout << "Random seed: ";
+    unsigned int seed;
+    if (!(cin >> seed)) {
+        clearBuffer();
+        cout << RED << "[ERROR] Invalid seed!\n" << RESET;
         return;
     }
 
-    bool wasOneWay = roads[foundIndex].isOneWay;
+    vector<pair<string, bool>> savedStates = captureRoadStates();
+    FleetSimulationReport report = runFleetSimulation(vehicleCount, tickCount, incidentsPerHour, seed);
+
+    displaySection("FLEET SIMULATION REPORT");
+    cout << fixed << setprecision(2);
+    cout << CYAN << "Vehicles: " << RESET << vehicleCount << " on "
+         << parallelWorkerCount((vehicleCount + FLEET_CHUNK - 1) / FLEET_CHUNK) << " thread(s)\n";
+    cout << CYAN << "Ticks: " << RESET << report.ticks << " (" << report.ticks * FLEET_TICK_SECONDS / 60.0
+         << " simulated minutes)\n";
+    cout << CYAN << "Wall time: " << RESET << report.wallSeconds * 1000.0 << " ms ("
+         << (report.wallSeconds > 0 ? report.ticks / report.wallSeconds : 0.0) << " ticks/s)\n";
+    cout << CYAN << "Trips completed: " << RESET << report.arrivals << "\n";
+    cout << CYAN << "Random incidents: " << RESET << report.incidents << "\n";
+    cout << CYAN << "Re-routes: " << RESET << report.reroutes << " ("
+         << report.reroutes * 1000.0 / ((double)vehicleCount * report.ticks) << " per 1000 vehicle-ticks)\n";
+    cout << CYAN << "Failed routings (unreachable): " << RESET << report.unroutable << "\n";
+    cout << CYAN << "Peak roads in Heavy Traffic: " << RESET << report.peakHeavyRoads << "\n";
+    cout << CYAN << "Peak route storage: " << RESET << report.peakRouteSlots * sizeof(int) / 1024 << " KB\n";
+    closeSectionBorder();
 
-    // Shift elements left to delete
-    for (int i = foundIndex; i < roadCount - 1; i++) {
-        roads[i] = roads[i + 1];
-    }
-    roadCount--;
+    keepOrRestoreRoadStates(savedStates);
+}
 
-    // If bidirectional, also delete reverse direction
-    if (!wasOneWay) {
-        for (int i = 0; i < roadCount; i++) {
-            if (roads[i].fromID == toID && roads[i].toID == fromID) {
-                for (int j = i; j < roadCount - 1; j++) {
-                    roads[j] = roads[j + 1];
-                }
-                roadCount--;
-                break;
-            }
+// ============================================
+// WHAT-IF SCENARIOS (COPY-ON-WRITE OVERLAYS)
+// ============================================
+
+// A scenario is a list of road status/availability overrides in traffic
+// feed form. It is evaluated on its own snapshot derived from the published
+// one: only the edge blocks of locations whose roads it overrides are
+// rebuilt, every other block is shared with the base, and the live roads
+// are never touched. Scenarios are independent, so they run in parallel.
+
+struct Scenario {
+    string name;
+    vector<RoadUpdate> overrides;
+};
+
+struct ScenarioReport {
+    int overridesApplied;
+    int overridesNotFound;
+    int blocksCopied;
+    vector<int> distances;      // per origin-destination pair
+};
+
+vector<Scenario> scenarios;
+
+// Resolved on the main thread so workers never touch the lazy hash indexes
+struct ScenarioBase {
+    shared_ptr<const GraphSnapshot> snapshot;
+    vector<int> roadFrom, roadTo;           // location index of each road's ends
+    vector<vector<int>> outgoingRoads;      // road indices by source location
+};
+
+// Overridden copies of the affected roads, keyed by road index; the reverse
+// direction of a bidirectional road follows, as in applyRoadUpdates()
+map<int, Road> resolveScenario(const Scenario& scenario, ScenarioReport& report) {
+    map<int, Road> overridden;
+    for (size_t u = 0; u < scenario.overrides.size(); u++) {
+        const RoadUpdate& update = scenario.overrides[u];
+        int roadIndex = findRoadIndex(update.fromID, update.toID);
+        if (roadIndex == -1 || (!update.status.empty() && !isValidRoadStatus(update.status))) {
+            report.overridesNotFound++;
+            continue;
         }
+        int reverseIndex = roads[roadIndex].isOneWay ? -1 : findRoadIndex(update.toID, update.fromID);
+        for (int k = 0; k < 2; k++) {
+            int index = (k == 0) ? roadIndex : reverseIndex;
+            if (index == -1) continue;
+            if (!overridden.count(index)) overridden[index] = roads[index];
+            if (!update.status.empty()) overridden[index].status = update.status;
+            if (update.availability != -1) overridden[index].isAvailable = (update.availability == 1);
+        }
+        report.overridesApplied++;
     }
+    return overridden;
+}
 
-    cout << GREEN << "[SUCCESS] Road deleted successfully!\n" << RESET;
+// Safe to call from worker threads
+shared_ptr<const GraphSnapshot> buildScenarioSnapshot(const ScenarioBase& base, const map<int, Road>& overridden,
+                                                      int& blocksCopied) {
+    shared_ptr<GraphSnapshot> overlay = make_shared<GraphSnapshot>(*base.snapshot);    // copies block pointers only
+    set<int> affected;
+    for (map<int, Road>::const_iterator it = overridden.begin(); it != overridden.end(); ++it) {
+        if (base.roadFrom[it->first] != -1) affected.insert(base.roadFrom[it->first]);
+    }
+
+    for (set<int>::iterator it = affected.begin(); it != affected.end(); ++it) {
+        int v = *it;
+        EdgeBlock block;
+        for (size_t k = 0; k < base.outgoingRoads[v].size(); k++) {
+            int r = base.outgoingRoads[v][k];
+            map<int, Road>::const_iterator changed = overridden.find(r);
+            int weight = roadTravelWeight(changed != overridden.end() ? changed->second : roads[r]);
+            if (weight < 0 || base.roadTo[r] == -1) continue;
+
+            GraphNode edge;
+            edge.destination = base.roadTo[r];
+            edge.distance = weight;
+            edge.roadIndex = r;
+            block.push_back(edge);
+        }
+        replaceSnapshotBlock(*overlay, v, make_shared<const EdgeBlock>(block));
+    }
+    blocksCopied = (int)affected.size();
+    return overlay;
 }
 
-void updateRoadDistance() {
-    if (roadCount == 0) {
-        cout << YELLOW << "\n[INFO] No roads available.\n" << RESET;
-        return;
+// Distances for every pair, one search per distinct origin
+void scenarioPairDistances(const GraphSnapshot& snapshot, const vector<pair<int, int>>& pairs, vector<int>& distances) {
+    distances.assign(pairs.size(), INF_DISTANCE);
+    vector<int> dist;
+    int searchedFrom = -1;
+    for (size_t p = 0; p < pairs.size(); p++) {
+        if (pairs[p].first != searchedFrom) {
+            searchedFrom = pairs[p].first;
+            snapshotDijkstra(snapshot, searchedFrom, dist);
+        }
+        distances[p] = dist[pairs[p].second];
     }
+}
 
-    viewRoads();
+// [name] starts a scenario; the lines after it are traffic feed lines
+void readScenarios(istream& in, vector<Scenario>& loaded, int& badLines) {
+    string line;
+    while (getline(in, line)) {
+        if (!line.empty() && line[line.size() - 1] == '\r') line.erase(line.size() - 1);
+        if (line.empty() || line[0] == '#') continue;
+        if (line[0] == '[' && line[line.size() - 1] == ']') {
+            Scenario scenario;
+            scenario.name = line.substr(1, line.size() - 2);
+            loaded.push_back(scenario);
+            continue;
+        }
 
-    int fromID, toID, newDistance;
-    cout << "\nEnter From Location ID: ";
-    if (!(cin >> fromID)) {
-        clearBuffer();
-        cout << RED << "[ERROR] Invalid input!\n" << RESET;
+        RoadUpdate update;
+        if (!loaded.empty() && parseRoadUpdateLine(line, update)) {
+            loaded.back().overrides.push_back(update);
+        } else {
+            badLines++;
+        }
+    }
+}
+
+void evaluateScenarios() {
+    if (scenarios.empty()) {
+        cout << YELLOW << "\n[INFO] No scenarios defined.\n" << RESET;
         return;
     }
 
-    cout << "Enter To Location ID: ";
-    if (!(cin >> toID)) {
+    cout << "\nNumber of origin-destination pairs (0 = every pair): ";
+    int pairCount;
+    if (!(cin >> pairCount) || pairCount < 0) {
         clearBuffer();
         cout << RED << "[ERROR] Invalid input!\n" << RESET;
         return;
     }
-
-    cout << "Enter new distance (km): ";
-    if (!(cin >> newDistance) || newDistance <= 0) {
-        clearBuffer();
-        cout << RED << "[ERROR] Distance must be positive!\n" << RESET;
+    vector<pair<int, int>> pairs;
+    if (pairCount == 0) {
+        for (int s = 0; s < locationCount; s++) {
+            for (int t = 0; t < locationCount; t++) {
+                if (s != t) pairs.push_back(make_pair(s, t));
+            }
+        }
+    }
+    for (int p = 0; p < pairCount; p++) {
+        int fromID, toID;
+        cout << "Pair " << (p + 1) << " (from to): ";
+        if (!(cin >> fromID >> toID) || !locationExists(fromID) || !locationExists(toID)) {
+            clearBuffer();
+            cout << RED << "[ERROR] Invalid location IDs!\n" << RESET;
+            return;
+        }
+        pairs.push_back(make_pair(findLocationIndexByID(fromID), findLocationIndexByID(toID)));
+    }
+    if (pairs.empty()) {
+        cout << YELLOW << "[INFO] No pairs to evaluate.\n" << RESET;
         return;
     }
+    vector<size_t> pairOrder(pairs.size());
+    for (size_t p = 0; p < pairs.size(); p++) pairOrder[p] = p;
+    stable_sort(pairOrder.begin(), pairOrder.end(),
+                [&pairs](size_t a, size_t b) { return pairs[a].first < pairs[b].first; });
+    vector<pair<int, int>> sortedPairs(pairs.size());
+    for (size_t p = 0; p < pairs.size(); p++) sortedPairs[p] = pairs[pairOrder[p]];
+
+    TraceSpan span("evaluate scenarios", "traffic");
+    chrono::steady_clock::time_point started = chrono::steady_clock::now();
+    ScenarioBase base;
+    base.snapshot = expandGraphSnapshot(acquireGraphSnapshot());
+    base.roadFrom.resize(roadCount);
+    base.roadTo.resize(roadCount);
+    base.outgoingRoads.assign(locationCount, vector<int>());
+    for (int r = 0; r < roadCount; r++) {
+        base.roadFrom[r] = findLocationIndexByID(roads[r].fromID);
+        base.roadTo[r] = findLocationIndexByID(roads[r].toID);
+        if (base.roadFrom[r] != -1) base.outgoingRoads[base.roadFrom[r]].push_back(r);
+    }
 
-    bool found = false;
-    bool wasOneWay = false;
-    for (int i = 0; i < roadCount; i++) {
-        if (roads[i].fromID == fromID && roads[i].toID == toID) {
-            roads[i].distance = newDistance;
-            wasOneWay = roads[i].isOneWay;
-            found = true;
+    vector<int> baseDistances;
+    scenarioPairDistances(*base.snapshot, sortedPairs, baseDistances);
 
-            if (!wasOneWay) {
-                for (int j = 0; j < roadCount; j++) {
-                    if (roads[j].fromID == toID && roads[j].toID == fromID) {
-                        roads[j].distance = newDistance;
-                        break;
-                    }
-                }
+    int count = (int)scenarios.size();
+    vector<ScenarioReport> reports(count);
+    vector<map<int, Road>> overridden(count);
+    for (int i = 0; i < count; i++) {
+        reports[i].overridesApplied = reports[i].overridesNotFound = reports[i].blocksCopied = 0;
+        overridden[i] = resolveScenario(scenarios[i], reports[i]);
+    }
+    parallelFor(count, [&](int i, int) {
+        shared_ptr<const GraphSnapshot> overlay = buildScenarioSnapshot(base, overridden[i], reports[i].blocksCopied);
+        scenarioPairDistances(*overlay, sortedPairs, reports[i].distances);
+    });
+    double elapsedMs = chrono::duration<double, milli>(chrono::steady_clock::now() - started).count();
+    span.counter("scenarios", count);
+    span.counter("pairs", (long long)pairs.size());
+
+    displaySection("WHAT-IF SCENARIOS");
+    cout << CYAN << left << setw(20) << "Scenario" << setw(10) << "Roads" << setw(10) << "Blocks"
+         << setw(12) << "Avg Delta" << setw(12) << "Max Delta" << setw(10) << "Cut Off" << "Worst Pair" << RESET << "\n";
+    for (int i = 0; i < count; i++) {
+        const ScenarioReport& report = reports[i];
+        long long deltaTotal = 0;
+        int compared = 0, cutOff = 0, worst = -1, worstDelta = 0;
+        for (size_t p = 0; p < sortedPairs.size(); p++) {
+            int before = baseDistances[p], after = report.distances[p];
+            if (before == INF_DISTANCE) continue;
+            if (after == INF_DISTANCE) {
+                cutOff++;
+                continue;
             }
+            deltaTotal += after - before;
+            compared++;
+            if (worst == -1 || after - before > worstDelta) {
+                worst = (int)p;
+                worstDelta = after - before;
+            }
+        }
+        string worstText = "-";
+        if (worst != -1 && worstDelta > 0) {
+            worstText = to_string(locations[sortedPairs[worst].first].id) + "->" +
+                        to_string(locations[sortedPairs[worst].second].id);
+        }
+        cout << left << setw(20) << scenarios[i].name.substr(0, 19) << setw(10) << report.overridesApplied
+             << setw(10) << report.blocksCopied
+             << setw(12) << (compared > 0 ? formatFixed((double)deltaTotal / compared, 2) + " km" : string("-"))
+             << setw(12) << (to_string(worstDelta) + " km") << (cutOff > 0 ? RED : "") << setw(10) << cutOff
+             << RESET << worstText << "\n";
+        if (report.overridesNotFound > 0) {
+            cout << YELLOW << "  [WARN] " << report.overridesNotFound << " override(s) skipped: road not found or bad status\n"
+                 << RESET;
+        }
+    }
+    closeSectionBorder();
+    cout << CYAN << "Evaluated " << count << " scenario(s) x " << pairs.size() << " pair(s) on "
+         << parallelWorkerCount(count) << " thread(s) in " << RESET << formatFixed(elapsedMs, 2) << " ms\n";
+    cout << "Base snapshot v" << base.snapshot->version << " has " << base.snapshot->locationCount
+         << " edge blocks; scenarios copied only the blocks listed above.\n";
+}
+
+void scenarioMenu() {
+    while (true) {
+        displaySection("WHAT-IF SCENARIOS");
+        cout << CYAN << "Scenarios defined: " << RESET << scenarios.size() << "\n";
+        for (size_t i = 0; i < scenarios.size(); i++) {
+            cout << "  " << (i + 1) << ". " << scenarios[i].name << " (" << scenarios[i].overrides.size()
+                 << " override(s))\n";
+        }
+        cout << "\n1. Add Scenario\n";
+        cout << "2. Load Scenarios from File\n";
+        cout << "3. Evaluate Scenarios\n";
+        cout << "4. Clear Scenarios\n";
+        cout << "5. Back\n";
+        cout << "Enter choice: ";
+
+        int choice;
+        if (!(cin >> choice)) {
+            clearBuffer();
+            cout << RED << "[ERROR] Invalid input!\n" << RESET;
+            continue;
+        }
+
+        if (choice == 1) {
+            Scenario scenario;
+            clearBuffer();
+            cout << "Scenario name: ";
+            getline(cin, scenario.name);
+            if (scenario.name.empty()) scenario.name = "Scenario " + to_string(scenarios.size() + 1);
+            cout << "Overrides, one per line as from,to,status,availability (e.g. 3,4,-,0 closes a road), finish with END:\n";
+            int badLines = 0;
+            readRoadUpdates(cin, scenario.overrides, badLines);
+            scenarios.push_back(scenario);
+            cout << GREEN << "[SUCCESS] Scenario added with " << scenario.overrides.size() << " override(s)"
+                 << RESET << (badLines > 0 ? ", " + to_string(badLines) + " bad line(s) skipped" : string("")) << "\n";
+        } else if (choice == 2) {
+            cout << "File path ([name] lines start scenarios, then feed lines): ";
+            string path;
+            cin >> path;
+            ifstream file(path.c_str());
+            if (!file) {
+                cout << RED << "[ERROR] Could not open " << path << "!\n" << RESET;
+                continue;
+            }
+            vector<Scenario> loaded;
+            int badLines = 0;
+            readScenarios(file, loaded, badLines);
+            scenarios.insert(scenarios.end(), loaded.begin(), loaded.end());
+            cout << GREEN << "[SUCCESS] Loaded " << loaded.size() << " scenario(s)" << RESET
+                 << (badLines > 0 ? ", " + to_string(badLines) + " bad line(s) skipped" : string("")) << "\n";
+        } else if (choice == 3) {
+            evaluateScenarios();
+        } else if (choice == 4) {
+            scenarios.clear();
+            cout << GREEN << "[SUCCESS] Scenarios cleared.\n" << RESET;
+        } else if (choice == 5) {
             break;
+        } else {
+            cout << RED << "[ERROR] Invalid choice!\n" << RESET;
         }
     }
+}
 
-    if (found) {
-        cout << GREEN << "[SUCCESS] Distance updated!\n" << RESET;
+// ============================================
+// GPS MAP MATCHING (HMM / VITERBI)
+// ============================================
+
+// Snaps GPS traces onto roads with a hidden Markov model. Each point's
+// states are the roads passing within MATCH_SEARCH_RADIUS_KM of it, found
+// through a grid of the cells each road segment crosses. A state scores
+// well when it lies close to the point, and a transition scores well when
+// the network distance between two states is close to the straight-line
+// distance between their points.
+// Roads are straight segments between their locations for this purpose, and
+// network distances come from a bounded cache of single-source searches.
+// Viterbi runs with a fixed lag: once a vehicle has MATCH_WINDOW undecided
+// points, the oldest is settled on the current best path and dropped, so
+// memory per vehicle stays bounded however long the trace is. Consecutive
+// points on one road yield observed speeds, which become suggested status
+// updates.
+
+const int MATCH_MAX_CANDIDATES = 8;
+const double MATCH_SEARCH_RADIUS_KM = 0.3;
+const double MATCH_CELL_KM = 1.0;           // road grid cell size, at least MATCH_SEARCH_RADIUS_KM
+const double MATCH_SIGMA_KM = 0.04;         // GPS noise (emission)
+const double MATCH_BETA_KM = 0.5;           // tolerated route vs straight-line difference (transition)
+const int MATCH_WINDOW = 16;                // undecided points kept per vehicle
+const double MATCH_MAX_GAP_SECONDS = 300.0;
+const int MATCH_CACHE_ROWS = 256;           // single-source distance rows kept
+const double MATCH_MIN_TRAVERSAL = 0.3;     // fraction of a road seen before its speed counts
+const double MATCH_HEAVY_RATIO = 0.5;       // observed / limit below this suggests Heavy Traffic
+const double MATCH_NORMAL_RATIO = 0.75;     // and at or above this suggests Normal
+
+struct GpsPoint {
+    int vehicle;
+    double time;        // seconds
+    double latitude;
+    double longitude;
+    int trueRoad;       // known road for synthetic traces, -1 otherwise
+};
+
+struct MatchCandidate {
+    int road;
+    double fraction;    // position along the road, 0 = from, 1 = to
+    double offsetKm;    // distance from the GPS point
+};
+
+struct MatchColumn {
+    GpsPoint point;
+    vector<MatchCandidate> candidates;
+    vector<double> score;   // best log-probability of a path ending here
+    vector<int> back;       // best predecessor in the previous column
+};
+
+struct VehicleMatch {
+    deque<MatchColumn> window;
+    int road;                           // road of the traversal being observed, -1 = none
+    double entryTime, entryFraction, lastTime, lastFraction;
+};
+
+struct RoadObservation {
+    double km;
+    double hours;
+    int traversals;
+};
+
+struct MapMatchReport {
+    long long points;
+    long long matched;
+    long long skipped;      // no road within MATCH_SEARCH_RADIUS_KM
+    long long breaks;       // time gaps or impossible transitions that restarted a vehicle
+    long long checked;      // synthetic points with a known road
+    long long correct;
+};
+
+// Road geometry and the distance cache, rebuilt when the network changes
+struct MatchNetwork {
+    int topologyVersion;
+    int weightVersion;
+    vector<int> roadFrom, roadTo;
+    vector<double> roadKm;                          // straight-line length
+    double cellLatitude, cellLongitude;             // road grid cell size in degrees
+    unordered_map<long long, vector<int>> roadCells;    // usable roads crossing each cell
+    vector<vector<pair<int, double>>> graph;
+    unordered_map<int, vector<double>> rows;
+    deque<int> rowOrder;
+    long long rowHits, rowMisses;
+};
+
+MatchNetwork matchNetwork;
+vector<RoadObservation> roadObservations;   // by road index
+int observationsTopologyVersion = 0;
+
+MatchNetwork& currentMatchNetwork() {
+    MatchNetwork& net = matchNetwork;
+    if (net.topologyVersion == topologyVersion && net.weightVersion == weightVersion) return net;
+
+    net.roadFrom.assign(roadCount, -1);
+    net.roadTo.assign(roadCount, -1);
+    net.roadKm.assign(roadCount, 0.0);
+    net.graph.assign(locationCount, vector<pair<int, double>>());
+    net.roadCells.clear();
+
+    // Cells are at least MATCH_CELL_KM wide everywhere up to a degree past
+    // the most poleward location
+    const double PI = 3.14159265358979323846;
+    double poleward = 0.0;
+    for (int i = 0; i < locationCount; i++) poleward = max(poleward, fabs(locations[i].latitude));
+    net.cellLatitude = MATCH_CELL_KM / KM_PER_DEGREE_LAT;
+    net.cellLongitude = MATCH_CELL_KM / (KM_PER_DEGREE_LON * max(0.01, cos(min(poleward + 1.0, 89.0) * PI / 180.0)));
+
+    for (int r = 0; r < roadCount; r++) {
+        int from = findLocationIndexByID(roads[r].fromID), to = findLocationIndexByID(roads[r].toID);
+        net.roadFrom[r] = from;
+        net.roadTo[r] = to;
+        if (from == -1 || to == -1 || !roads[r].isAvailable || roads[r].status == "Blocked") continue;
+        net.roadKm[r] = groundDistanceKm(locations[from].latitude, locations[from].longitude,
+                                         locations[to].latitude, locations[to].longitude);
+        net.graph[from].push_back(make_pair(to, net.roadKm[r]));
+
+        // Walk the segment at most one cell per step; when a step moves
+        // diagonally, the segment crosses one of the two corner cells
+        double x0 = locations[from].longitude / net.cellLongitude, y0 = locations[from].latitude / net.cellLatitude;
+        double x1 = locations[to].longitude / net.cellLongitude, y1 = locations[to].latitude / net.cellLatitude;
+        int steps = max(1, (int)ceil(max(fabs(x1 - x0), fabs(y1 - y0))));
+        vector<long long> crossed;
+        int lastX = (int)floor(x0), lastY = (int)floor(y0);
+        crossed.push_back(spatialCellKey(lastX, lastY));
+        for (int step = 1; step <= steps; step++) {
+            double f = (double)step / steps;
+            int cellX = (int)floor(x0 + f * (x1 - x0)), cellY = (int)floor(y0 + f * (y1 - y0));
+            if (cellX != lastX && cellY != lastY) {
+                crossed.push_back(spatialCellKey(cellX, lastY));
+                crossed.push_back(spatialCellKey(lastX, cellY));
+            }
+            crossed.push_back(spatialCellKey(cellX, cellY));
+            lastX = cellX;
+            lastY = cellY;
+        }
+        sort(crossed.begin(), crossed.end());
+        crossed.erase(unique(crossed.begin(), crossed.end()), crossed.end());
+        for (size_t c = 0; c < crossed.size(); c++) net.roadCells[crossed[c]].push_back(r);
+    }
+    net.rows.clear();
+    net.rowOrder.clear();
+    net.rowHits = net.rowMisses = 0;
+    net.topologyVersion = topologyVersion;
+    net.weightVersion = weightVersion;
+    return net;
+}
+
+// Straight-line km from location 'from' to 'to' over usable roads, or a
+// negative value if unreachable
+double matchPathKm(MatchNetwork& net, int from, int to) {
+    if (from == to) return 0.0;
+    unordered_map<int, vector<double>>::iterator row = net.rows.find(from);
+    if (row != net.rows.end()) {
+        net.rowHits++;
     } else {
-        cout << RED << "[ERROR] Road not found!\n" << RESET;
+        net.rowMisses++;
+        if ((int)net.rowOrder.size() >= MATCH_CACHE_ROWS) {
+            net.rows.erase(net.rowOrder.front());
+            net.rowOrder.pop_front();
+        }
+        vector<double> dist(net.graph.size(), -1.0);
+        priority_queue<pair<double, int>, vector<pair<double, int>>, greater<pair<double, int>>> pq;
+        dist[from] = 0.0;
+        pq.push(make_pair(0.0, from));
+        while (!pq.empty()) {
+            double d = pq.top().first;
+            int u = pq.top().second;
+            pq.pop();
+            if (d > dist[u]) continue;
+            for (size_t j = 0; j < net.graph[u].size(); j++) {
+                int v = net.graph[u][j].first;
+                double nd = d + net.graph[u][j].second;
+                if (dist[v] < 0 || nd < dist[v]) {
+                    dist[v] = nd;
+                    pq.push(make_pair(nd, v));
+                }
+            }
+        }
+        row = net.rows.insert(make_pair(from, dist)).first;
+        net.rowOrder.push_back(from);
     }
+    return row->second[to];
 }
 
-void updateRoadStatus() {
-    if (roadCount == 0) {
-        cout << YELLOW << "\n[INFO] No roads available.\n" << RESET;
-        return;
+void findMatchCandidates(MatchNetwork& net, const GpsPoint& point, vector<MatchCandidate>& candidates) {
+    const double PI = 3.14159265358979323846;
+    double kmPerLon = KM_PER_DEGREE_LON * cos(point.latitude * PI / 180.0);
+    candidates.clear();
+
+    // A road within the search radius crosses the point's cell or a neighbour
+    int pointX = (int)floor(point.longitude / net.cellLongitude), pointY = (int)floor(point.latitude / net.cellLatitude);
+    vector<int> nearbyRoads;
+    for (int x = pointX - 1; x <= pointX + 1; x++) {
+        for (int y = pointY - 1; y <= pointY + 1; y++) {
+            unordered_map<long long, vector<int>>::const_iterator cell = net.roadCells.find(spatialCellKey(x, y));
+            if (cell != net.roadCells.end()) nearbyRoads.insert(nearbyRoads.end(), cell->second.begin(), cell->second.end());
+        }
     }
+    sort(nearbyRoads.begin(), nearbyRoads.end());
+    nearbyRoads.erase(unique(nearbyRoads.begin(), nearbyRoads.end()), nearbyRoads.end());
+
+    for (size_t k = 0; k < nearbyRoads.size(); k++) {
+        int r = nearbyRoads[k];
+
+        // Project onto the segment in a local km frame centred on the point
+        const Location& a = locations[net.roadFrom[r]];
+        const Location& b = locations[net.roadTo[r]];
+        double ax = (a.longitude - point.longitude) * kmPerLon, ay = (a.latitude - point.latitude) * KM_PER_DEGREE_LAT;
+        double bx = (b.longitude - point.longitude) * kmPerLon, by = (b.latitude - point.latitude) * KM_PER_DEGREE_LAT;
+        double dx = bx - ax, dy = by - ay;
+        double lengthSquared = dx * dx + dy * dy;
+        double t = lengthSquared > 0 ? max(0.0, min(1.0, -(ax * dx + ay * dy) / lengthSquared)) : 0.0;
+        double px = ax + t * dx, py = ay + t * dy;
+        double offset = sqrt(px * px + py * py);
+        if (offset > MATCH_SEARCH_RADIUS_KM) continue;
+
+        MatchCandidate candidate = {r, t, offset};
+        candidates.push_back(candidate);
+    }
+    sort(candidates.begin(), candidates.end(),
+         [](const MatchCandidate& x, const MatchCandidate& y) { return x.offsetKm < y.offsetKm; });
+    if ((int)candidates.size() > MATCH_MAX_CANDIDATES) candidates.resize(MATCH_MAX_CANDIDATES);
+}
 
-    viewRoads();
+// Network km between two states, negative if impossible
+double matchRouteKm(MatchNetwork& net, const MatchCandidate& a, const MatchCandidate& b) {
+    if (a.road == b.road) {
+        double along = (b.fraction - a.fraction) * net.roadKm[a.road];
+        if (along >= -2 * MATCH_SIGMA_KM) return max(0.0, along);   // small backwards moves are noise
+    }
+    double between = matchPathKm(net, net.roadTo[a.road], net.roadFrom[b.road]);
+    if (between < 0) return -1.0;
+    return (1.0 - a.fraction) * net.roadKm[a.road] + between + b.fraction * net.roadKm[b.road];
+}
 
-    int fromID, toID;
-    string newStatus;
+void closeTraversal(VehicleMatch& vehicle) {
+    if (vehicle.road == -1) return;
+    double seen = vehicle.lastFraction - vehicle.entryFraction;
+    double seconds = vehicle.lastTime - vehicle.entryTime;
+    if (seen >= MATCH_MIN_TRAVERSAL && seconds > 0) {
+        RoadObservation& observation = roadObservations[vehicle.road];
+        observation.km += seen * roads[vehicle.road].distance;
+        observation.hours += seconds / 3600.0;
+        observation.traversals++;
+    }
+    vehicle.road = -1;
+}
 
-    cout << "\nEnter From Location ID: ";
-    if (!(cin >> fromID)) {
-        clearBuffer();
-        cout << RED << "[ERROR] Invalid input!\n" << RESET;
-        return;
+void emitMatchedPoint(MatchNetwork& net, VehicleMatch& vehicle, const MatchColumn& column, int state,
+                      MapMatchReport& report) {
+    const MatchCandidate& candidate = column.candidates[state];
+    report.matched++;
+    if (column.point.trueRoad != -1) {
+        int truth = column.point.trueRoad;
+        report.checked++;
+        bool sameRoad = candidate.road == truth ||
+                        (net.roadFrom[candidate.road] == net.roadTo[truth] && net.roadTo[candidate.road] == net.roadFrom[truth]);
+        if (sameRoad) report.correct++;
     }
 
-    cout << "Enter To Location ID: ";
-    if (!(cin >> toID)) {
-        clearBuffer();
-        cout << RED << "[ERROR] Invalid input!\n" << RESET;
-        return;
+    if (candidate.road != vehicle.road) {
+        closeTraversal(vehicle);
+        vehicle.road = candidate.road;
+        vehicle.entryTime = column.point.time;
+        vehicle.entryFraction = candidate.fraction;
     }
+    vehicle.lastTime = column.point.time;
+    vehicle.lastFraction = candidate.fraction;
+}
 
-    clearBuffer();
-    cout << "Enter New Status (Normal/Heavy Traffic/Blocked): ";
-    getline(cin, newStatus);
+// State at column 'upTo' on the best path ending in the newest column
+int matchBacktrace(const VehicleMatch& vehicle, size_t upTo) {
+    const MatchColumn& last = vehicle.window.back();
+    int state = (int)(max_element(last.score.begin(), last.score.end()) - last.score.begin());
+    for (size_t c = vehicle.window.size() - 1; c > upTo; c--) state = vehicle.window[c].back[state];
+    return state;
+}
 
-    if (newStatus != "Normal" && newStatus != "Heavy Traffic" && newStatus != "Blocked") {
-        cout << RED << "[ERROR] Invalid status!\n" << RESET;
+void flushVehicle(MatchNetwork& net, VehicleMatch& vehicle, MapMatchReport& report) {
+    if (vehicle.window.empty()) return;
+    vector<int> states(vehicle.window.size());
+    states.back() = matchBacktrace(vehicle, vehicle.window.size() - 1);
+    for (size_t c = vehicle.window.size() - 1; c > 0; c--) states[c - 1] = vehicle.window[c].back[states[c]];
+    for (size_t c = 0; c < vehicle.window.size(); c++) emitMatchedPoint(net, vehicle, vehicle.window[c], states[c], report);
+    vehicle.window.clear();
+}
+
+void matchGpsPoint(MatchNetwork& net, unordered_map<int, VehicleMatch>& vehicles, const GpsPoint& point,
+                   MapMatchReport& report) {
+    report.points++;
+    MatchColumn column;
+    column.point = point;
+    findMatchCandidates(net, point, column.candidates);
+    if (column.candidates.empty()) {
+        report.skipped++;
         return;
     }
 
-    bool found = false;
-    bool wasOneWay = false;
-    for (int i = 0; i < roadCount; i++) {
-        if (roads[i].fromID == fromID && roads[i].toID == toID) {
-            roads[i].status = newStatus;
-            wasOneWay = roads[i].isOneWay;
-            found = true;
+    unordered_map<int, VehicleMatch>::iterator found = vehicles.find(point.vehicle);
+    if (found == vehicles.end()) {
+        VehicleMatch fresh;
+        fresh.road = -1;
+        fresh.entryTime = fresh.entryFraction = fresh.lastTime = fresh.lastFraction = 0.0;
+        found = vehicles.insert(make_pair(point.vehicle, fresh)).first;
+    }
+    VehicleMatch& vehicle = found->second;
+    if (!vehicle.window.empty() && point.time - vehicle.window.back().point.time > MATCH_MAX_GAP_SECONDS) {
+        flushVehicle(net, vehicle, report);
+        closeTraversal(vehicle);
+        report.breaks++;
+    }
 
-            if (!wasOneWay) {
-                for (int j = 0; j < roadCount; j++) {
-                    if (roads[j].fromID == toID && roads[j].toID == fromID) {
-                        roads[j].status = newStatus;
-                        break;
-                    }
+    size_t count = column.candidates.size();
+    column.score.assign(count, -numeric_limits<double>::infinity());
+    column.back.assign(count, -1);
+    bool connected = false;
+    if (!vehicle.window.empty()) {
+        const MatchColumn& previous = vehicle.window.back();
+        double straight = groundDistanceKm(previous.point.latitude, previous.point.longitude,
+                                           point.latitude, point.longitude);
+        for (size_t j = 0; j < count; j++) {
+            for (size_t i = 0; i < previous.candidates.size(); i++) {
+                double route = matchRouteKm(net, previous.candidates[i], column.candidates[j]);
+                if (route < 0) continue;
+                double score = previous.score[i] - fabs(route - straight) / MATCH_BETA_KM;
+                if (score > column.score[j]) {
+                    column.score[j] = score;
+                    column.back[j] = (int)i;
+                    connected = true;
                 }
             }
-            break;
+        }
+        if (!connected) {
+            flushVehicle(net, vehicle, report);
+            closeTraversal(vehicle);
+            report.breaks++;
         }
     }
+    double best = -numeric_limits<double>::infinity();
+    for (size_t j = 0; j < count; j++) {
+        double emission = -0.5 * (column.candidates[j].offsetKm / MATCH_SIGMA_KM) * (column.candidates[j].offsetKm / MATCH_SIGMA_KM);
+        column.score[j] = (connected ? column.score[j] : 0.0) + emission;
+        best = max(best, column.score[j]);
+    }
+    for (size_t j = 0; j < count; j++) column.score[j] -= best;     // keeps scores from drifting
 
-    if (found) {
-        cout << GREEN << "[SUCCESS] Road status updated!\n" << RESET;
-    } else {
-        cout << RED << "[ERROR] Road not found!\n" << RESET;
+    vehicle.window.push_back(column);
+    if ((int)vehicle.window.size() > MATCH_WINDOW) {
+        emitMatchedPoint(net, vehicle, vehicle.window.front(), matchBacktrace(vehicle, 0), report);
+        vehicle.window.pop_front();
     }
 }
 
-void toggleRoadAvailability() {
-    if (roadCount == 0) {
-        cout << YELLOW << "\n[INFO] No roads available.\n" << RESET;
-        return;
+void prepareRoadObservations() {
+    if (observationsTopologyVersion != topologyVersion || (int)roadObservations.size() != roadCount) {
+        RoadObservation none = {0.0, 0.0, 0};
+        roadObservations.assign(roadCount, none);
+        observationsTopologyVersion = topologyVersion;
     }
+}
 
-    viewRoads();
-
-    int fromID, toID;
-    cout << "\nEnter From Location ID: ";
-    if (!(cin >> fromID)) {
-        clearBuffer();
-        cout << RED << "[ERROR] Invalid input!\n" << RESET;
-        return;
+// Matches a time-ordered stream of points and flushes every vehicle at the end
+MapMatchReport matchGpsStream(istream& in, const vector<GpsPoint>* points, int& badLines, double& seconds) {
+    TraceSpan span("map matching", "traffic");
+    MapMatchReport report = {0, 0, 0, 0, 0, 0};
+    prepareRoadObservations();
+    MatchNetwork& net = currentMatchNetwork();
+    unordered_map<int, VehicleMatch> vehicles;
+
+    chrono::steady_clock::time_point started = chrono::steady_clock::now();
+    if (points != nullptr) {
+        for (size_t p = 0; p < points->size(); p++) matchGpsPoint(net, vehicles, (*points)[p], report);
+    } else {
+        string line;
+        while (getline(in, line)) {
+            if (line.empty() || line[0] == '#' || line == "\r") continue;
+            GpsPoint point;
+            point.trueRoad = -1;
+            if (sscanf(line.c_str(), "%d,%lf,%lf,%lf", &point.vehicle, &point.time, &point.latitude, &point.longitude) != 4) {
+                badLines++;
+                continue;
+            }
+            matchGpsPoint(net, vehicles, point, report);
+        }
     }
-
-    cout << "Enter To Location ID: ";
-    if (!(cin >> toID)) {
-        clearBuffer();
-        cout << RED << "[ERROR] Invalid input!\n" << RESET;
-        return;
+    for (unordered_map<int, VehicleMatch>::iterator it = vehicles.begin(); it != vehicles.end(); ++it) {
+        flushVehicle(net, it->second, report);
+        closeTraversal(it->second);
     }
+    seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+    span.counter("points", report.points);
+    return report;
+}
 
-    bool found = false;
-    bool wasOneWay = false;
-    for (int i = 0; i < roadCount; i++) {
-        if (roads[i].fromID == fromID && roads[i].toID == toID) {
-            roads[i].isAvailable = !roads[i].isAvailable;
-            wasOneWay = roads[i].isOneWay;
-            found = true;
-
-            string status = roads[i].isAvailable ? "available" : "unavailable (under construction)";
-
-            // Update reverse if bidirectional
-            if (!wasOneWay) {
-                for (int j = 0; j < roadCount; j++) {
-                    if (roads[j].fromID == toID && roads[j].toID == fromID) {
-                        roads[j].isAvailable = roads[i].isAvailable;
-                        break;
-                    }
-                }
+// Vehicles drive shortest paths between random locations, reporting a noisy
+// fix every interval. Congested roads are driven at a fraction of their
+// limit so the learned speeds have something to find.
+void generateSyntheticTraces(int vehicleCount, unsigned int seed, vector<GpsPoint>& points, vector<bool>& congested) {
+    const double INTERVAL_SECONDS = 5.0, NOISE_KM = 0.015;
+    mt19937 rng(seed);
+    uniform_int_distribution<int> pickLocation(0, locationCount - 1);
+    uniform_real_distribution<double> unit(0.0, 1.0);
+    normal_distribution<double> noise(0.0, NOISE_KM);
+
+    congested.assign(roadCount, false);
+    for (int r = 0; r < roadCount; r++) congested[r] = unit(rng) < 0.3;
+
+    const double PI = 3.14159265358979323846;
+    for (int v = 0; v < vehicleCount; v++) {
+        int from = pickLocation(rng), to = pickLocation(rng);
+        vector<int> path;
+        if (from == to || shortestPathLookup(from, to, path) == INF_DISTANCE) continue;
+
+        double time = v * 7.0, nextFix = time;
+        for (size_t h = 1; h < path.size(); h++) {
+            int r = findRoadIndex(locations[path[h - 1]].id, locations[path[h]].id);
+            if (r == -1) break;
+            double kmh = roads[r].speedLimit * (congested[r] ? 0.35 : 0.9);
+            double duration = roads[r].distance / kmh * 3600.0;
+            const Location& a = locations[path[h - 1]];
+            const Location& b = locations[path[h]];
+            for (; nextFix < time + duration; nextFix += INTERVAL_SECONDS) {
+                double t = (nextFix - time) / duration;
+                double latitude = a.latitude + t * (b.latitude - a.latitude);
+                double longitude = a.longitude + t * (b.longitude - a.longitude);
+                GpsPoint point = {v, nextFix,
+                                  latitude + noise(rng) / KM_PER_DEGREE_LAT,
+                                  longitude + noise(rng) / (KM_PER_DEGREE_LON * cos(latitude * PI / 180.0)), r};
+                points.push_back(point);
             }
-
-            cout << GREEN << "[SUCCESS] Road is now " << status << "!\n" << RESET;
-            break;
+            time += duration;
         }
     }
+    stable_sort(points.begin(), points.end(), [](const GpsPoint& x, const GpsPoint& y) { return x.time < y.time; });
+}
 
-    if (!found) {
-        cout << RED << "[ERROR] Road not found!\n" << RESET;
+void printMapMatchReport(const MapMatchReport& report, double seconds) {
+    MatchNetwork& net = matchNetwork;
+    cout << CYAN << "Points: " << RESET << report.points << " (matched " << report.matched << ", skipped "
+         << report.skipped << ", breaks " << report.breaks << ")\n";
+    cout << CYAN << "Throughput: " << RESET << formatFixed(report.points / max(seconds, 1e-9), 0)
+         << " points/s on one thread (" << formatFixed(seconds * 1000.0, 2) << " ms)\n";
+    cout << CYAN << "Distance cache: " << RESET << net.rowHits << " hits, " << net.rowMisses << " searches, "
+         << net.rows.size() << "/" << MATCH_CACHE_ROWS << " rows held\n";
+    if (report.checked > 0) {
+        cout << CYAN << "Accuracy: " << RESET << formatFixed(100.0 * report.correct / report.checked, 1)
+             << "% of points on their true road\n";
     }
 }
 
-// ============================================
-// MANUAL ROUTE BUILDER (STACK)
-// ============================================
-
-void manualRouteBuilder() {
-    stack<int> routeStack;
+void applyLearnedTravelTimes() {
+    prepareRoadObservations();
+    vector<RoadUpdate> updates;
+    displaySection("LEARNED TRAVEL TIMES");
+    cout << CYAN << left << setw(10) << "Road" << setw(10) << "Limit" << setw(12) << "Observed" << setw(8) << "Runs"
+         << setw(16) << "Status" << "Suggested" << RESET << "\n";
+    for (int r = 0; r < roadCount; r++) {
+        // Both directions of a bidirectional road share one status
+        RoadObservation observation = roadObservations[r];
+        int reverse = roads[r].isOneWay ? -1 : findRoadIndex(roads[r].toID, roads[r].fromID);
+        if (reverse != -1 && reverse < r) continue;
+        if (reverse != -1) {
+            observation.km += roadObservations[reverse].km;
+            observation.hours += roadObservations[reverse].hours;
+            observation.traversals += roadObservations[reverse].traversals;
+        }
+        // A blocked road is closed on purpose; traces matched near it never reopen it
+        if (observation.traversals == 0 || observation.hours <= 0 || roads[r].status == "Blocked") continue;
+        double kmh = observation.km / observation.hours;
+        double ratio = kmh / max(1, roads[r].speedLimit);
+        string suggested = roads[r].status;
+        if (ratio < MATCH_HEAVY_RATIO) suggested = "Heavy Traffic";
+        else if (ratio >= MATCH_NORMAL_RATIO && roads[r].status == "Heavy Traffic") suggested = "Normal";
+
+        cout << left << setw(10) << (to_string(roads[r].fromID) + (reverse != -1 ? "<->" : "->") + to_string(roads[r].toID))
+             << setw(10) << (to_string(roads[r].speedLimit) + " km/h") << setw(12) << (formatFixed(kmh, 1) + " km/h")
+             << setw(8) << observation.traversals << setw(16) << roads[r].status
+             << (suggested != roads[r].status ? YELLOW : "") << suggested << RESET << "\n";
+        if (suggested != roads[r].status) {
+            RoadUpdate update = {roads[r].fromID, roads[r].toID, suggested, -1};
+            updates.push_back(update);
+        }
+    }
+    closeSectionBorder();
+    if (updates.empty()) {
+        cout << YELLOW << "[INFO] No status changes suggested.\n" << RESET;
+        return;
+    }
 
-    cout << "\n--- Manual Route Builder (using Stack) ---\n";
-    cout << "You can push locations to create your custom path.\n";
+    cout << "Apply " << updates.size() << " suggested status change(s)? (y/n): ";
+    string answer;
+    cin >> answer;
+    if (answer != "y" && answer != "Y") return;
+    RoadUpdateReport report = applyRoadUpdates(updates);
+    if (!report.saved) {
+        printJournalError();
+        return;
+    }
+    cout << GREEN << "[SUCCESS] " << report.applied << " road(s) updated.\n" << RESET;
+}
 
+void mapMatchingMenu() {
     while (true) {
-        cout << "\nCurrent Path: ";
-        if (routeStack.empty()) {
-            cout << "(empty)";
-        } else {
-            // Collect all locations in a vector to reverse the order
-            stack<int> temp = routeStack;
-            vector<int> pathVector;
-            while (!temp.empty()) {
-                pathVector.push_back(temp.top());
-                temp.pop();
-            }
-            // Display from bottom of stack to top (travel direction)
-            for (int i = pathVector.size() - 1; i >= 0; i--) {
-                if (i < pathVector.size() - 1) cout << " -> ";
-                cout << pathVector[i];
-            }
-        }
-        cout << "\n\n1. Push Location\n";
-        cout << "2. Pop Location\n";
-        cout << "3. View Current Path\n";
-        cout << "4. Save Path to History\n";
-        cout << "5. Exit Manual Builder\n";
+        displaySection("GPS MAP MATCHING");
+        cout << "1. Match Trace File (vehicle,time_s,latitude,longitude per line)\n";
+        cout << "2. Synthetic Trace Benchmark\n";
+        cout << "3. Review / Apply Learned Travel Times\n";
+        cout << "4. Clear Observations\n";
+        cout << "5. Back\n";
         cout << "Enter choice: ";
 
         int choice;
@@ -671,81 +6919,69 @@ void manualRouteBuilder() {
         }
 
         if (choice == 1) {
-            cout << "Enter Location ID to push: ";
-            int id;
-            if (!(cin >> id)) {
-                clearBuffer();
-                cout << RED << "[ERROR] Invalid input!\n" << RESET;
+            cout << "Trace file path (points in time order): ";
+            string path;
+            cin >> path;
+            ifstream file(path.c_str());
+            if (!file) {
+                cout << RED << "[ERROR] Could not open " << path << "!\n" << RESET;
                 continue;
             }
-
-            if (!locationExists(id)) {
-                cout << RED << "[ERROR] Location not found!\n" << RESET;
+            int badLines = 0;
+            double seconds = 0.0;
+            MapMatchReport report = matchGpsStream(file, nullptr, badLines, seconds);
+            displaySection("MAP MATCHING RESULT");
+            printMapMatchReport(report, seconds);
+            if (badLines > 0) cout << YELLOW << "[WARN] " << badLines << " bad line(s) skipped\n" << RESET;
+        } else if (choice == 2) {
+            if (locationCount < 2 || roadCount == 0) {
+                cout << YELLOW << "\n[INFO] Add locations and roads first.\n" << RESET;
                 continue;
             }
-
-            // Check if road exists from current top location to new location
-            if (!routeStack.empty()) {
-                int currentTop = routeStack.top();
-                if (!roadExists(currentTop, id)) {
-                    string fromName = findLocationNameByID(currentTop);
-                    string toName = findLocationNameByID(id);
-                    cout << RED << "[ERROR] No road exists from " << fromName
-                         << " (ID: " << currentTop << ") to " << toName
-                         << " (ID: " << id << ")!\n" << RESET;
-                    cout << YELLOW << "[INFO] Please add a road between these locations first using 'Manage Roads'.\n" << RESET;
-                    continue;
-                }
+            cout << "Number of vehicles (1-10000): ";
+            int vehicleCount;
+            unsigned int seed;
+            if (!(cin >> vehicleCount) || vehicleCount < 1 || vehicleCount > 10000) {
+                clearBuffer();
+                cout << RED << "[ERROR] Invalid vehicle count!\n" << RESET;
+                continue;
             }
-
-            routeStack.push(id);
-            cout << GREEN << "[SUCCESS] Location " << id << " pushed!\n" << RESET;
-        } else if (choice == 2) {
-            if (!routeStack.empty()) {
-                cout << GREEN << "[SUCCESS] Popped: " << routeStack.top() << "\n" << RESET;
-                routeStack.pop();
-            } else {
-                cout << YELLOW << "[INFO] Stack is empty!\n" << RESET;
+            cout << "Random seed: ";
+            if (!(cin >> seed)) {
+                clearBuffer();
+                cout << RED << "[ERROR] Invalid seed!\n" << RESET;
+                continue;
             }
-        } else if (choice == 3) {
-            cout << "\n--- Current Stack (Top to Bottom) ---\n";
-            if (routeStack.empty()) {
-                cout << "(empty)\n";
-            } else {
-                stack<int> temp = routeStack;
-                int count = 1;
-                while (!temp.empty()) {
-                    cout << count << ". Location ID: " << temp.top() << "\n";
-                    temp.pop();
-                    count++;
+            vector<GpsPoint> points;
+            vector<bool> congested;
+            generateSyntheticTraces(vehicleCount, seed, points, congested);
+            int badLines = 0;
+            double seconds = 0.0;
+            MapMatchReport report = matchGpsStream(cin, &points, badLines, seconds);
+
+            int congestedSeen = 0, congestedFound = 0, falseAlarms = 0;
+            for (int r = 0; r < roadCount; r++) {
+                const RoadObservation& observation = roadObservations[r];
+                if (observation.traversals == 0 || observation.hours <= 0) continue;
+                bool slow = observation.km / observation.hours < MATCH_HEAVY_RATIO * roads[r].speedLimit;
+                if (congested[r]) {
+                    congestedSeen++;
+                    if (slow) congestedFound++;
+                } else if (slow) {
+                    falseAlarms++;
                 }
             }
+            displaySection("MAP MATCHING BENCHMARK");
+            printMapMatchReport(report, seconds);
+            cout << CYAN << "Congested roads detected: " << RESET << congestedFound << " of " << congestedSeen
+                 << " observed (" << falseAlarms << " false alarm(s))\n";
+            cout << YELLOW << "[INFO] Synthetic observations are kept; clear them before applying real ones.\n" << RESET;
+        } else if (choice == 3) {
+            applyLearnedTravelTimes();
         } else if (choice == 4) {
-            if (routeStack.empty()) {
-                cout << RED << "[ERROR] Path is empty!\n" << RESET;
-            } else {
-                stack<int> temp = routeStack;
-                vector<int> pathVector;
-                while (!temp.empty()) {
-                    pathVector.push_back(temp.top());
-                    temp.pop();
-                }
-
-                string pathString = "";
-                for (int i = pathVector.size() - 1; i >= 0; i--) {
-                    if (i < pathVector.size() - 1) pathString += " -> ";
-                    pathString += findLocationNameByID(pathVector[i]);
-                }
-                pathString += " (end)";
-
-                Node* newNode = new Node();
-                newNode->path = pathString;
-                newNode->next = routeHistoryHead;
-                routeHistoryHead = newNode;
-
-                cout << GREEN << "[SUCCESS] Path saved to history!\n" << RESET;
-                cout << "Path: " << YELLOW << pathString << RESET << "\n";
-            }
+            roadObservations.clear();
+            prepareRoadObservations();
+            cout << GREEN << "[SUCCESS] Observations cleared.\n" << RESET;
         } else if (choice == 5) {
             break;
         } else {
@@ -755,41 +6991,187 @@ void manualRouteBuilder() {
 }
 
 // ============================================
-// ROUTE HISTORY (LINKED LIST)
+// TRAFFIC SIMULATION
 // ============================================
 
-void viewRouteHistory() {
-    if (routeHistoryHead == nullptr) {
-        cout << YELLOW << "\n[INFO] No route history available.\n" << RESET;
+// Sum of the weights of every usable road, straight from the arrays; the
+// stress test compares each snapshot it sees against this
+long long roadWeightChecksum() {
+    long long checksum = 0;
+    for (int i = 0; i < roadCount; i++) {
+        int weight = roadTravelWeight(roads[i]);
+        if (weight >= 0 && locationExists(roads[i].fromID) && locationExists(roads[i].toID)) checksum += weight;
+    }
+    return checksum;
+}
+
+// Reader threads answer random navRouteDistance() queries while the main
+// thread keeps rewriting road statuses through the traffic feed API. The
+// writer records what each published version must add up to; every
+// version a reader sees is summed from its blocks and checked against that
+// record once the run is over.
+void runConcurrentQueryStress() {
+    if (locationCount < 2) {
+        cout << YELLOW << "\n[INFO] Add at least 2 locations first.\n" << RESET;
         return;
     }
 
-    displaySection("ROUTE HISTORY");
-    Node* current = routeHistoryHead;
-    int count = 1;
+    cout << "\nDuration in seconds (1-30): ";
+    int seconds;
+    if (!(cin >> seconds) || seconds < 1 || seconds > 30) {
+        clearBuffer();
+        cout << RED << "[ERROR] Invalid duration!\n" << RESET;
+        return;
+    }
 
-    while (current != nullptr) {
-        cout << count << ". " << YELLOW << current->path << RESET << "\n";
-        current = current->next;
-        count++;
+    vector<pair<string, bool>> savedStates = captureRoadStates();
+    int readers = max(2, parallelWorkerCount(64) - 1);
+    atomic<bool> running(true);
+    atomic<long long> queries(0);
+    map<int, long long> expectedChecksum;               // by snapshot version, written by the main thread
+    expectedChecksum[acquireGraphSnapshot()->version] = roadWeightChecksum();
+    vector<vector<pair<int, long long>>> observed(readers);    // (version, checksum) per reader
+
+    vector<thread> pool;
+    for (int r = 0; r < readers; r++) {
+        pool.push_back(thread([&running, &queries, &observed, r]() {
+            mt19937 rng(1234 + r);
+            int lastVersion = 0;
+            long long localQueries = 0;
+            while (running.load(memory_order_relaxed)) {
+                shared_ptr<const GraphSnapshot> snapshot = acquireGraphSnapshot();
+                if (snapshot->version != lastVersion) {
+                    lastVersion = snapshot->version;
+                    long long checksum = 0;
+                    for (int v = 0; v < snapshot->locationCount; v++) {
+                        if (snapshot->compressed) {
+                            const CompressedGraph& graph = *snapshot->compressed;
+                            forEachCompressedEdge(graph, v, [&](int, int distance, unsigned int flags) {
+                                checksum += max(0, compressedEdgeWeight(graph, distance, flags));
+                            });
+                            continue;
+                        }
+                        const EdgeBlock& block = snapshotBlock(*snapshot, v);
+                        for (size_t j = 0; j < block.size(); j++) checksum += block[j].distance;
+                    }
+                    observed[r].push_back(make_pair(snapshot->version, checksum));
+                }
+
+                const vector<int>& ids = *snapshot->locationIDs;
+                navRouteDistance(ids[rng() % ids.size()], ids[rng() % ids.size()]);
+                localQueries++;
+            }
+            queries += localQueries;
+        }));
     }
-    closeSectionBorder();
+
+    static const char* statuses[] = {"Normal", "Heavy Traffic", "Blocked"};
+    mt19937 rng(99);
+    long long publications = 0, copiedBlocks = 0;
+    double slowestPublishUs = 0;
+    chrono::steady_clock::time_point started = chrono::steady_clock::now();
+    chrono::steady_clock::time_point deadline = started + chrono::seconds(seconds);
+    while (chrono::steady_clock::now() < deadline) {
+        const Road& road = roads[rng() % roadCount];
+        vector<RoadUpdate> batch(1);
+        batch[0].fromID = road.fromID;
+        batch[0].toID = road.toID;
+        batch[0].status = statuses[rng() % 3];
+        batch[0].availability = -1;
+
+        chrono::steady_clock::time_point publishStart = chrono::steady_clock::now();
+        applyRoadUpdates(batch);
+        slowestPublishUs = max(slowestPublishUs,
+                               chrono::duration<double, micro>(chrono::steady_clock::now() - publishStart).count());
+        publications++;
+        copiedBlocks += snapshotBlocksCopied;
+        expectedChecksum[acquireGraphSnapshot()->version] = roadWeightChecksum();
+    }
+    running = false;
+    for (size_t r = 0; r < pool.size(); r++) pool[r].join();
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+
+    long long versionsSeen = 0, tornViews = 0;
+    for (size_t r = 0; r < observed.size(); r++) {
+        for (size_t k = 0; k < observed[r].size(); k++) {
+            map<int, long long>::const_iterator expected = expectedChecksum.find(observed[r][k].first);
+            if (expected == expectedChecksum.end() || expected->second != observed[r][k].second) tornViews++;
+        }
+        versionsSeen += (long long)observed[r].size();
+    }
+
+    displaySection("CONCURRENT QUERY REPORT");
+    cout << fixed << setprecision(0);
+    cout << CYAN << "Reader threads: " << RESET << readers << "\n";
+    cout << CYAN << "Queries answered: " << RESET << queries.load() << " (" << queries.load() / elapsed << " /s)\n";
+    cout << CYAN << "Snapshots published: " << RESET << publications << " (" << publications / elapsed << " /s)\n";
+    cout << setprecision(2);
+    cout << CYAN << "Blocks copied per publish: " << RESET << (publications > 0 ? (double)copiedBlocks / publications : 0.0)
+         << " of " << locationCount << "\n";
+    cout << CYAN << "Slowest publish: " << RESET << slowestPublishUs << " us\n";
+    cout << CYAN << "Versions checked by readers: " << RESET << versionsSeen << "\n";
+    cout << CYAN << "Inconsistent views: " << RESET << (tornViews == 0 ? GREEN : RED) << tornViews << RESET << "\n";
+
+    keepOrRestoreRoadStates(savedStates);
 }
 
-void clearRouteHistory() {
-    while (routeHistoryHead != nullptr) {
-        Node* temp = routeHistoryHead;
-        routeHistoryHead = routeHistoryHead->next;
-        delete temp;
+void trafficSimulation() {
+    if (roadCount == 0) {
+        cout << YELLOW << "\n[INFO] No roads available for traffic simulation.\n" << RESET;
+        return;
+    }
+
+    displaySection("TRAFFIC SIMULATION");
+    cout << "1. View Current Traffic Status\n";
+    cout << "2. Update Road Status\n";
+    // Added new menu option
+    cout << "3. Toggle Road Availability\n";
+    cout << "4. Import Traffic Feed (Batch Update)\n";
+    cout << "5. Run Event Simulation\n";
+    cout << "6. Run Fleet Simulation\n";
+    cout << "7. Concurrent Query Stress (Snapshots)\n";
+    cout << "8. What-If Scenarios\n";
+    cout << "9. GPS Map Matching\n";
+    cout << "10. Back to Main Menu\n";
+    cout << "Enter choice: ";
+
+    int choice;
+    if (!(cin >> choice)) {
+        clearBuffer();
+        cout << RED << "[ERROR] Invalid input!\n" << RESET;
+        return;
+    }
+
+    if (choice == 1) {
+        viewRoads();
+    } else if (choice == 2) {
+        updateRoadStatus();
+    } else if (choice == 3) {
+        toggleRoadAvailability();
+    } else if (choice == 4) {
+        importTrafficFeed();
+    } else if (choice == 5) {
+        runTrafficSimulationMenu();
+    } else if (choice == 6) {
+        runFleetSimulationMenu();
+    } else if (choice == 7) {
+        runConcurrentQueryStress();
+    } else if (choice == 8) {
+        scenarioMenu();
+    } else if (choice == 9) {
+        mapMatchingMenu();
+    } else if (choice == 10) {
+        // Back to Main Menu is handled by the caller implicitly
+    } else {
+        cout << RED << "[ERROR] Invalid choice!\n" << RESET;
     }
-    cout << GREEN << "\n[SUCCESS] Route history cleared!\n" << RESET;
 }
 
 // ============================================
-// DIJKSTRA'S SHORTEST PATH
+// PATH COST ESTIMATOR
 // ============================================
 
-void shortestPathDijkstra() {
+void pathCostEstimator() {
     if (locationCount < 2) {
         cout << YELLOW << "\n[INFO] Add at least 2 locations first.\n" << RESET;
         return;
@@ -805,439 +7187,1212 @@ void shortestPathDijkstra() {
         return;
     }
 
-    cout << "Enter End Location ID: ";
-    if (!(cin >> endID)) {
+    cout << "Enter End Location ID: ";
+    if (!(cin >> endID)) {
+        clearBuffer();
+        cout << RED << "[ERROR] Invalid input!\n" << RESET;
+        return;
+    }
+
+    if (!locationExists(startID) || !locationExists(endID)) {
+        cout << RED << "[ERROR] Invalid location IDs!\n" << RESET;
+        return;
+    }
+
+    if (startID == endID) {
+        cout << YELLOW << "[INFO] Start and end locations are the same! No travel needed.\n" << RESET;
+        return;
+    }
+
+    int startIndex = findLocationIndexByID(startID);
+    int endIndex = findLocationIndexByID(endID);
+
+    vector<int> path(locationCount);
+    NavRouteSummary summary;
+    if (navShortestPath(startID, endID, path.data(), (int)path.size(), &summary) != NAV_OK) {
+        cout << RED << "\n[ERROR] No path exists between the locations!\n" << RESET;
+        return;
+    }
+    path.resize(summary.pathLength);
+    int totalDistance = summary.weightedDistance;
+    bool fromTable = locationCount <= APSP_MAX_LOCATIONS;
+
+    displaySection("PATH COST ESTIMATE");
+
+    NameRef startLocationName = findLocationNameByID(startID);
+    NameRef endLocationName = findLocationNameByID(endID);
+
+    cout << CYAN << "Route: " << RESET << startLocationName << " -> " << endLocationName << "\n";
+    cout << CYAN << "Via: " << RESET;
+    for (size_t i = 0; i < path.size(); i++) {
+        cout << findLocationNameByID(path[i]);
+        if (i < path.size() - 1) cout << " -> ";
+    }
+    cout << "\n";
+    if (fromTable) {
+        cout << CYAN << "Answered from: " << RESET << "all-pairs table (" << allPairsTable.n << " locations, built in "
+             << formatFixed(allPairsTable.buildMs, 3) << " ms)\n";
+    }
+    printTripEstimateTable(totalDistance);
+
+    vector<ParetoRoute> front;
+    paretoRouteSearch(startIndex, endIndex, front);
+
+    size_t shortest = 0, fastest = 0, cheapest = 0;
+    for (size_t r = 1; r < front.size(); r++) {
+        if (front[r].distance < front[shortest].distance) shortest = r;
+        if (front[r].minutes < front[fastest].minutes) fastest = r;
+        if (front[r].cost < front[cheapest].cost) cheapest = r;
+    }
+
+    displaySection("ROUTE OPTIONS (PARETO FRONT)");
+    cout << "| " << left << setw(4) << "#" << "| " << left << setw(10) << "Distance"
+         << "| " << left << setw(10) << "Time" << "| " << left << setw(10) << "Cost"
+         << "| " << left << setw(26) << "Best For" << "|\n";
+    cout << "+-----+-----------+-----------+-----------+---------------------------+\n";
+    for (size_t r = 0; r < front.size(); r++) {
+        string bestFor = "";
+        if (r == shortest) bestFor += "Shortest ";
+        if (r == fastest) bestFor += "Fastest ";
+        if (r == cheapest) bestFor += "Cheapest";
+        if (bestFor.empty()) bestFor = "Balanced";
+
+        int totalMinutes = (int)(front[r].minutes + 0.5);
+        cout << "| " << left << setw(4) << (r + 1)
+             << "| " << YELLOW << left << setw(10) << (to_string(front[r].distance) + " km") << RESET
+             << "| " << CYAN << left << setw(10) << (to_string(totalMinutes / 60) + "h " + to_string(totalMinutes % 60) + "m") << RESET
+             << "| " << GREEN << "$" << left << setw(9) << fixed << setprecision(2) << front[r].cost << RESET
+             << "| " << left << setw(26) << bestFor << "|\n";
+
+        cout << "|     " << CYAN << "Via: " << RESET;
+        for (size_t i = 0; i < front[r].path.size(); i++) {
+            cout << locations[front[r].path[i]].name;
+            if (i < front[r].path.size() - 1) cout << " -> ";
+        }
+        cout << "\n";
+    }
+    closeSectionBorder();
+}
+
+// ============================================
+// SERVICE AREA (ISOCHRONE) QUERIES
+// ============================================
+
+struct ReachableLocation {
+    int locationIndex;
+    double cost;        // weighted km or minutes from the depot
+};
+
+// Scratch space for bounded searches. Reused between searches and reset
+// through the touched list, so a search only pays for the area it explores.
+struct BoundedSearchWorkspace {
+    vector<double> dist;
+    vector<int> touched;
+};
+
+// Adjacency lists (by location index) carrying one travel measure per road,
+// taken from the snapshot's usable roads
+void buildBudgetGraph(const GraphSnapshot& snapshot, bool useMinutes, vector<vector<pair<int, double>>>& graph) {
+    int n = snapshot.locationCount;
+    graph.assign(n, vector<pair<int, double>>());
+
+    for (int u = 0; u < n; u++) {
+        const EdgeBlock& block = snapshotBlock(snapshot, u);
+        for (size_t j = 0; j < block.size(); j++) {
+            double cost = useMinutes ? roadTravelMinutes(roads[block[j].roadIndex]) : (double)block[j].distance;
+            graph[u].push_back(make_pair(block[j].destination, cost));
+        }
+    }
+}
+
+// One-to-all Dijkstra that never settles anything beyond the budget.
+// Reachable locations come out in increasing cost order.
+void boundedSearch(const vector<vector<pair<int, double>>>& graph, int sourceIndex, double budget,
+                   BoundedSearchWorkspace& workspace, vector<ReachableLocation>& reachable) {
+    reachable.clear();
+    if (workspace.dist.size() != graph.size()) {
+        workspace.dist.assign(graph.size(), numeric_limits<double>::infinity());
+        workspace.touched.clear();
+    }
+
+    priority_queue<pair<double, int>, vector<pair<double, int>>, greater<pair<double, int>>> pq;
+    workspace.dist[sourceIndex] = 0.0;
+    workspace.touched.push_back(sourceIndex);
+    pq.push(make_pair(0.0, sourceIndex));
+
+    while (!pq.empty()) {
+        double d = pq.top().first;
+        int u = pq.top().second;
+        pq.pop();
+        if (d > workspace.dist[u]) continue;
+
+        ReachableLocation entry;
+        entry.locationIndex = u;
+        entry.cost = d;
+        reachable.push_back(entry);
+
+        for (size_t j = 0; j < graph[u].size(); j++) {
+            int v = graph[u][j].first;
+            double nd = d + graph[u][j].second;
+            if (nd <= budget && nd < workspace.dist[v]) {
+                if (workspace.dist[v] == numeric_limits<double>::infinity()) {
+                    workspace.touched.push_back(v);
+                }
+                workspace.dist[v] = nd;
+                pq.push(make_pair(nd, v));
+            }
+        }
+    }
+
+    for (size_t i = 0; i < workspace.touched.size(); i++) {
+        workspace.dist[workspace.touched[i]] = numeric_limits<double>::infinity();
+    }
+    workspace.touched.clear();
+}
+
+// Batched isochrones: depots are shared out across worker threads, each
+// with its own workspace. results[i] belongs to depotIndices[i].
+void computeIsochrones(const vector<vector<pair<int, double>>>& graph, const vector<int>& depotIndices,
+                       double budget, vector<vector<ReachableLocation>>& results) {
+    results.assign(depotIndices.size(), vector<ReachableLocation>());
+    vector<BoundedSearchWorkspace> workspaces(parallelWorkerCount((int)depotIndices.size()));
+
+    parallelFor((int)depotIndices.size(), [&](int job, int worker) {
+        boundedSearch(graph, depotIndices[job], budget, workspaces[worker], results[job]);
+    });
+}
+
+void serviceAreaQuery() {
+    if (locationCount == 0) {
+        cout << YELLOW << "\n[INFO] Add locations first.\n" << RESET;
+        return;
+    }
+
+    viewLocations();
+
+    cout << "\nBudget type (1 = Weighted km, 2 = Minutes): ";
+    int budgetType;
+    if (!(cin >> budgetType) || (budgetType != 1 && budgetType != 2)) {
         clearBuffer();
-        cout << RED << "[ERROR] Invalid input!\n" << RESET;
+        cout << RED << "[ERROR] Invalid budget type!\n" << RESET;
         return;
     }
+    bool useMinutes = (budgetType == 2);
 
-    if (!locationExists(startID) || !locationExists(endID)) {
-        cout << RED << "[ERROR] Invalid location IDs!\n" << RESET;
+    cout << "Enter budget (" << (useMinutes ? "minutes" : "km") << "): ";
+    double budget;
+    if (!(cin >> budget) || budget <= 0) {
+        clearBuffer();
+        cout << RED << "[ERROR] Budget must be positive!\n" << RESET;
         return;
     }
 
-    if (startID == endID) {
-        cout << YELLOW << "[INFO] Start and end locations are the same!\n" << RESET;
+    cout << "How many depots? ";
+    int depotCount;
+    if (!(cin >> depotCount) || depotCount <= 0 || depotCount > locationCount) {
+        clearBuffer();
+        cout << RED << "[ERROR] Invalid number of depots!\n" << RESET;
         return;
     }
 
-    vector<GraphNode> adjacencyList[500];
-
-    for (int i = 0; i < roadCount; i++) {
-        // Skip blocked roads and unavailable roads
-        if (roads[i].status == "Blocked" || !roads[i].isAvailable) {
-            continue;
+    vector<int> depotIndices;
+    for (int d = 0; d < depotCount; d++) {
+        cout << "Enter Depot Location ID " << (d + 1) << ": ";
+        int id;
+        if (!(cin >> id)) {
+            clearBuffer();
+            cout << RED << "[ERROR] Invalid input!\n" << RESET;
+            return;
         }
-
-        GraphNode gn;
-        gn.destination = roads[i].toID;
-
-        // Apply traffic multiplier: Normal = 1.0x, Heavy Traffic = 1.5x
-        double multiplier = 1.0;
-        if (roads[i].status == "Heavy Traffic") {
-            multiplier = 1.5;
+        int index = findLocationIndexByID(id);
+        if (index == -1) {
+            cout << RED << "[ERROR] Location not found!\n" << RESET;
+            return;
         }
-        gn.distance = (int)(roads[i].distance * multiplier);
-
-        adjacencyList[roads[i].fromID].push_back(gn);
+        depotIndices.push_back(index);
     }
 
-    const int INF = INT_MAX;
-    int dist[500];
-    int parent[500];
-    bool visited[500];
-
-    for (int i = 0; i < 500; i++) {
-        dist[i] = INF;
-        parent[i] = -1;
-        visited[i] = false;
+    chrono::steady_clock::time_point started = chrono::steady_clock::now();
+    vector<vector<pair<int, double>>> graph;
+    buildBudgetGraph(*expandGraphSnapshot(acquireGraphSnapshot()), useMinutes, graph);
+    vector<vector<ReachableLocation>> results;
+    computeIsochrones(graph, depotIndices, budget, results);
+    double elapsedMs = chrono::duration<double, milli>(chrono::steady_clock::now() - started).count();
+
+    string unit = useMinutes ? " min" : " km";
+    ostringstream budgetText;
+    budgetText << budget << unit;
+    for (size_t d = 0; d < depotIndices.size(); d++) {
+        displaySection("SERVICE AREA: " + nameString(locations[depotIndices[d]].name));
+        cout << "| " << left << setw(6) << "ID" << "| " << left << setw(25) << "Location Name"
+             << "| " << left << setw(12) << "Cost" << "|\n";
+        cout << "+-------+--------------------------+-------------+\n";
+        for (size_t i = 0; i < results[d].size(); i++) {
+            const ReachableLocation& entry = results[d][i];
+            ostringstream cost;
+            cost << fixed << setprecision(1) << entry.cost << unit;
+            cout << "| " << YELLOW << left << setw(6) << locations[entry.locationIndex].id << RESET
+                 << "| " << left << setw(25) << locations[entry.locationIndex].name
+                 << "| " << GREEN << left << setw(12) << cost.str() << RESET << "|\n";
+        }
+        closeSectionBorder();
+        cout << CYAN << "Reachable within " << budgetText.str() << ": " << RESET
+             << results[d].size() << "/" << locationCount << " locations\n";
     }
 
-    dist[startID] = 0;
+    cout << GREEN << "\n[SUCCESS] Computed " << depotIndices.size() << " service area(s) in "
+         << fixed << setprecision(3) << elapsedMs << " ms.\n" << RESET;
+}
 
-    for (int count = 0; count < locationCount; count++) {
-        int u = -1;
-        int minDist = INF;
+// ============================================
+// MULTI-STOP TRIP OPTIMISER
+// ============================================
 
-        for (int i = 0; i < 500; i++) {
-            if (!visited[i] && dist[i] < minDist) {
-                u = i;
-                minDist = dist[i];
-            }
-        }
+const long long TRIP_UNREACHABLE = 1000000000000LL;   // cost used for pairs with no path
 
-        if (u == -1 || dist[u] == INF) break;
+struct TripPlan {
+    vector<int> order;          // positions in the stop list, starting with the depot (0)
+    vector<int> expandedPath;   // location indices of the full road path
+    long long totalDistance;    // weighted km
+    bool reachable;
+};
 
-        visited[u] = true;
+// Pairwise weighted distances between stops, one Dijkstra per stop run in
+// parallel. parents[i] is the shortest path tree from stop i, kept for
+// expanding the final visit order into roads.
+void buildStopMatrix(const vector<int>& stopIndices, vector<vector<long long>>& matrix,
+                     vector<vector<int>>& parents) {
+    shared_ptr<const GraphSnapshot> snapshot = acquireGraphSnapshot();
+
+    int n = (int)stopIndices.size();
+    matrix.assign(n, vector<long long>(n, 0));
+    parents.assign(n, vector<int>());
+
+    parallelFor(n, [&](int i, int) {
+        vector<int> dist;
+        snapshotDijkstra(*snapshot, stopIndices[i], dist, parents[i]);
+        for (int j = 0; j < n; j++) {
+            int d = dist[stopIndices[j]];
+            matrix[i][j] = (d == INF_DISTANCE) ? TRIP_UNREACHABLE : d;
+        }
+    });
+}
 
-        for (size_t j = 0; j < adjacencyList[u].size(); j++) {
-            int v = adjacencyList[u][j].destination;
-            int weight = adjacencyList[u][j].distance;
+long long tourCost(const vector<vector<long long>>& matrix, const vector<int>& tour) {
+    long long total = 0;
+    for (size_t k = 0; k + 1 < tour.size(); k++) {
+        total += matrix[tour[k]][tour[k + 1]];
+    }
+    return total;
+}
 
-            if (!visited[v] && dist[u] != INF && dist[u] + weight < dist[v]) {
-                dist[v] = dist[u] + weight;
-                parent[v] = u;
-            }
+// Greedy nearest-neighbour tour from the depot
+vector<int> nearestNeighbourTour(const vector<vector<long long>>& matrix, bool returnToDepot) {
+    int n = (int)matrix.size();
+    vector<bool> visited(n, false);
+    vector<int> tour(1, 0);
+    visited[0] = true;
+
+    for (int step = 1; step < n; step++) {
+        int last = tour.back(), best = -1;
+        for (int j = 1; j < n; j++) {
+            if (!visited[j] && (best == -1 || matrix[last][j] < matrix[last][best])) best = j;
         }
+        visited[best] = true;
+        tour.push_back(best);
     }
+    if (returnToDepot) tour.push_back(0);
+    return tour;
+}
 
-    if (dist[endID] == INF) {
-        cout << RED << "\n[ERROR] No path exists between the locations!\n" << RESET;
-        cout << YELLOW << "[INFO] This may be due to blocked or unavailable roads.\n" << RESET;
-        return;
+// Cheapest insertion: grows the tour by inserting, each round, the stop
+// whose best insertion position adds the least cost
+vector<int> cheapestInsertionTour(const vector<vector<long long>>& matrix, bool returnToDepot) {
+    int n = (int)matrix.size();
+    vector<int> tour(1, 0);
+    if (returnToDepot) tour.push_back(0);
+    vector<bool> inserted(n, false);
+    inserted[0] = true;
+
+    for (int step = 1; step < n; step++) {
+        long long bestDelta = LLONG_MAX;
+        int bestStop = -1, bestPosition = -1;
+        for (int s = 1; s < n; s++) {
+            if (inserted[s]) continue;
+            size_t positions = tour.size() - (returnToDepot ? 1 : 0);   // never after the closing depot
+            for (size_t p = 0; p < positions; p++) {
+                long long delta = matrix[tour[p]][s];
+                if (p + 1 < tour.size()) delta += matrix[s][tour[p + 1]] - matrix[tour[p]][tour[p + 1]];
+                if (delta < bestDelta) {
+                    bestDelta = delta;
+                    bestStop = s;
+                    bestPosition = (int)p + 1;
+                }
+            }
+        }
+        inserted[bestStop] = true;
+        tour.insert(tour.begin() + bestPosition, bestStop);
     }
+    return tour;
+}
 
-    vector<int> path;
-    int current = endID;
-    while (current != -1) {
-        path.push_back(current);
-        current = parent[current];
+// One first-improvement 2-opt pass (segment reversal). Costs may be
+// asymmetric, so the reversed segment is re-costed; running sums keep each
+// candidate move O(1). Returns true if the tour improved.
+bool twoOptPass(const vector<vector<long long>>& matrix, vector<int>& tour, int lastMovable) {
+    for (int i = 1; i < lastMovable; i++) {
+        long long forwardSum = 0, reverseSum = 0;
+        for (int j = i + 1; j <= lastMovable; j++) {
+            forwardSum += matrix[tour[j - 1]][tour[j]];
+            reverseSum += matrix[tour[j]][tour[j - 1]];
+
+            long long before = matrix[tour[i - 1]][tour[i]] + forwardSum;
+            long long after = matrix[tour[i - 1]][tour[j]] + reverseSum;
+            if (j + 1 < (int)tour.size()) {
+                before += matrix[tour[j]][tour[j + 1]];
+                after += matrix[tour[i]][tour[j + 1]];
+            }
+            if (after < before) {
+                reverse(tour.begin() + i, tour.begin() + j + 1);
+                return true;
+            }
+        }
     }
-    reverse(path.begin(), path.end());
-
-    displaySection("SHORTEST PATH FOUND");
+    return false;
+}
 
-    cout << CYAN << "Path: " << RESET;
-    for (size_t i = 0; i < path.size(); i++) {
-        int locationIndex = findLocationIndexByID(path[i]);
-        if (locationIndex != -1) {
-            cout << YELLOW << locations[locationIndex].name << RESET;
-        } else {
-            cout << path[i];
+// One first-improvement Or-opt pass: moves a run of 1-3 consecutive stops
+// to another position in the tour. Returns true if the tour improved.
+bool orOptPass(const vector<vector<long long>>& matrix, vector<int>& tour, int lastMovable) {
+    int size = (int)tour.size();
+    for (int length = 1; length <= 3; length++) {
+        for (int i = 1; i + length - 1 <= lastMovable; i++) {
+            int first = tour[i], last = tour[i + length - 1];
+            int before = tour[i - 1];
+            bool hasAfter = (i + length < size);
+            int after = hasAfter ? tour[i + length] : -1;
+
+            long long removeGain = matrix[before][first] + (hasAfter ? matrix[last][after] - matrix[before][after] : 0);
+
+            for (int p = 0; p < size; p++) {
+                if (p >= i - 1 && p <= i + length - 1) continue;
+                if (p > lastMovable && lastMovable < size - 1) continue;   // keep the closing depot last
+                bool hasNext = (p + 1 < size);
+                long long insertCost = matrix[tour[p]][first] +
+                    (hasNext ? matrix[last][tour[p + 1]] - matrix[tour[p]][tour[p + 1]] : 0);
+
+                if (insertCost < removeGain) {
+                    vector<int> segment(tour.begin() + i, tour.begin() + i + length);
+                    tour.erase(tour.begin() + i, tour.begin() + i + length);
+                    int insertAt = (p < i) ? p + 1 : p + 1 - length;
+                    tour.insert(tour.begin() + insertAt, segment.begin(), segment.end());
+                    return true;
+                }
+            }
         }
-        if (i < path.size() - 1) cout << " -> ";
     }
-    cout << "\n";
-
-    cout << GREEN << "Total Weighted Distance: " << dist[endID] << " km" << RESET;
-    cout << YELLOW << " (includes traffic delays)\n" << RESET;
+    return false;
+}
 
-    double fuel = dist[endID] * 0.12;
-    double time = (double)dist[endID] / 40.0;
-    int hours = (int)time;
-    int minutes = (int)((time - hours) * 60);
-    double fuelCost = fuel * 1.5;
+// Orders the stops (stopIndices[0] is the depot) to minimise weighted
+// distance: best of two construction heuristics, then 2-opt and Or-opt until
+// no move improves or the time limit (ms, 0 = none) runs out.
+TripPlan optimiseTrip(const vector<int>& stopIndices, bool returnToDepot, int timeLimitMs) {
+    chrono::steady_clock::time_point deadline = chrono::steady_clock::now() + chrono::milliseconds(timeLimitMs);
 
-    displaySection("COST ESTIMATION");
-    cout << CYAN << "Route: " << RESET << findLocationNameByID(startID) << " -> " << findLocationNameByID(endID) << "\n";
-    cout << "+-------------------------------------------------+\n";
-    cout << "| " << left << setw(35) << "Detail" << "| " << right << setw(10) << "Value" << "|\n";
-    cout << "+-------------------------------------------------+\n";
-    cout << "| " << left << setw(35) << "Total Distance (weighted)"
-         << "| " << YELLOW << right << setw(10) << (to_string(dist[endID]) + " km") << RESET << "|\n";
-    cout << "| " << left << setw(35) << "Fuel Required"
-         << "| " << GREEN << right << setw(10) << fixed << setprecision(2) << fuel << " L" << RESET << "|\n";
-    cout << "| " << left << setw(35) << "Estimated Time"
-         << "| " << CYAN << right << setw(10) << hours << "h " << minutes << "m" << RESET << "|\n";
-    cout << "| " << left << setw(35) << "Fuel Cost ($1.50/L)"
-         << "| " << YELLOW << right << setw(10) << "$" << fixed << setprecision(2) << fuelCost << RESET << "|\n";
-    cout << "+-------------------------------------------------+\n";
+    vector<vector<long long>> matrix;
+    vector<vector<int>> parents;
+    buildStopMatrix(stopIndices, matrix, parents);
 
-    string pathStr = "";
-    for (size_t i = 0; i < path.size(); i++) {
-        int locationIndex = findLocationIndexByID(path[i]);
-        if (locationIndex != -1) {
-            pathStr += locations[locationIndex].name;
-        } else {
-            pathStr += to_string(path[i]);
-        }
-        if (i < path.size() - 1) pathStr += " -> ";
+    vector<int> tour = nearestNeighbourTour(matrix, returnToDepot);
+    vector<int> insertionTour = cheapestInsertionTour(matrix, returnToDepot);
+    if (tourCost(matrix, insertionTour) < tourCost(matrix, tour)) {
+        tour = insertionTour;
     }
-    pathStr += " (Distance: " + to_string(dist[endID]) + " km)";
 
-    Node* newNode = new Node();
-    newNode->path = pathStr;
-    newNode->next = routeHistoryHead;
-    routeHistoryHead = newNode;
+    int lastMovable = (int)tour.size() - (returnToDepot ? 2 : 1);
+    while (twoOptPass(matrix, tour, lastMovable) || orOptPass(matrix, tour, lastMovable)) {
+        if (timeLimitMs > 0 && chrono::steady_clock::now() >= deadline) break;
+    }
 
-    cout << GREEN << "\n[SUCCESS] Path saved to history!\n" << RESET;
+    TripPlan plan;
+    plan.order = tour;
+    plan.totalDistance = tourCost(matrix, tour);
+    plan.reachable = plan.totalDistance < TRIP_UNREACHABLE;
+
+    if (plan.reachable) {
+        plan.expandedPath.push_back(stopIndices[tour[0]]);
+        for (size_t k = 0; k + 1 < tour.size(); k++) {
+            vector<int> leg;
+            for (int v = stopIndices[tour[k + 1]]; v != stopIndices[tour[k]]; v = parents[tour[k]][v]) {
+                leg.push_back(v);
+            }
+            plan.expandedPath.insert(plan.expandedPath.end(), leg.rbegin(), leg.rend());
+        }
+    }
+    return plan;
 }
 
-// ============================================
-// ASCII MAP VIEW
-// ============================================
-
-void displayASCIIMap() {
-    if (locationCount == 0) {
-        cout << YELLOW << "\n[INFO] Add locations first to see the map.\n" << RESET;
+void tripOptimiserMenu() {
+    if (locationCount < 2) {
+        cout << YELLOW << "\n[INFO] Add at least 2 locations first.\n" << RESET;
         return;
     }
 
-    displaySection("ASCII MAP VIEW");
-    cout << "\nLocations and Road Network:\n\n";
+    viewLocations();
 
-    for (int i = 0; i < locationCount; i++) {
-        cout << "[" << YELLOW << locations[i].id << RESET << "] " << locations[i].name;
-        cout << "\n";
+    cout << "\nEnter Depot Location ID: ";
+    int depotID;
+    if (!(cin >> depotID)) {
+        clearBuffer();
+        cout << RED << "[ERROR] Invalid input!\n" << RESET;
+        return;
+    }
+    if (!locationExists(depotID)) {
+        cout << RED << "[ERROR] Location not found!\n" << RESET;
+        return;
+    }
 
-        int hasRoads = 0;
-        for (int j = 0; j < roadCount; j++) {
-            if (roads[j].fromID == locations[i].id) {
-                // Find destination location name
-                string destName = "Unknown";
-                for(int k=0; k<locationCount; ++k) {
-                    if(roads[j].toID == locations[k].id) {
-                        destName = locations[k].name;
-                        break;
-                    }
-                }
+    cout << "How many stops to visit? ";
+    int stopCount;
+    if (!(cin >> stopCount) || stopCount <= 0) {
+        clearBuffer();
+        cout << RED << "[ERROR] Invalid number of stops!\n" << RESET;
+        return;
+    }
 
-                // Determine color for status
-                string statusColor = RESET;
-                if (roads[j].status == "Normal") statusColor = GREEN;
-                else if (roads[j].status == "Heavy Traffic") statusColor = YELLOW;
-                else if (roads[j].status == "Blocked") statusColor = RED;
+    vector<int> stopIndices(1, findLocationIndexByID(depotID));
+    for (int s = 0; s < stopCount; s++) {
+        cout << "Enter Stop Location ID " << (s + 1) << ": ";
+        int id;
+        if (!(cin >> id)) {
+            clearBuffer();
+            cout << RED << "[ERROR] Invalid input!\n" << RESET;
+            return;
+        }
+        if (!locationExists(id)) {
+            cout << RED << "[ERROR] Location not found!\n" << RESET;
+            return;
+        }
+        stopIndices.push_back(findLocationIndexByID(id));
+    }
 
-                // Determine color for availability
-                string availColor = roads[j].isAvailable ? RESET : RED;
-                string availableStatus = roads[j].isAvailable ? "Available" : "Unavailable";
+    cout << "Return to depot at the end? (1 = Yes, 0 = No): ";
+    int returnChoice;
+    if (!(cin >> returnChoice) || (returnChoice != 0 && returnChoice != 1)) {
+        clearBuffer();
+        cout << RED << "[ERROR] Invalid input! Returning to depot by default.\n" << RESET;
+        returnChoice = 1;
+    }
 
-                cout << "    |--(" << YELLOW << roads[j].distance << "km" << RESET
-                     << ", " << statusColor << roads[j].status << RESET << ", "
-                     << availColor << availableStatus << RESET << ")--";
+    cout << "Time limit in ms (0 = no limit): ";
+    int timeLimitMs;
+    if (!(cin >> timeLimitMs) || timeLimitMs < 0) {
+        clearBuffer();
+        cout << RED << "[ERROR] Invalid input! Using no time limit.\n" << RESET;
+        timeLimitMs = 0;
+    }
 
-                // Indicate one-way road
-                if (roads[j].isOneWay) {
-                    cout << " (->)";
-                }
+    chrono::steady_clock::time_point started = chrono::steady_clock::now();
+    TripPlan plan = optimiseTrip(stopIndices, returnChoice == 1, timeLimitMs);
+    double elapsedMs = chrono::duration<double, milli>(chrono::steady_clock::now() - started).count();
 
-                cout << "[" << YELLOW << roads[j].toID << RESET << "] " << destName << "\n";
-                hasRoads++;
-            }
-        }
+    if (!plan.reachable) {
+        cout << RED << "\n[ERROR] Some stops cannot be reached from the others!\n" << RESET;
+        cout << YELLOW << "[INFO] This may be due to blocked, unavailable or one-way roads.\n" << RESET;
+        return;
+    }
 
-        if (hasRoads == 0) {
-            cout << "    (no outgoing roads)\n";
-        }
+    displaySection("OPTIMISED TRIP");
+    cout << CYAN << "Visit order: " << RESET;
+    for (size_t k = 0; k < plan.order.size(); k++) {
+        if (k > 0) cout << " -> ";
+        cout << YELLOW << locations[stopIndices[plan.order[k]]].name << RESET;
     }
+    cout << "\n" << CYAN << "Full path: " << RESET;
+    vector<NameRef> hops = locationPathNames(plan.expandedPath);
+    renderRouteHops(hops);
+    renderText("\n");
+    flushRender();
+    cout << GREEN << "Total Weighted Distance: " << plan.totalDistance << " km" << RESET << "\n";
+    cout << CYAN << "Optimised " << stopCount << " stop(s) in " << RESET
+         << fixed << setprecision(3) << elapsedMs << " ms\n";
+    closeSectionBorder();
 
-    cout << "\n";
+    saveRouteToHistory(hops, " (Trip: " + to_string(plan.totalDistance) + " km)");
+
+    cout << GREEN << "\n[SUCCESS] Trip saved to history!\n" << RESET;
 }
 
 // ============================================
-// SYSTEM STATISTICS
+// SHARDED ROUTING (GRAPH PARTITIONS)
 // ============================================
 
-void displaySystemStatistics() {
-    displaySection("SYSTEM STATISTICS");
-
-    cout << CYAN << "Total Locations: " << RESET << locationCount << "/" << MAX_LOCATIONS << "\n";
-    cout << CYAN << "Total Roads: " << RESET << roadCount << "/" << MAX_ROADS << "\n";
-
-    if (roadCount > 0) {
-        int normalCount = 0, heavyCount = 0, blockedCount = 0;
-        int availableCount = 0, unavailableCount = 0;
-        int oneWayCount = 0, bidirectionalCount = 0;
+// The graph is split into balanced partitions with few cut roads. Each
+// partition is served by a shard worker that holds only its own locations
+// and roads: a forked child process on POSIX systems, so what a process
+// holds is bounded by its partition, and a thread on Windows, which has no
+// fork(). The coordinator and the workers exchange messages of ints over
+// pipes. A worker receives its partition as its first message and never
+// reads the coordinator's tables (a forked child starts with a copy-on-write
+// view of them, which costs nothing while untouched). Cross-shard queries
+// run on an overlay graph of boundary locations whose edges are the cut
+// roads plus each shard's boundary-to-boundary distance table.
+
+const double SHARD_BALANCE_SLACK = 1.10;   // partitions may exceed the average size by 10%
+
+enum ShardRequestType {
+    SHARD_BUILD = 1,    // nodes, edges (local from, local to, weight), boundary -> boundary table
+    SHARD_FROM,         // start, end -> distances start -> each boundary location, then -> end
+    SHARD_TO,           // end -> distances each boundary location -> end
+    SHARD_PATH,         // from, to -> global indices of the shortest in-shard path
+    SHARD_STATS         // -> locations, roads, boundary locations, bytes
+};
 
-        for (int i = 0; i < roadCount; i++) {
-            if (roads[i].status == "Normal") normalCount++;
-            else if (roads[i].status == "Heavy Traffic") heavyCount++;
-            else if (roads[i].status == "Blocked") blockedCount++;
+struct RoutingShard {
+    vector<int> nodes;                      // global location indices
+    unordered_map<int, int> localIndex;     // global index -> position in nodes
+    vector<vector<GraphNode>> graph;        // local roads, destinations are local indices
+    vector<vector<GraphNode>> reverseGraph;
+    vector<int> boundary;                   // local indices of boundary locations
+    vector<vector<int>> boundaryTable;      // shortest in-shard distance boundary[i] -> boundary[j]
+};
 
-            if (roads[i].isAvailable) availableCount++;
-            else unavailableCount++;
+struct ShardWorker {
+    int requestFd;      // the coordinator writes requests here
+    int replyFd;        // ... and reads the answers here
+#ifdef _WIN32
+    thread worker;
+#else
+    pid_t process;
+#endif
+};
 
-            if (roads[i].isOneWay) oneWayCount++;
-            else bidirectionalCount++;
-        }
+struct OverlayEdge {
+    int destination;    // overlay node
+    int distance;
+    int shardId;        // shard whose table produced the edge, -1 for a cut road
+};
 
-        cout << "\nRoad Status Breakdown:\n";
-        cout << "  " << GREEN << "Normal Roads: " << normalCount << RESET << "\n";
-        cout << "  " << YELLOW << "Heavy Traffic: " << heavyCount << RESET << "\n";
-        cout << "  " << RED << "Blocked Roads: " << blockedCount << RESET << "\n";
+struct ShardedRouter {
+    int shardCount;
+    vector<int> shardOf;                    // per global location index
+    vector<vector<int>> boundaryOf;         // per shard: global indices of its boundary, in table order
+    vector<ShardWorker*> workers;
+    vector<int> overlayNodes;               // global index of each overlay node
+    unordered_map<int, int> overlayIndex;   // global index -> overlay node
+    vector<vector<OverlayEdge>> overlay;
+    int cutRoads;
+    bool workerLost;                        // a worker stopped answering
+};
 
-        cout << "\nRoad Availability:\n";
-        cout << "  " << GREEN << "Available Roads: " << availableCount << RESET << "\n";
-        cout << "  " << RED << "Unavailable Roads: " << unavailableCount << RESET << "\n";
+bool openPipe(int descriptors[2]) {
+#ifdef _WIN32
+    return _pipe(descriptors, 1 << 16, _O_BINARY) == 0;
+#else
+    return pipe(descriptors) == 0;
+#endif
+}
 
-        cout << "\nRoad Direction:\n";
-        cout << "  " << CYAN << "One-Way Roads: " << oneWayCount << RESET << "\n";
-        cout << "  " << BLUE << "Bidirectional Roads: " << (bidirectionalCount / 2) << RESET << "\n";
+void closeDescriptor(int descriptor) {
+#ifdef _WIN32
+    _close(descriptor);
+#else
+    close(descriptor);
+#endif
+}
 
-        int totalDistance = 0;
-        for (int i = 0; i < roadCount; i++) {
-            totalDistance += roads[i].distance;
-        }
-        double avgDistance = (double)totalDistance / roadCount;
-        cout << fixed << setprecision(2);
-        cout << "\n" << CYAN << "Average Road Distance: " << RESET << avgDistance << " km\n";
+bool writeDescriptor(int descriptor, const char* data, size_t bytes) {
+    while (bytes > 0) {
+#ifdef _WIN32
+        int written = _write(descriptor, data, (unsigned int)min(bytes, (size_t)1 << 20));
+#else
+        ssize_t written = write(descriptor, data, bytes);
+        if (written < 0 && errno == EINTR) continue;
+#endif
+        if (written <= 0) return false;
+        data += written;
+        bytes -= (size_t)written;
     }
+    return true;
+}
 
-    // Count routes in history
-    int routeCount = 0;
-    Node* current = routeHistoryHead;
-    while (current != nullptr) {
-        routeCount++;
-        current = current->next;
+bool readDescriptor(int descriptor, char* data, size_t bytes) {
+    while (bytes > 0) {
+#ifdef _WIN32
+        int got = _read(descriptor, data, (unsigned int)min(bytes, (size_t)1 << 20));
+#else
+        ssize_t got = read(descriptor, data, bytes);
+        if (got < 0 && errno == EINTR) continue;
+#endif
+        if (got <= 0) return false;
+        data += got;
+        bytes -= (size_t)got;
     }
-    cout << CYAN << "Paths in History: " << RESET << routeCount << "\n";
+    return true;
 }
 
-// ============================================
-// TRAFFIC SIMULATION
-// ============================================
+// A message is its int count followed by the ints, in host byte order
+bool sendInts(int descriptor, const vector<int>& message) {
+    int count = (int)message.size();
+    return writeDescriptor(descriptor, (const char*)&count, sizeof(count)) &&
+           writeDescriptor(descriptor, (const char*)message.data(), message.size() * sizeof(int));
+}
 
-void trafficSimulation() {
-    if (roadCount == 0) {
-        cout << YELLOW << "\n[INFO] No roads available for traffic simulation.\n" << RESET;
-        return;
-    }
+bool receiveInts(int descriptor, vector<int>& message) {
+    int count;
+    if (!readDescriptor(descriptor, (char*)&count, sizeof(count)) || count < 0) return false;
+    message.resize(count);
+    return readDescriptor(descriptor, (char*)message.data(), message.size() * sizeof(int));
+}
 
-    displaySection("TRAFFIC SIMULATION");
-    cout << "1. View Current Traffic Status\n";
-    cout << "2. Update Road Status\n";
-    // Added new menu option
-    cout << "3. Toggle Road Availability\n";
-    cout << "4. Back to Main Menu\n";
-    cout << "Enter choice: ";
+// Worker side of SHARD_BUILD: takes the partition out of the message and
+// returns the boundary-to-boundary table (row-major) for the overlay
+void buildShard(RoutingShard& shard, const vector<int>& message, vector<int>& table) {
+    size_t at = 1;
+    int nodeCount = message[at++];
+    shard.nodes.assign(message.begin() + at, message.begin() + at + nodeCount);
+    at += nodeCount;
+    for (int l = 0; l < nodeCount; l++) shard.localIndex[shard.nodes[l]] = l;
+
+    shard.graph.assign(nodeCount, vector<GraphNode>());
+    shard.reverseGraph.assign(nodeCount, vector<GraphNode>());
+    int edgeCount = message[at++];
+    for (int e = 0; e < edgeCount; e++, at += 3) {
+        GraphNode edge;
+        edge.destination = message[at + 1];
+        edge.distance = message[at + 2];
+        edge.roadIndex = -1;
+        shard.graph[message[at]].push_back(edge);
+        edge.destination = message[at];
+        shard.reverseGraph[message[at + 1]].push_back(edge);
+    }
+    int boundaryCount = message[at++];
+    shard.boundary.assign(message.begin() + at, message.begin() + at + boundaryCount);
+
+    size_t b = shard.boundary.size();
+    vector<int> dist, parent;
+    table.clear();
+    shard.boundaryTable.assign(b, vector<int>(b));
+    for (size_t i = 0; i < b; i++) {
+        dijkstraFromIndex(shard.graph, shard.boundary[i], dist, parent);
+        for (size_t j = 0; j < b; j++) {
+            shard.boundaryTable[i][j] = dist[shard.boundary[j]];
+            table.push_back(dist[shard.boundary[j]]);
+        }
+    }
+}
 
-    int choice;
-    if (!(cin >> choice)) {
-        clearBuffer();
-        cout << RED << "[ERROR] Invalid input!\n" << RESET;
-        return;
+// Approximate memory held by one shard
+size_t shardMemoryBytes(const RoutingShard& shard) {
+    size_t bytes = shard.nodes.size() * (sizeof(int) * 3 + 2 * sizeof(vector<GraphNode>));
+    for (size_t l = 0; l < shard.graph.size(); l++) {
+        bytes += (shard.graph[l].size() + shard.reverseGraph[l].size()) * sizeof(GraphNode);
     }
+    bytes += shard.boundary.size() * shard.boundary.size() * sizeof(int);
+    return bytes;
+}
 
-    if (choice == 1) {
-        viewRoads();
-    } else if (choice == 2) {
-        updateRoadStatus();
-    } else if (choice == 3) {
-        toggleRoadAvailability();
-    } else if (choice == 4) {
-        // Back to Main Menu is handled by the caller implicitly
-    } else {
-        cout << RED << "[ERROR] Invalid choice!\n" << RESET;
+void answerShardRequest(RoutingShard& shard, const vector<int>& request, vector<int>& answer) {
+    vector<int> dist, parent;
+    answer.clear();
+    switch (request[0]) {
+        case SHARD_BUILD:
+            buildShard(shard, request, answer);
+            break;
+        case SHARD_FROM: {
+            dijkstraFromIndex(shard.graph, shard.localIndex.at(request[1]), dist, parent);
+            for (size_t i = 0; i < shard.boundary.size(); i++) answer.push_back(dist[shard.boundary[i]]);
+            unordered_map<int, int>::const_iterator end = shard.localIndex.find(request[2]);
+            answer.push_back(end != shard.localIndex.end() ? dist[end->second] : INF_DISTANCE);
+            break;
+        }
+        case SHARD_TO:
+            dijkstraFromIndex(shard.reverseGraph, shard.localIndex.at(request[1]), dist, parent);
+            for (size_t i = 0; i < shard.boundary.size(); i++) answer.push_back(dist[shard.boundary[i]]);
+            break;
+        case SHARD_PATH: {
+            int from = shard.localIndex.at(request[1]), to = shard.localIndex.at(request[2]);
+            dijkstraFromIndex(shard.graph, from, dist, parent);
+            if (dist[to] == INF_DISTANCE) break;
+            for (int v = to; v != -1; v = parent[v]) answer.push_back(shard.nodes[v]);
+            reverse(answer.begin(), answer.end());
+            break;
+        }
+        case SHARD_STATS: {
+            size_t roadsInShard = 0;
+            for (size_t l = 0; l < shard.graph.size(); l++) roadsInShard += shard.graph[l].size();
+            answer.push_back((int)shard.nodes.size());
+            answer.push_back((int)roadsInShard);
+            answer.push_back((int)shard.boundary.size());
+            answer.push_back((int)shardMemoryBytes(shard));
+            break;
+        }
     }
 }
 
-// ============================================
-// PATH COST ESTIMATOR
-// ============================================
+// Worker loop: answers requests in order until the coordinator closes its end
+void serveShard(int requestFd, int replyFd) {
+    RoutingShard shard;
+    vector<int> request, answer;
+    while (receiveInts(requestFd, request) && !request.empty()) {
+        answerShardRequest(shard, request, answer);
+        if (!sendInts(replyFd, answer)) break;
+    }
+}
 
-void pathCostEstimator() {
-    if (locationCount < 2) {
-        cout << YELLOW << "\n[INFO] Add at least 2 locations first.\n" << RESET;
-        return;
+// Starts the worker for one shard. A forked child keeps only its own pipe
+// ends; stray copies of other workers' request pipes would keep those
+// workers from ever seeing end-of-file.
+bool startShardWorker(ShardWorker* worker, const vector<ShardWorker*>& started) {
+    int requests[2], replies[2];
+    if (!openPipe(requests)) return false;
+    if (!openPipe(replies)) {
+        closeDescriptor(requests[0]);
+        closeDescriptor(requests[1]);
+        return false;
     }
+    worker->requestFd = requests[1];
+    worker->replyFd = replies[0];
+#ifdef _WIN32
+    int in = requests[0], out = replies[1];
+    worker->worker = thread([in, out]() {
+        serveShard(in, out);
+        closeDescriptor(in);
+        closeDescriptor(out);
+    });
+    return true;
+#else
+    signal(SIGPIPE, SIG_IGN);   // a lost worker shows up as a failed write instead
+    pid_t child = fork();
+    if (child == 0) {
+        closeDescriptor(requests[1]);
+        closeDescriptor(replies[0]);
+        for (size_t w = 0; w < started.size(); w++) {
+            closeDescriptor(started[w]->requestFd);
+            closeDescriptor(started[w]->replyFd);
+        }
+        serveShard(requests[0], replies[1]);
+        _exit(0);
+    }
+    closeDescriptor(requests[0]);
+    closeDescriptor(replies[1]);
+    if (child < 0) {
+        closeDescriptor(requests[1]);
+        closeDescriptor(replies[0]);
+        return false;
+    }
+    worker->process = child;
+    return true;
+#endif
+}
 
-    viewLocations();
+// Closing the request pipe ends the worker's loop; closing the reply pipe
+// first makes a worker still writing an unread answer fail instead of block
+void stopShardWorker(ShardWorker* worker) {
+    closeDescriptor(worker->replyFd);
+    closeDescriptor(worker->requestFd);
+#ifdef _WIN32
+    worker->worker.join();
+#else
+    waitpid(worker->process, nullptr, 0);
+#endif
+}
 
-    int startID, endID;
-    cout << "\nEnter Start Location ID: ";
-    if (!(cin >> startID)) {
-        clearBuffer();
-        cout << RED << "[ERROR] Invalid input!\n" << RESET;
-        return;
-    }
+// Requests are answered in the order they were sent, so a caller can send
+// to several shards first and then collect the answers while they work
+void shardSend(ShardedRouter* router, int shardId, const vector<int>& request) {
+    if (!sendInts(router->workers[shardId]->requestFd, request)) router->workerLost = true;
+}
 
-    cout << "Enter End Location ID: ";
-    if (!(cin >> endID)) {
-        clearBuffer();
-        cout << RED << "[ERROR] Invalid input!\n" << RESET;
-        return;
+vector<int> shardReceive(ShardedRouter* router, int shardId) {
+    vector<int> answer;
+    if (router->workerLost || !receiveInts(router->workers[shardId]->replyFd, answer)) {
+        router->workerLost = true;
+        answer.clear();
     }
+    return answer;
+}
 
-    if (!locationExists(startID) || !locationExists(endID)) {
-        cout << RED << "[ERROR] Invalid location IDs!\n" << RESET;
-        return;
-    }
+vector<int> shardCall(ShardedRouter* router, int shardId, const vector<int>& request) {
+    shardSend(router, shardId, request);
+    return shardReceive(router, shardId);
+}
 
-    if (startID == endID) {
-        cout << YELLOW << "[INFO] Start and end locations are the same! No travel needed.\n" << RESET;
+// Recursive coordinate bisection: split along the wider axis at the point
+// that gives each side its share of the partitions
+void bisectLocations(vector<int> nodes, int parts, int firstPart, vector<int>& shardOf) {
+    if (parts == 1 || nodes.size() <= 1) {
+        for (size_t i = 0; i < nodes.size(); i++) shardOf[nodes[i]] = firstPart;
         return;
     }
 
-    vector<GraphNode> adjacencyList[500];
-    for (int i = 0; i < roadCount; i++) {
-        if (roads[i].status != "Blocked" && roads[i].isAvailable) {
-            GraphNode gn;
-            gn.destination = roads[i].toID;
+    double minLat = 90, maxLat = -90, minLon = 180, maxLon = -180;
+    for (size_t i = 0; i < nodes.size(); i++) {
+        minLat = min(minLat, locations[nodes[i]].latitude);
+        maxLat = max(maxLat, locations[nodes[i]].latitude);
+        minLon = min(minLon, locations[nodes[i]].longitude);
+        maxLon = max(maxLon, locations[nodes[i]].longitude);
+    }
+    bool byLatitude = (maxLat - minLat) * KM_PER_DEGREE_LAT >= (maxLon - minLon) * KM_PER_DEGREE_LON * cos(minLat * 3.14159265358979323846 / 180.0);
+    sort(nodes.begin(), nodes.end(), [byLatitude](int a, int b) {
+        return byLatitude ? locations[a].latitude < locations[b].latitude : locations[a].longitude < locations[b].longitude;
+    });
+
+    int leftParts = parts / 2;
+    size_t split = nodes.size() * leftParts / parts;
+    bisectLocations(vector<int>(nodes.begin(), nodes.begin() + split), leftParts, firstPart, shardOf);
+    bisectLocations(vector<int>(nodes.begin() + split, nodes.end()), parts - leftParts, firstPart + leftParts, shardOf);
+}
 
-            double multiplier = 1.0;
-            if (roads[i].status == "Heavy Traffic") {
-                multiplier = 1.5;
+// Greedy boundary refinement: moves a location to a neighbouring partition
+// when that removes cut roads and keeps both partitions within balance
+void refinePartition(const vector<vector<GraphNode>>& graph, const vector<vector<GraphNode>>& reverseGraph,
+                     int parts, vector<int>& shardOf) {
+    int n = (int)shardOf.size();
+    int maxSize = (int)ceil((double)n / parts * SHARD_BALANCE_SLACK);
+    int minSize = max(1, n / parts - (maxSize - n / parts));
+    vector<int> sizes(parts, 0);
+    for (int v = 0; v < n; v++) sizes[shardOf[v]]++;
+
+    for (int pass = 0; pass < 8; pass++) {
+        bool moved = false;
+        for (int v = 0; v < n; v++) {
+            vector<int> links(parts, 0);
+            for (size_t j = 0; j < graph[v].size(); j++) links[shardOf[graph[v][j].destination]]++;
+            for (size_t j = 0; j < reverseGraph[v].size(); j++) links[shardOf[reverseGraph[v][j].destination]]++;
+
+            int from = shardOf[v], best = from;
+            for (int p = 0; p < parts; p++) {
+                if (p != from && links[p] > links[best] && sizes[p] < maxSize && sizes[from] > minSize) best = p;
+            }
+            if (best != from) {
+                shardOf[v] = best;
+                sizes[from]--;
+                sizes[best]++;
+                moved = true;
             }
-            gn.distance = (int)(roads[i].distance * multiplier);
-
-            adjacencyList[roads[i].fromID].push_back(gn);
         }
+        if (!moved) break;
     }
+}
 
-    const int INF = INT_MAX;
-    int dist[500];
-    int parent[500];
-    bool visited[500];
-
-    for (int i = 0; i < 500; i++) {
-        dist[i] = INF;
-        parent[i] = -1;
-        visited[i] = false;
+void destroyShardedRouter(ShardedRouter* router) {
+    for (size_t p = 0; p < router->workers.size(); p++) {
+        stopShardWorker(router->workers[p]);
+        delete router->workers[p];
     }
+    delete router;
+}
 
-    dist[startID] = 0;
+// Builds partitions, starts one worker per shard and assembles the overlay.
+// The full adjacency lists exist only while partitioning; each worker is
+// sent its own locations and roads and builds its graph from them. Returns
+// nullptr if a worker could not be started or stopped answering.
+ShardedRouter* buildShardedRouter(int shardCount) {
+    TraceSpan span("sharded router build", "preprocessing");
+    span.counter("shards", shardCount);
+    shared_ptr<const GraphSnapshot> snapshot = expandGraphSnapshot(acquireGraphSnapshot());
+    int n = snapshot->locationCount;
+
+    ShardedRouter* router = new ShardedRouter();
+    router->shardCount = shardCount;
+    router->workerLost = false;
+    router->shardOf.assign(n, 0);
+    {
+        vector<vector<GraphNode>> forwardGraph, reverseGraph;
+        snapshotGraphs(*snapshot, forwardGraph, reverseGraph);
+        vector<int> all(n);
+        for (int v = 0; v < n; v++) all[v] = v;
+        bisectLocations(all, shardCount, 0, router->shardOf);
+        refinePartition(forwardGraph, reverseGraph, shardCount, router->shardOf);
+    }
 
-    for (int count = 0; count < locationCount; count++) {
-        int u = -1;
-        int minDist = INF;
+    // Boundary locations have at least one road crossing into another shard
+    vector<bool> isBoundary(n, false);
+    router->cutRoads = 0;
+    for (int u = 0; u < n; u++) {
+        const EdgeBlock& block = snapshotBlock(*snapshot, u);
+        for (size_t j = 0; j < block.size(); j++) {
+            int v = block[j].destination;
+            if (router->shardOf[u] != router->shardOf[v]) {
+                isBoundary[u] = isBoundary[v] = true;
+                router->cutRoads++;
+            }
+        }
+    }
 
-        for (int i = 0; i < 500; i++) {
-            if (!visited[i] && dist[i] < minDist) {
-                u = i;
-                minDist = dist[i];
+    // Each worker gets its partition as one message: its locations in
+    // ascending order, its internal roads and its boundary locations. The
+    // workers then build their boundary tables concurrently.
+    vector<int> localOf(n);
+    vector<int> counted(shardCount, 0);
+    for (int v = 0; v < n; v++) localOf[v] = counted[router->shardOf[v]]++;
+    for (int p = 0; p < shardCount; p++) {
+        ShardWorker* worker = new ShardWorker();
+        if (!startShardWorker(worker, router->workers)) {
+            delete worker;
+            destroyShardedRouter(router);
+            return nullptr;
+        }
+        router->workers.push_back(worker);
+
+        vector<int> nodes, edges, boundary;
+        for (int u = 0; u < n; u++) {
+            if (router->shardOf[u] != p) continue;
+            nodes.push_back(u);
+            if (isBoundary[u]) boundary.push_back(localOf[u]);
+            const EdgeBlock& block = snapshotBlock(*snapshot, u);
+            for (size_t j = 0; j < block.size(); j++) {
+                if (router->shardOf[block[j].destination] != p) continue;
+                edges.push_back(localOf[u]);
+                edges.push_back(localOf[block[j].destination]);
+                edges.push_back(block[j].distance);
             }
         }
+        vector<int> message(1, SHARD_BUILD);
+        message.push_back((int)nodes.size());
+        message.insert(message.end(), nodes.begin(), nodes.end());
+        message.push_back((int)edges.size() / 3);
+        message.insert(message.end(), edges.begin(), edges.end());
+        message.push_back((int)boundary.size());
+        message.insert(message.end(), boundary.begin(), boundary.end());
+        shardSend(router, p, message);
+    }
 
-        if (u == -1 || dist[u] == INF) break;
+    // Boundary lists in the order the shards number them (ascending location index)
+    router->boundaryOf.assign(shardCount, vector<int>());
+    for (int v = 0; v < n; v++) {
+        if (!isBoundary[v]) continue;
+        router->boundaryOf[router->shardOf[v]].push_back(v);
+        router->overlayIndex[v] = (int)router->overlayNodes.size();
+        router->overlayNodes.push_back(v);
+    }
+    router->overlay.assign(router->overlayNodes.size(), vector<OverlayEdge>());
+    for (int u = 0; u < n; u++) {
+        const EdgeBlock& block = snapshotBlock(*snapshot, u);
+        for (size_t j = 0; j < block.size(); j++) {
+            int v = block[j].destination;
+            if (router->shardOf[u] == router->shardOf[v]) continue;
+            OverlayEdge edge = {router->overlayIndex[v], block[j].distance, -1};
+            router->overlay[router->overlayIndex[u]].push_back(edge);
+        }
+    }
+    for (int p = 0; p < shardCount; p++) {
+        vector<int> flat = shardReceive(router, p);
+        const vector<int>& boundary = router->boundaryOf[p];
+        size_t b = boundary.size();
+        if (flat.size() != b * b) router->workerLost = true;
+        if (router->workerLost) {
+            destroyShardedRouter(router);
+            return nullptr;
+        }
+        for (size_t i = 0; i < b; i++) {
+            for (size_t j = 0; j < b; j++) {
+                int d = flat[i * b + j];
+                if (i == j || d == INF_DISTANCE) continue;
+                OverlayEdge edge = {router->overlayIndex[boundary[j]], d, p};
+                router->overlay[router->overlayIndex[boundary[i]]].push_back(edge);
+            }
+        }
+    }
+    return router;
+}
 
-        visited[u] = true;
+// Shortest in-shard path between two global locations, as global indices
+vector<int> shardLocalPath(ShardedRouter* router, int shardId, int fromGlobal, int toGlobal) {
+    vector<int> request(1, SHARD_PATH);
+    request.push_back(fromGlobal);
+    request.push_back(toGlobal);
+    return shardCall(router, shardId, request);
+}
 
-        for (size_t j = 0; j < adjacencyList[u].size(); j++) {
-            int v = adjacencyList[u][j].destination;
-            int weight = adjacencyList[u][j].distance;
+// Answers a query through the shards. The start shard reports distances
+// from the start to its boundary (and to the end if it is local), the end
+// shard reports distances from its boundary to the end, and the coordinator
+// joins them with a Dijkstra over the overlay graph. Both shards work on
+// their half at the same time. Returns INF_DISTANCE if there is no path or
+// a worker stopped answering (router->workerLost).
+int shardedShortestPath(ShardedRouter* router, int startIndex, int endIndex, vector<int>& path) {
+    path.clear();
+    int startShard = router->shardOf[startIndex], endShard = router->shardOf[endIndex];
+
+    vector<int> fromStart(1, SHARD_FROM), toEnd(1, SHARD_TO);
+    fromStart.push_back(startIndex);
+    fromStart.push_back(endIndex);
+    toEnd.push_back(endIndex);
+    shardSend(router, startShard, fromStart);
+    shardSend(router, endShard, toEnd);
+    vector<int> startDist = shardReceive(router, startShard);
+    vector<int> endDist = shardReceive(router, endShard);
+    const vector<int>& firstBoundary = router->boundaryOf[startShard];
+    const vector<int>& lastBoundary = router->boundaryOf[endShard];
+    if (startDist.size() != firstBoundary.size() + 1 || endDist.size() != lastBoundary.size()) {
+        router->workerLost = true;
+        return INF_DISTANCE;
+    }
 
-            if (!visited[v] && dist[u] != INF && dist[u] + weight < dist[v]) {
-                dist[v] = dist[u] + weight;
-                parent[v] = u;
+    int best = startDist.back();
+    int bestExit = -1;      // overlay node leaving towards the end, -1 = stay inside the start shard
+
+    size_t n = router->overlayNodes.size();
+    vector<int> dist(n, INF_DISTANCE), parent(n, -1), viaShard(n, startShard);
+    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> pq;
+    for (size_t i = 0; i < firstBoundary.size(); i++) {
+        int node = router->overlayIndex[firstBoundary[i]];
+        if (startDist[i] < dist[node]) {
+            dist[node] = startDist[i];
+            pq.push(make_pair(startDist[i], node));
+        }
+    }
+    while (!pq.empty()) {
+        int d = pq.top().first, u = pq.top().second;
+        pq.pop();
+        if (d > dist[u] || d >= best) continue;
+        for (size_t j = 0; j < router->overlay[u].size(); j++) {
+            const OverlayEdge& edge = router->overlay[u][j];
+            if (d + edge.distance < dist[edge.destination]) {
+                dist[edge.destination] = d + edge.distance;
+                parent[edge.destination] = u;
+                viaShard[edge.destination] = edge.shardId;
+                pq.push(make_pair(dist[edge.destination], edge.destination));
             }
         }
     }
+    for (size_t i = 0; i < lastBoundary.size(); i++) {
+        int node = router->overlayIndex[lastBoundary[i]];
+        if (dist[node] != INF_DISTANCE && endDist[i] != INF_DISTANCE && dist[node] + endDist[i] < best) {
+            best = dist[node] + endDist[i];
+            bestExit = node;
+        }
+    }
+    if (best == INF_DISTANCE) return INF_DISTANCE;
 
-    if (dist[endID] == INF) {
-        cout << RED << "\n[ERROR] No path exists between the locations!\n" << RESET;
-        return;
+    // Expand: start -> first boundary, overlay hops (cut roads or shard
+    // segments), last boundary -> end
+    if (bestExit == -1) {
+        path = shardLocalPath(router, startShard, startIndex, endIndex);
+        return best;
+    }
+    vector<int> hops;
+    for (int node = bestExit; node != -1; node = parent[node]) hops.push_back(node);
+    reverse(hops.begin(), hops.end());
+
+    path = shardLocalPath(router, startShard, startIndex, router->overlayNodes[hops[0]]);
+    for (size_t h = 1; h < hops.size(); h++) {
+        int from = router->overlayNodes[hops[h - 1]], to = router->overlayNodes[hops[h]];
+        if (viaShard[hops[h]] == -1) {
+            path.push_back(to);
+        } else {
+            vector<int> segment = shardLocalPath(router, viaShard[hops[h]], from, to);
+            if (segment.empty()) break;
+            path.insert(path.end(), segment.begin() + 1, segment.end());
+        }
     }
+    vector<int> tail = shardLocalPath(router, endShard, router->overlayNodes[hops.back()], endIndex);
+    if (!tail.empty()) path.insert(path.end(), tail.begin() + 1, tail.end());
+    return router->workerLost ? INF_DISTANCE : best;
+}
 
-    int totalDistance = dist[endID];
+void shardedRoutingMenu() {
+    if (locationCount < 2) {
+        cout << YELLOW << "\n[INFO] Add at least 2 locations first.\n" << RESET;
+        return;
+    }
 
-    displaySection("PATH COST ESTIMATE");
+    cout << "\nNumber of shards (2-" << min(8, locationCount) << "): ";
+    int shardCount;
+    if (!(cin >> shardCount) || shardCount < 2 || shardCount > min(8, locationCount)) {
+        clearBuffer();
+        cout << RED << "[ERROR] Invalid number of shards!\n" << RESET;
+        return;
+    }
 
-    string startLocationName = findLocationNameByID(startID);
-    string endLocationName = findLocationNameByID(endID);
+    chrono::steady_clock::time_point started = chrono::steady_clock::now();
+    ShardedRouter* router = buildShardedRouter(shardCount);
+    double buildMs = chrono::duration<double, milli>(chrono::steady_clock::now() - started).count();
+    if (router == nullptr) {
+        cout << RED << "[ERROR] Could not start the shard workers!\n" << RESET;
+        return;
+    }
 
-    cout << CYAN << "Route: " << RESET << startLocationName << " -> " << endLocationName << "\n";
-    cout << "+-------------------------------------------------+\n";
-    cout << "| " << left << setw(35) << "Detail" << "| " << right << setw(10) << "Value" << "|\n";
-    cout << "+-------------------------------------------------+\n";
-    cout << "| " << left << setw(35) << "Total Distance (weighted)"
-         << "| " << YELLOW << right << setw(10) << (to_string(totalDistance) + " km") << RESET << "|\n";
+    displaySection("PARTITIONS");
+    cout << "| " << left << setw(6) << "Shard" << "| " << left << setw(10) << "Locations"
+         << "| " << left << setw(10) << "Roads" << "| " << left << setw(10) << "Boundary"
+         << "| " << left << setw(10) << "Memory" << "|\n";
+    cout << "+-------+-----------+-----------+-----------+-----------+\n";
+    for (int p = 0; p < shardCount; p++) {
+        // locations, roads, boundary locations, bytes
+        vector<int> stats = shardCall(router, p, vector<int>(1, SHARD_STATS));
+        if (stats.size() != 4) stats.assign(4, 0);
+        cout << "| " << YELLOW << left << setw(6) << p << RESET
+             << "| " << left << setw(10) << stats[0]
+             << "| " << left << setw(10) << stats[1]
+             << "| " << left << setw(10) << stats[2]
+             << "| " << left << setw(10) << (to_string(stats[3]) + " B") << "|\n";
+    }
+    closeSectionBorder();
+    cout << CYAN << "Cut roads: " << RESET << router->cutRoads
+         << CYAN << "   Overlay locations: " << RESET << router->overlayNodes.size()
+         << CYAN << "   Build time: " << RESET << fixed << setprecision(3) << buildMs << " ms\n";
+#ifdef _WIN32
+    cout << CYAN << "Workers: " << RESET << shardCount << " threads (no fork() on Windows)\n";
+#else
+    cout << CYAN << "Workers: " << RESET << shardCount << " processes\n";
+#endif
 
-    double fuelEstimate = totalDistance * 0.12;
-    cout << "| " << left << setw(35) << "Fuel Required"
-         << "| " << GREEN << right << setw(10) << fixed << setprecision(2) << fuelEstimate << " L" << RESET << "|\n";
+    while (true) {
+        cout << "\nEnter Start Location ID (0 to go back): ";
+        int startID;
+        if (!(cin >> startID)) {
+            clearBuffer();
+            cout << RED << "[ERROR] Invalid input!\n" << RESET;
+            continue;
+        }
+        if (startID == 0) break;
+        cout << "Enter End Location ID: ";
+        int endID;
+        if (!(cin >> endID)) {
+            clearBuffer();
+            cout << RED << "[ERROR] Invalid input!\n" << RESET;
+            continue;
+        }
+        if (!locationExists(startID) || !locationExists(endID) || startID == endID) {
+            cout << RED << "[ERROR] Invalid location IDs!\n" << RESET;
+            continue;
+        }
 
-    double timeEstimate = (double)totalDistance / 40.0;
-    int hours = (int)timeEstimate;
-    int minutes = (int)((timeEstimate - hours) * 60);
-    cout << "| " << left << setw(35) << "Estimated Time"
-         << "| " << CYAN << right << setw(10) << hours << "h " << minutes << "m" << RESET << "|\n";
+        int startIndex = findLocationIndexByID(startID), endIndex = findLocationIndexByID(endID);
+        vector<int> path;
+        started = chrono::steady_clock::now();
+        int distance = shardedShortestPath(router, startIndex, endIndex, path);
+        double queryUs = chrono::duration<double, micro>(chrono::steady_clock::now() - started).count();
 
-    double fuelCost = fuelEstimate * 1.50;
-    cout << "| " << left << setw(35) << "Fuel Cost ($1.50/L)"
-         << "| " << YELLOW << right << setw(10) << "$" << fixed << setprecision(2) << fuelCost << RESET << "|\n";
+        if (router->workerLost) {
+            cout << RED << "[ERROR] A shard worker stopped answering!\n" << RESET;
+            break;
+        }
+        if (distance == INF_DISTANCE) {
+            cout << RED << "[ERROR] No path exists between the locations!\n" << RESET;
+            continue;
+        }
+        cout << CYAN << "Path: " << RESET;
+        for (size_t i = 0; i < path.size(); i++) {
+            if (i > 0) cout << " -> ";
+            cout << YELLOW << locations[path[i]].name << RESET << " (S" << router->shardOf[path[i]] << ")";
+        }
+        cout << "\n" << GREEN << "Total Weighted Distance: " << distance << " km" << RESET
+             << " (answered in " << fixed << setprecision(1) << queryUs << " us via shards "
+             << router->shardOf[startIndex] << " -> " << router->shardOf[endIndex] << ")\n";
+
+        vector<int> dist;
+        snapshotDijkstra(*acquireGraphSnapshot(), startIndex, dist);
+        cout << "Single-graph check: " << dist[endIndex] << " km "
+             << (dist[endIndex] == distance ? GREEN : RED)
+             << (dist[endIndex] == distance ? "(match)" : "(MISMATCH)") << RESET << "\n";
+    }
 
-    cout << "+-------------------------------------------------+\n";
+    destroyShardedRouter(router);
 }
 
 // ============================================
@@ -1250,7 +8405,9 @@ void locationManagementMenu() {
         cout << "1. Add Location\n";
         cout << "2. View All Locations\n";
         cout << "3. Delete Location\n";
-        cout << "4. Back to Main Menu\n";
+        cout << "4. Find Nearest Locations (GPS Point)\n";
+        cout << "5. List Locations in Map Viewport\n";
+        cout << "6. Back to Main Menu\n";
         cout << "Enter choice: ";
 
         int choice;
@@ -1267,6 +8424,10 @@ void locationManagementMenu() {
         } else if (choice == 3) {
             deleteLocation();
         } else if (choice == 4) {
+            findNearestLocations();
+        } else if (choice == 5) {
+            listLocationsInViewport();
+        } else if (choice == 6) {
             break;
         } else {
             cout << RED << "[ERROR] Invalid choice!\n" << RESET;
@@ -1317,6 +8478,178 @@ void roadManagementMenu() {
     }
 }
 
+// ============================================
+// DISPLAY SETTINGS MENU
+// ============================================
+
+void displaySettingsMenu() {
+    while (true) {
+        displaySection("DISPLAY SETTINGS");
+        cout << "1. Toggle Colours (currently " << (colorEnabled ? "ON" : "OFF") << ")\n";
+        cout << "2. Set Listing Page Size (currently "
+             << (listingPageSize > 0 ? to_string(listingPageSize) + " rows" : string("no paging")) << ")\n";
+        cout << "3. Back to Main Menu\n";
+        cout << "Enter choice: ";
+
+        int choice;
+        if (!(cin >> choice)) {
+            clearBuffer();
+            cout << RED << "[ERROR] Invalid input!\n" << RESET;
+            continue;
+        }
+
+        if (choice == 1) {
+            colorEnabled = !colorEnabled;
+            cout << GREEN << "[SUCCESS] Colours turned " << (colorEnabled ? "on" : "off") << "!\n" << RESET;
+        } else if (choice == 2) {
+            cout << "Enter rows per page (0 = no paging): ";
+            int pageSize;
+            if (!(cin >> pageSize) || pageSize < 0) {
+                clearBuffer();
+                cout << RED << "[ERROR] Invalid page size!\n" << RESET;
+                continue;
+            }
+            listingPageSize = pageSize;
+            cout << GREEN << "[SUCCESS] Page size updated!\n" << RESET;
+        } else if (choice == 3) {
+            break;
+        } else {
+            cout << RED << "[ERROR] Invalid choice!\n" << RESET;
+        }
+    }
+}
+
+// ============================================
+// DATA PERSISTENCE MENU
+// ============================================
+
+// Appends the same record many times to a scratch journal, committing in
+// groups of the given size, and returns records per second
+double benchmarkJournalGroup(int records, int groupSize) {
+    string path = string(JOURNAL_FILE) + ".bench";
+    JournalWriter writer = {createJournalFile(path.c_str(), 0), "", 0, 0, 0, 0, 0};
+    if (writer.file == nullptr) return 0.0;
+
+    string payload;
+    putUint32(payload, roads[0].fromID);
+    putUint32(payload, roads[0].toID);
+    putText(payload, roads[0].status);
+    payload.push_back(roads[0].isAvailable ? 1 : 0);
+
+    chrono::steady_clock::time_point started = chrono::steady_clock::now();
+    for (int r = 1; r <= records; r++) {
+        journalAppendRecord(writer, JOURNAL_ROAD_STATE, payload);
+        if (r % groupSize == 0) journalFlushGroup(writer);
+    }
+    journalFlushGroup(writer);
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+
+    fclose(writer.file);
+    remove(path.c_str());
+    return records / max(elapsed, 1e-9);
+}
+
+void persistenceMenu() {
+    while (true) {
+        displaySection("DATA PERSISTENCE");
+        cout << CYAN << "Journal: " << RESET << JOURNAL_FILE << " (" << journal.fileBytes << " bytes, "
+             << journal.recordsSinceCheckpoint << " records since checkpoint " << checkpointSequence << ")"
+             << (journal.file == nullptr ? " [NOT OPEN]" : "") << "\n";
+        cout << CYAN << "Group commits this session: " << RESET << journal.commits << " ("
+             << journal.committedRecords << " records)\n";
+        cout << CYAN << "Last recovery: " << RESET
+             << (lastRecovery.checkpointLoaded ? "checkpoint + " : "preloaded data + ")
+             << lastRecovery.recordsReplayed << " journal records in " << formatFixed(lastRecovery.milliseconds, 2) << " ms"
+             << (lastRecovery.recordsSkipped > 0 ? ", " + to_string(lastRecovery.recordsSkipped) + " skipped" : string())
+             << (lastRecovery.tailTruncated ? " (damaged tail truncated)" : "")
+             << (lastRecovery.journalKept ? " (journal left untouched, saving is off)" : "") << "\n";
+        cout << "\n1. Write Checkpoint Now\n";
+        cout << "2. Benchmark Group Commit\n";
+        cout << "3. Back to Main Menu\n";
+        cout << "Enter choice: ";
+
+        int choice;
+        if (!(cin >> choice)) {
+            clearBuffer();
+            cout << RED << "[ERROR] Invalid input!\n" << RESET;
+            continue;
+        }
+
+        if (choice == 1) {
+            if (writeCheckpoint()) {
+                cout << GREEN << "[SUCCESS] Checkpoint " << checkpointSequence << " written, journal reset!\n" << RESET;
+            } else {
+                cout << RED << "[ERROR] Could not write the checkpoint!\n" << RESET;
+            }
+        } else if (choice == 2) {
+            if (roadCount == 0) {
+                cout << YELLOW << "[INFO] Add a road first.\n" << RESET;
+                continue;
+            }
+            const int records = 1024;
+            const int groups[] = {1, 16, 256};
+            cout << "\n| " << left << setw(12) << "Group size" << "| " << left << setw(16) << "Records/s"
+                 << "| " << left << setw(10) << "fsyncs" << "|\n";
+            for (int g = 0; g < 3; g++) {
+                double rate = benchmarkJournalGroup(records, groups[g]);
+                cout << "| " << left << setw(12) << groups[g] << "| " << left << setw(16) << formatFixed(rate, 0)
+                     << "| " << left << setw(10) << (records + groups[g] - 1) / groups[g] << "|\n";
+            }
+        } else if (choice == 3) {
+            break;
+        } else {
+            cout << RED << "[ERROR] Invalid choice!\n" << RESET;
+        }
+    }
+}
+
+// ============================================
+// TRACING MENU
+// ============================================
+
+void tracingMenu() {
+    while (true) {
+        displaySection("TRACING (CHROME TRACE)");
+        cout << CYAN << "Tracing: " << RESET << (tracingEnabled ? GREEN : YELLOW) << (tracingEnabled ? "ON" : "OFF") << RESET
+             << CYAN << "   Recorded spans: " << RESET << traceEventCount() << "\n";
+        cout << "1. " << (tracingEnabled ? "Stop" : "Start") << " Tracing\n";
+        cout << "2. Write Trace File\n";
+        cout << "3. Clear Recorded Spans\n";
+        cout << "4. Back to Main Menu\n";
+        cout << "Enter choice: ";
+
+        int choice;
+        if (!(cin >> choice)) {
+            clearBuffer();
+            cout << RED << "[ERROR] Invalid input!\n" << RESET;
+            continue;
+        }
+
+        if (choice == 1) {
+            if (tracingEnabled) stopTracing();
+            else startTracing();
+            cout << GREEN << "[SUCCESS] Tracing " << (tracingEnabled ? "started" : "stopped") << "!\n" << RESET;
+        } else if (choice == 2) {
+            cout << "Enter output path (e.g. navigation_trace.json): ";
+            string path;
+            cin >> path;
+            if (writeChromeTrace(path)) {
+                cout << GREEN << "[SUCCESS] Wrote " << traceEventCount() << " spans to " << path
+                     << " (open in chrome://tracing or ui.perfetto.dev)\n" << RESET;
+            } else {
+                cout << RED << "[ERROR] Could not write " << path << "!\n" << RESET;
+            }
+        } else if (choice == 3) {
+            clearTrace();
+            cout << GREEN << "[SUCCESS] Recorded spans cleared!\n" << RESET;
+        } else if (choice == 4) {
+            break;
+        } else {
+            cout << RED << "[ERROR] Invalid choice!\n" << RESET;
+        }
+    }
+}
+
 // ============================================
 // MAIN MENU
 // ============================================
@@ -1335,6 +8668,17 @@ void mainMenu() {
         cout << "8. Sort Locations by Name\n";
         cout << "9. ASCII Map View\n";
         cout << "10. System Statistics\n";
+        cout << "11. Service Area (Reachability)\n";
+        cout << "12. Display Settings\n";
+        cout << "13. Multi-Stop Trip Optimiser\n";
+        cout << "14. Sharded Routing (Partitions)\n";
+        cout << "15. Data Persistence (Journal)\n";
+        cout << "16. Vehicle Profile (currently " << vehicleProfileName(activeVehicleProfile) << ")\n";
+        cout << "17. Tracing (Chrome Trace)\n";
+        cout << "18. Hub Labels (Distance Oracle)\n";
+        cout << "19. Graph Layout (Cache Locality)\n";
+        cout << "20. Compressed Graph (" << (compressedGraphMode ? "on" : "off") << ")\n";
+        cout << "21. Road Criticality (Betweenness)\n";
         cout << "0. Exit\n";
         cout << "-------------------------------------------\n";
         cout << "Enter your choice: ";
@@ -1380,6 +8724,28 @@ void mainMenu() {
             displayASCIIMap();
         } else if (choice == 10) {
             displaySystemStatistics();
+        } else if (choice == 11) {
+            serviceAreaQuery();
+        } else if (choice == 12) {
+            displaySettingsMenu();
+        } else if (choice == 13) {
+            tripOptimiserMenu();
+        } else if (choice == 14) {
+            shardedRoutingMenu();
+        } else if (choice == 15) {
+            persistenceMenu();
+        } else if (choice == 16) {
+            vehicleProfileMenu();
+        } else if (choice == 17) {
+            tracingMenu();
+        } else if (choice == 18) {
+            hubLabelMenu();
+        } else if (choice == 19) {
+            graphLayoutMenu();
+        } else if (choice == 20) {
+            compressedGraphMenu();
+        } else if (choice == 21) {
+            roadCriticalityMenu();
         } else if (choice == 0) {
             cout << "\n";
             displayHeading("THANK YOU FOR USING SMART NAVIGATION!");
@@ -1396,29 +8762,32 @@ void mainMenu() {
 // ============================================
 
 void initializePreloadedData() {
-    locations[0] = {1, "DHA"};
-    locations[1] = {2, "Sadar Bazaar"};
-    locations[2] = {3, "Anarkali"};
-    locations[3] = {4, "Model Town"};
-    locations[4] = {5, "Gulberg"};
-    locations[5] = {6, "Defence Road"};
-    locations[6] = {7, "Canal Road"};
-    locations[7] = {8, "Mall Road"};
-    locations[8] = {9, "Johar Town"};
-    locations[9] = {10, "Bahria Town"};
+    locations[0] = {1, internName("DHA"), 31.4697, 74.4091};
+    locations[1] = {2, internName("Sadar Bazaar"), 31.5136, 74.3694};
+    locations[2] = {3, internName("Anarkali"), 31.5685, 74.3098};
+    locations[3] = {4, internName("Model Town"), 31.4834, 74.3257};
+    locations[4] = {5, internName("Gulberg"), 31.5204, 74.3487};
+    locations[5] = {6, internName("Defence Road"), 31.4400, 74.3720};
+    locations[6] = {7, internName("Canal Road"), 31.5100, 74.3300};
+    locations[7] = {8, internName("Mall Road"), 31.5580, 74.3290};
+    locations[8] = {9, internName("Johar Town"), 31.4697, 74.2728};
+    locations[9] = {10, internName("Bahria Town"), 31.3700, 74.1780};
     locationCount = 10;
-
-    vector<tuple<int, int, int, string, bool, bool>> initialRoads = {
-        {1, 2, 8, "Normal", false, true}, {2, 3, 6, "Normal", false, true},
-        {3, 4, 12, "Heavy Traffic", false, true}, {4, 5, 5, "Normal", false, true},
-        {5, 6, 9, "Normal", false, true}, {6, 7, 7, "Heavy Traffic", false, true},
-        {7, 8, 4, "Normal", false, true}, {8, 9, 10, "Blocked", false, true},
-        {9, 10, 14, "Normal", false, true}, {10, 1, 18, "Heavy Traffic", false, true},
-        {1, 3, 14, "Normal", false, true}, {2, 4, 15, "Normal", false, true},
-        {3, 5, 11, "Normal", false, true}, {4, 6, 8, "Heavy Traffic", false, true},
-        {5, 7, 13, "Normal", false, true}, {6, 8, 9, "Normal", false, true},
-        {7, 9, 12, "Normal", false, true}, {8, 10, 16, "Heavy Traffic", false, true},
-        {2, 6, 18, "Normal", false, true}, {9, 1, 20, "Normal", false, true}
+    markTopologyChanged();
+    rebuildSpatialIndex();
+
+    // from, to, distance, status, one-way, available, speed limit (km/h), toll ($)
+    vector<tuple<int, int, int, string, bool, bool, int, double>> initialRoads = {
+        {1, 2, 8, "Normal", false, true, 40, 0.0}, {2, 3, 6, "Normal", false, true, 25, 0.0},
+        {3, 4, 12, "Heavy Traffic", false, true, 30, 0.0}, {4, 5, 5, "Normal", false, true, 40, 0.0},
+        {5, 6, 9, "Normal", false, true, 50, 0.0}, {6, 7, 7, "Heavy Traffic", false, true, 60, 0.0},
+        {7, 8, 4, "Normal", false, true, 30, 0.0}, {8, 9, 10, "Blocked", false, true, 40, 0.0},
+        {9, 10, 14, "Normal", false, true, 80, 1.50}, {10, 1, 18, "Heavy Traffic", false, true, 80, 2.00},
+        {1, 3, 14, "Normal", false, true, 40, 0.0}, {2, 4, 15, "Normal", false, true, 40, 0.0},
+        {3, 5, 11, "Normal", false, true, 35, 0.0}, {4, 6, 8, "Heavy Traffic", false, true, 40, 0.0},
+        {5, 7, 13, "Normal", false, true, 70, 1.00}, {6, 8, 9, "Normal", false, true, 50, 0.0},
+        {7, 9, 12, "Normal", false, true, 70, 1.00}, {8, 10, 16, "Heavy Traffic", false, true, 60, 0.0},
+        {2, 6, 18, "Normal", false, true, 60, 0.0}, {9, 1, 20, "Normal", false, true, 80, 1.50}
     };
 
     for(const auto& road_data : initialRoads) {
@@ -1428,6 +8797,8 @@ void initializePreloadedData() {
         string status = get<3>(road_data);
         bool isOneWay = get<4>(road_data);
         bool isAvailable = get<5>(road_data);
+        int speedLimit = get<6>(road_data);
+        double toll = get<7>(road_data);
 
         if (roadCount < MAX_ROADS) {
             roads[roadCount].fromID = from;
@@ -1436,7 +8807,10 @@ void initializePreloadedData() {
             roads[roadCount].status = status;
             roads[roadCount].isOneWay = isOneWay;
             roads[roadCount].isAvailable = isAvailable;
+            roads[roadCount].speedLimit = speedLimit;
+            roads[roadCount].toll = toll;
             roadCount++;
+            markTopologyChanged();
         }
         // For preloaded data, only add the reverse direction if it's not one-way and if there's space.
         // The `roadExists` check is important here to avoid duplicates if the `initialRoads` list were to contain redundant bidirectional entries.
@@ -1447,19 +8821,295 @@ void initializePreloadedData() {
             roads[roadCount].status = status;
             roads[roadCount].isOneWay = false; // Explicitly false for the reverse road
             roads[roadCount].isAvailable = isAvailable;
+            roads[roadCount].speedLimit = speedLimit;
+            roads[roadCount].toll = toll;
             roadCount++;
+            markTopologyChanged();
+        }
+    }
+}
+
+const char* roadStatusName(int status) {
+    switch (status) {
+        case NAV_ROAD_NORMAL: return "Normal";
+        case NAV_ROAD_HEAVY_TRAFFIC: return "Heavy Traffic";
+        case NAV_ROAD_BLOCKED: return "Blocked";
+        default: return nullptr;
+    }
+}
+
+}  // namespace nav_engine
+
+using namespace nav_engine;
+
+// ============================================
+// LIBRARY API (see navigation_api.h)
+// ============================================
+
+// The console menus above are clients of these functions: they prompt and
+// print, and leave validation and every graph mutation to the API.
+
+void navOpen() {
+    snapshotPauseDepth++;
+    initializePreloadedData();
+    recoverFromJournal();
+    snapshotPauseDepth--;
+    publishGraphSnapshot(vector<int>());
+}
+
+NavStatus navAddLocation(int id, const char* name, double latitude, double longitude) {
+    if (name == nullptr || name[0] == '\0' || latitude < -90 || latitude > 90 || longitude < -180 || longitude > 180) {
+        return NAV_INVALID_ARGUMENT;
+    }
+    if (locationExists(id)) return NAV_DUPLICATE;
+    if (locationCount >= MAX_LOCATIONS) return NAV_CAPACITY_FULL;
+
+    locations[locationCount].id = id;
+    locations[locationCount].name = internName(name);
+    locations[locationCount].latitude = latitude;
+    locations[locationCount].longitude = longitude;
+    spatialInsert(locations[locationCount]);
+    locationCount++;
+    markLocationAppended();
+    journalLocationAdded(locations[locationCount - 1]);
+    return journalCommit() ? NAV_OK : NAV_STORAGE_ERROR;
+}
+
+NavStatus navRemoveLocation(int id) {
+    int foundIndex = findLocationIndexByID(id);
+    if (foundIndex == -1) return NAV_NOT_FOUND;
+
+    spatialRemove(locations[foundIndex]);
+
+    // Shift elements left to delete
+    for (int i = foundIndex; i < locationCount - 1; i++) {
+        locations[i] = locations[i + 1];
+    }
+    locationCount--;
+    markTopologyChanged();
+    journalLocationDeleted(id);
+    return journalCommit() ? NAV_OK : NAV_STORAGE_ERROR;
+}
+
+NavStatus navAddRoad(const NavRoadSpec& road, int* roadsAdded) {
+    if (roadsAdded != nullptr) *roadsAdded = 0;
+    const char* status = roadStatusName(road.status);
+    if (road.fromID == road.toID || road.distanceKm <= 0 || status == nullptr ||
+        road.speedLimit <= 0 || road.toll < 0) {
+        return NAV_INVALID_ARGUMENT;
+    }
+    if (!locationExists(road.fromID) || !locationExists(road.toID)) return NAV_NOT_FOUND;
+    if (roadExists(road.fromID, road.toID)) return NAV_DUPLICATE;
+    if (roadCount >= MAX_ROADS) return NAV_CAPACITY_FULL;
+
+    for (int direction = 0; direction < 2; direction++) {
+        int fromID = direction == 0 ? road.fromID : road.toID;
+        int toID = direction == 0 ? road.toID : road.fromID;
+        if (direction == 1 && (road.oneWay || roadCount >= MAX_ROADS || roadExists(fromID, toID))) break;
+
+        roads[roadCount].fromID = fromID;
+        roads[roadCount].toID = toID;
+        roads[roadCount].distance = road.distanceKm;
+        roads[roadCount].status = status;
+        roads[roadCount].isOneWay = road.oneWay;
+        roads[roadCount].isAvailable = road.available;
+        roads[roadCount].speedLimit = road.speedLimit;
+        roads[roadCount].toll = road.toll;
+        roadCount++;
+        markRoadAppended();
+        journalRoadAdded(roads[roadCount - 1]);
+        if (roadsAdded != nullptr) (*roadsAdded)++;
+    }
+    return journalCommit() ? NAV_OK : NAV_STORAGE_ERROR;
+}
+
+NavStatus navRemoveRoad(int fromID, int toID) {
+    int foundIndex = findRoadIndex(fromID, toID);
+    if (foundIndex == -1) return NAV_NOT_FOUND;
+
+    bool wasOneWay = roads[foundIndex].isOneWay;
+
+    // Shift elements left to delete
+    for (int i = foundIndex; i < roadCount - 1; i++) {
+        roads[i] = roads[i + 1];
+    }
+    roadCount--;
+    journalRoadDeleted(fromID, toID);
+
+    // If bidirectional, also delete reverse direction
+    if (!wasOneWay) {
+        for (int i = 0; i < roadCount; i++) {
+            if (roads[i].fromID == toID && roads[i].toID == fromID) {
+                for (int j = i; j < roadCount - 1; j++) {
+                    roads[j] = roads[j + 1];
+                }
+                roadCount--;
+                journalRoadDeleted(toID, fromID);
+                break;
+            }
+        }
+    }
+    markTopologyChanged();
+    return journalCommit() ? NAV_OK : NAV_STORAGE_ERROR;
+}
+
+NavStatus navSetRoadDistance(int fromID, int toID, int distanceKm) {
+    if (distanceKm <= 0) return NAV_INVALID_ARGUMENT;
+    int roadIndex = findRoadIndex(fromID, toID);
+    if (roadIndex == -1) return NAV_NOT_FOUND;
+
+    roads[roadIndex].distance = distanceKm;
+    journalRoadDistance(roads[roadIndex]);
+
+    vector<int> changedLocations(1, findLocationIndexByID(fromID));
+    if (!roads[roadIndex].isOneWay) {
+        int reverseIndex = findRoadIndex(toID, fromID);
+        if (reverseIndex != -1) {
+            roads[reverseIndex].distance = distanceKm;
+            journalRoadDistance(roads[reverseIndex]);
+            changedLocations.push_back(findLocationIndexByID(toID));
+        }
+    }
+    markWeightsChanged(changedLocations);
+    return journalCommit() ? NAV_OK : NAV_STORAGE_ERROR;
+}
+
+NavStatus navApplyRoadUpdates(const NavRoadUpdate* updates, int count, int* applied) {
+    if (applied != nullptr) *applied = 0;
+    if (count < 0 || (count > 0 && updates == nullptr)) return NAV_INVALID_ARGUMENT;
+
+    vector<RoadUpdate> batch(count);
+    for (int u = 0; u < count; u++) {
+        const char* status = roadStatusName(updates[u].status);
+        if (updates[u].availability < -1 || updates[u].availability > 1) return NAV_INVALID_ARGUMENT;
+        if (updates[u].status != NAV_ROAD_KEEP && status == nullptr) return NAV_INVALID_ARGUMENT;
+        batch[u].fromID = updates[u].fromID;
+        batch[u].toID = updates[u].toID;
+        batch[u].status = updates[u].status == NAV_ROAD_KEEP ? "" : status;
+        batch[u].availability = updates[u].availability;
+    }
+    RoadUpdateReport report = applyRoadUpdates(batch);
+    if (applied != nullptr) *applied = report.applied;
+    return report.saved ? NAV_OK : NAV_STORAGE_ERROR;
+}
+
+int navLocationCount() {
+    return locationCount;
+}
+
+int navRoadCount() {
+    return roadCount;
+}
+
+NavStatus navSetVehicleProfile(int profile) {
+    if (profile < 0 || profile >= VEHICLE_PROFILE_COUNT) return NAV_INVALID_ARGUMENT;
+    if (profile != activeVehicleProfile) {
+        activeVehicleProfile = profile;
+        markWeightsChanged();
+    }
+    return NAV_OK;
+}
+
+bool navReachable(int fromID, int toID) {
+    int fromIndex = findLocationIndexByID(fromID), toIndex = findLocationIndexByID(toID);
+    return fromIndex != -1 && toIndex != -1 && locationReachable(fromIndex, toIndex);
+}
+
+// Small networks are answered from the all-pairs table, larger ones (and
+// every query in compressed graph mode) by a single Dijkstra search
+NavStatus navShortestPath(int fromID, int toID, int* pathIDs, int capacity, NavRouteSummary* summary) {
+    int fromIndex = findLocationIndexByID(fromID), toIndex = findLocationIndexByID(toID);
+    if (fromIndex == -1 || toIndex == -1) return NAV_NOT_FOUND;
+    if (capacity < 0 || (capacity > 0 && pathIDs == nullptr)) return NAV_INVALID_ARGUMENT;
+    if (!locationReachable(fromIndex, toIndex)) return NAV_NO_PATH;
+
+    vector<int> path;
+    int distance = shortestPathLookup(fromIndex, toIndex, path);
+    if (distance == INF_DISTANCE) return NAV_NO_PATH;
+
+    if (summary != nullptr) {
+        TripEstimate estimate = estimateTrip(distance);
+        summary->weightedDistance = distance;
+        summary->pathLength = (int)path.size();
+        summary->hours = estimate.hours;
+        summary->fuelLitres = estimate.fuel;
+        summary->fuelCost = estimate.fuelCost;
+    }
+    if ((int)path.size() > capacity) return NAV_BUFFER_TOO_SMALL;
+    for (size_t i = 0; i < path.size(); i++) pathIDs[i] = locations[path[i]].id;
+    return NAV_OK;
+}
+
+NavStatus navDistanceMatrix(const int* ids, int count, int* matrix) {
+    if (count < 0 || (count > 0 && (ids == nullptr || matrix == nullptr))) return NAV_INVALID_ARGUMENT;
+    vector<int> indices(count);
+    for (int i = 0; i < count; i++) {
+        indices[i] = findLocationIndexByID(ids[i]);
+        if (indices[i] == -1) return NAV_NOT_FOUND;
+    }
+
+    bool fromTable = !compressedGraphMode && locationCount <= APSP_MAX_LOCATIONS;
+    shared_ptr<const GraphSnapshot> snapshot = acquireGraphSnapshot();
+    vector<int> dist, parent;
+    for (int i = 0; i < count; i++) {
+        if (!fromTable) snapshotDijkstra(*snapshot, indices[i], dist, parent);
+        for (int j = 0; j < count; j++) {
+            int d = fromTable ? allPairsDistance(indices[i], indices[j]) : dist[indices[j]];
+            matrix[i * count + j] = (d == INF_DISTANCE) ? -1 : d;
         }
     }
+    return NAV_OK;
+}
+
+// Reads only the published snapshot, so it is safe from any thread
+int navRouteDistance(int fromID, int toID) {
+    shared_ptr<const GraphSnapshot> snapshot = acquireGraphSnapshot();
+    if (!snapshot) return -1;
+    int fromIndex = snapshotLocationIndex(*snapshot, fromID), toIndex = snapshotLocationIndex(*snapshot, toID);
+    if (fromIndex == -1 || toIndex == -1) return -1;
+    vector<int> dist;
+    snapshotDijkstra(*snapshot, fromIndex, dist);
+    return dist[toIndex] == INF_DISTANCE ? -1 : dist[toIndex];
+}
+
+int navDistance(int fromID, int toID) {
+    int fromIndex = findLocationIndexByID(fromID), toIndex = findLocationIndexByID(toID);
+    if (fromIndex == -1 || toIndex == -1) return -1;
+    int distance = hubLabelDistance(fromIndex, toIndex);
+    return distance == INF_DISTANCE ? -1 : distance;
+}
+
+int navNearestLocations(double latitude, double longitude, int k, int* ids, double* distancesKm) {
+    if (k <= 0 || ids == nullptr) return 0;
+    vector<pair<double, int>> nearest = spatialNearest(latitude, longitude, k);
+    for (size_t i = 0; i < nearest.size(); i++) {
+        ids[i] = nearest[i].second;
+        if (distancesKm != nullptr) distancesKm[i] = nearest[i].first;
+    }
+    return (int)nearest.size();
 }
 
 // ============================================
 // MAIN FUNCTION
 // ============================================
 
+#ifndef NAV_LIBRARY_ONLY
 int main() {
-    initializePreloadedData();
+    ios_base::sync_with_stdio(false);
+    detectColorSupport();
+
+    // NAV_TRACE=<file> traces the whole session, startup included
+    const char* tracePath = getenv("NAV_TRACE");
+    if (tracePath != nullptr && tracePath[0] != '\0') startTracing();
+    navOpen();
+    printRecoveryWarnings();
 
     mainMenu();
+    if (tracePath != nullptr && tracePath[0] != '\0') {
+        stopTracing();
+        writeChromeTrace(tracePath);
+    }
     return 0;
 }
+#endif
 
@@ -0,0 +1,109 @@
+#ifndef NAVIGATION_API_H
+#define NAVIGATION_API_H
+
+// ============================================
+// SMART NAVIGATION SYSTEM - LIBRARY API
+// ============================================
+
+// In-process interface to the navigation engine: the graph store, route
+// searches and cost estimation, without the console menus. To embed it,
+// compile "Smart Navigation System main.cpp" with -DNAV_LIBRARY_ONLY (this
+// leaves out main()) and link it with your program.
+//
+// Results are written into buffers owned by the caller and no function here
+// reads from or writes to the console. The engine keeps one graph and
+// rebuilds its indexes lazily, so calls must come from a single thread (or
+// be serialised by the caller), with one exception: navRouteDistance()
+// reads an immutable snapshot of the road graph and may be called from any
+// number of threads while that thread edits. Edits are journaled exactly as
+// console edits are; call navOpen() once at startup, before any other call,
+// to recover the saved state.
+
+enum NavStatus {
+    NAV_OK = 0,
+    NAV_NOT_FOUND,          // unknown location or road
+    NAV_INVALID_ARGUMENT,
+    NAV_DUPLICATE,          // location ID or road already exists
+    NAV_CAPACITY_FULL,      // location or road table is full
+    NAV_NO_PATH,
+    NAV_BUFFER_TOO_SMALL,   // the required size is reported back
+    NAV_STORAGE_ERROR       // the edit was applied but could not be saved
+};
+
+enum NavRoadStatus {
+    NAV_ROAD_NORMAL = 0,
+    NAV_ROAD_HEAVY_TRAFFIC,
+    NAV_ROAD_BLOCKED,
+    NAV_ROAD_KEEP = -1      // in updates: leave the current status
+};
+
+enum NavVehicleProfile {
+    NAV_VEHICLE_CAR = 0,
+    NAV_VEHICLE_MOTORBIKE,
+    NAV_VEHICLE_TRUCK,
+    NAV_VEHICLE_BUS
+};
+
+struct NavRoadSpec {
+    int fromID;
+    int toID;
+    int distanceKm;
+    int status;             // NavRoadStatus
+    bool oneWay;            // false also adds the reverse direction
+    bool available;
+    int speedLimit;         // km/h
+    double toll;            // $
+};
+
+struct NavRoadUpdate {
+    int fromID;
+    int toID;
+    int status;             // NavRoadStatus, NAV_ROAD_KEEP to leave as is
+    int availability;       // 1 = available, 0 = unavailable, -1 = keep
+};
+
+struct NavRouteSummary {
+    int weightedDistance;   // km including traffic delays
+    int pathLength;         // locations on the path, start and end included
+    double hours;           // at the vehicle profile's cruise speed
+    double fuelLitres;
+    double fuelCost;        // $
+};
+
+// Loads the preloaded network and replays the journal. Call once.
+void navOpen();
+
+// Graph store
+NavStatus navAddLocation(int id, const char* name, double latitude, double longitude);
+NavStatus navRemoveLocation(int id);
+NavStatus navAddRoad(const NavRoadSpec& road, int* roadsAdded);     // roadsAdded may be null
+NavStatus navRemoveRoad(int fromID, int toID);                      // both directions if bidirectional
+NavStatus navSetRoadDistance(int fromID, int toID, int distanceKm); // both directions if bidirectional
+// Applies the batch in order; a status that is neither a NavRoadStatus nor
+// NAV_ROAD_KEEP, or an availability other than -1, 0 or 1, rejects the whole
+// batch with NAV_INVALID_ARGUMENT before anything changes
+NavStatus navApplyRoadUpdates(const NavRoadUpdate* updates, int count, int* applied);
+int navLocationCount();
+int navRoadCount();
+
+// Routing and costs
+NavStatus navSetVehicleProfile(int profile);
+bool navReachable(int fromID, int toID);
+NavStatus navShortestPath(int fromID, int toID, int* pathIDs, int capacity, NavRouteSummary* summary);
+
+// Weighted distance only, from the hub-label index; -1 if unknown or
+// unreachable. The cheapest call for high-volume lookups.
+int navDistance(int fromID, int toID);
+
+// As navDistance(), by a search over the current graph snapshot. Safe to
+// call from any thread, concurrently with edits on the main thread.
+int navRouteDistance(int fromID, int toID);
+
+// Weighted distances between every pair of the given locations, written
+// row-major to matrix (count * count entries, -1 where unreachable)
+NavStatus navDistanceMatrix(const int* ids, int count, int* matrix);
+
+// Up to k locations closest to a point; returns how many were written
+int navNearestLocations(double latitude, double longitude, int k, int* ids, double* distancesKm);
+
+#endif